@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \author
+ *         Jonas Baechli   jonas.baechli@bluewin.ch
+ *         Reto Da Forno   rdaforno@ee.ethz.ch
+ *         Romain Jacob    jacobr@ethz.ch
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \addtogroup gmw-platform
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *
+ *            Platform dependent implementation for GMW
+ *            Platform: native (virtual radio, see native-medium.h)
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "debug-print.h"
+#include "gmw.h"
+#include "native-medium.h"
+/*---------------------------------------------------------------------------*/
+static gmw_rf_tx_power_t tx_power = GMW_CONF_RF_TX_POWER;
+/*---------------------------------------------------------------------------*/
+void
+gmw_platform_init(void)
+{
+  rtimer_ext_init();
+}
+/*---------------------------------------------------------------------------*/
+void
+gmw_set_maximum_packet_length(uint8_t length)
+{
+  /* not required, the virtual radio accepts any length */
+}
+/*---------------------------------------------------------------------------*/
+void
+gmw_set_rf_channel(gmw_rf_tx_channel_t channel)
+{
+  if(channel > 26 || channel < 11) {
+    DEBUG_PRINT_MSG_NOW("Wrong channel setting (%u)", channel);
+    DEBUG_PRINT_MSG_NOW("Select RF channel between 10 and 26! Set to 26.");
+    channel = 26;
+  }
+  native_medium_set_rf_channel(channel);
+}
+/*---------------------------------------------------------------------------*/
+void
+gmw_set_tx_power(gmw_rf_tx_power_t power)
+{
+  tx_power = power;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+gmw_high_noise_detected(void)
+{
+#if GMW_CONF_USE_NOISE_DETECTION
+  return gmw_high_noise_test();
+#else
+  return 0;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+gmw_communication_active(void)
+{
+#if GMW_CONF_USE_MULTI_PRIMITIVES && GMW_PRIM2_ENABLE
+  return (glossy_get_state() || strobing_is_active());
+#else  /* GMW_CONF_USE_MULTI_PRIMITIVES */
+  return (glossy_get_state());
+#endif /* GMW_CONF_USE_MULTI_PRIMITIVES */
+}
+/*---------------------------------------------------------------------------*/
+int8_t
+gmw_get_rssi_last(void)
+{
+  /* constant value, the virtual medium does not model the signal strength */
+  return -60;
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
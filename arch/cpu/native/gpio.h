@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * @brief GPIO access macros for the native platform
+ *
+ * There are no pins on the host: all macros expand to nothing such that
+ * the tracing hooks in GMW, Glossy and the applications compile unchanged.
+ */
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+#define PIN0    0
+#define PIN1    1
+#define PIN2    2
+#define PIN3    3
+#define PIN4    4
+#define PIN5    5
+#define PIN6    6
+#define PIN7    7
+
+#define PORT1   1
+#define PORT2   2
+#define PORT3   3
+#define PORT4   4
+#define PORT5   5
+#define PORT6   6
+
+#define LED_ON(...)
+#define LED_OFF(...)
+#define LED_TOGGLE(...)
+
+#define PIN_XOR(...)
+#define PIN_SET(...)
+#define PIN_CLR(...)
+#define PIN_SEL(...)
+#define PIN_UNSEL(...)
+#define PIN_CFG_OUT(...)
+#define PIN_CFG_IN(...)
+#define PIN_MAP_AS_OUTPUT(...)
+#define PIN_MAP_AS_INPUT(...)
+#define PIN_CLR_IFG(...)
+#define PIN_PULLUP_EN(...)
+#define PIN_PULLDOWN_EN(...)
+#define PIN_IES_RISING(...)
+#define PIN_IES_FALLING(...)
+#define PIN_IES_TOGGLE(...)
+#define PIN_INT_EN(...)
+#define PIN_INT_DIS(...)
+#define PIN_CFG_INT(...)
+#define PIN_CFG_INT_INV(...)
+#define PIN_IFG(...)                    0
+#define PIN_GET(...)                    0
+
+#endif /* GPIO_H_ */
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *
+ * Virtual rtimer-ext for the native platform.
+ *
+ * The virtual clock runs in HF ticks. The LF clock is derived from it
+ * (RTIMER_EXT_HF_LF_RATIO must be an integer). rtimer_ext_reset() only
+ * affects the timestamps returned by rtimer_ext_now_*(), the Contiki clock
+ * (etimer) is based on the absolute virtual time and never jumps back.
+ *
+ * This file also implements the Contiki clock and rtimer (rtimer_arch_*)
+ * interfaces, like rtimer-ext.c on the cc430.
+ */
+/*---------------------------------------------------------------------------*/
+#include <string.h>
+#include <time.h>
+#include "contiki.h"
+#include "rtimer-ext.h"
+/*---------------------------------------------------------------------------*/
+#if (RTIMER_EXT_CONF_HF_CLKSPEED % RTIMER_EXT_CONF_LF_CLKSPEED) != 0
+#error "HF clock speed must be a multiple of the LF clock speed"
+#endif
+
+#define ETIMER_INTERVAL_HF  (RTIMER_EXT_SECOND_HF / CLOCK_SECOND)
+#define IS_LF_TIMER(t)      ((t) >= RTIMER_EXT_LF_0)
+/*---------------------------------------------------------------------------*/
+static rtimer_ext_t rt[NUM_OF_RTIMER_EXTS]; /* rtimer_ext structs */
+static rtimer_ext_clock_t virt_time;        /* absolute virtual time */
+static rtimer_ext_clock_t reset_ofs;        /* virtual time of the last reset */
+static int32_t drift_ppb;                   /* rate error of the local clock */
+static uint64_t host_mark;                  /* host CPU time in ns */
+static uint8_t cpu_time_enabled = RTIMER_EXT_CONF_NATIVE_CPU_TIME;
+static rtimer_ext_native_stats_t stats;
+/*---------------------------------------------------------------------------*/
+static inline uint64_t
+host_cpu_time_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* fold the host CPU time consumed since the last call into the virtual
+ * clock; only whole HF ticks are consumed, the remainder is carried over */
+static inline void
+sync_host_time(void)
+{
+  if(cpu_time_enabled) {
+    uint64_t now = host_cpu_time_ns();
+    rtimer_ext_clock_t ticks = NS_TO_RTIMER_EXT_HF(now - host_mark);
+    if(ticks) {
+      virt_time      += ticks;
+      stats.cpu_time += ticks;
+      host_mark      += ticks * 1000000000ULL / RTIMER_EXT_SECOND_HF;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* deviation of the local clock from the virtual time v, in HF ticks */
+static inline int64_t
+skew(rtimer_ext_clock_t v)
+{
+  return (int64_t)v * drift_ppb / 1000000000LL;
+}
+/*---------------------------------------------------------------------------*/
+/* local HF time (since the last reset) at the absolute virtual time v */
+static inline rtimer_ext_clock_t
+local_time(rtimer_ext_clock_t v)
+{
+  return v - reset_ofs + skew(v) - skew(reset_ofs);
+}
+/*---------------------------------------------------------------------------*/
+/* absolute virtual time at which the local HF time reaches t */
+static rtimer_ext_clock_t
+virtual_time(rtimer_ext_clock_t t)
+{
+  rtimer_ext_clock_t v;
+  if(!drift_ppb) {
+    return t + reset_ofs;
+  }
+  /* approximation, then find the first tick with local_time(v) >= t */
+  v = reset_ofs + (rtimer_ext_clock_t)((double)t / (1.0 + drift_ppb * 1e-9));
+  while(local_time(v) < t) {
+    v++;
+  }
+  while(v > reset_ofs && local_time(v - 1) >= t) {
+    v--;
+  }
+  return v;
+}
+/*---------------------------------------------------------------------------*/
+/* expiration time of a timer in absolute virtual HF ticks */
+static inline rtimer_ext_clock_t
+expiration_time(uint16_t timer)
+{
+  if(IS_LF_TIMER(timer)) {
+    return virtual_time(rt[timer].time * RTIMER_EXT_HF_LF_RATIO);
+  }
+  return virtual_time(rt[timer].time);
+}
+/*---------------------------------------------------------------------------*/
+static inline void
+update_rtimer_ext_state(uint16_t timer)
+{
+  /* update the state only if the rtimer_ext has not been manually */
+  /* stopped or re-scheduled by the callback function */
+  if(rt[timer].state == RTIMER_EXT_JUST_EXPIRED) {
+    if(rt[timer].period > 0) {
+      /* if it is periodic, schedule the new expiration */
+      rt[timer].time += rt[timer].period;
+      rt[timer].state = RTIMER_EXT_SCHEDULED;
+    } else {
+      rt[timer].state = RTIMER_EXT_INACTIVE;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* functions from clock.c                                                    */
+/*---------------------------------------------------------------------------*/
+void
+clock_init(void)
+{
+  /* make sure the timer is configured and running */
+  rtimer_ext_init();
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+clock_time(void)
+{
+  sync_host_time();
+  return (clock_time_t)(virt_time / ETIMER_INTERVAL_HF);
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+clock_seconds(void)
+{
+  sync_host_time();
+  return (unsigned long)(virt_time / RTIMER_EXT_SECOND_HF);
+}
+/*---------------------------------------------------------------------------*/
+void
+clock_wait(clock_time_t t)
+{
+  /* busy wait: just let the virtual time pass */
+  virt_time += (rtimer_ext_clock_t)t * ETIMER_INTERVAL_HF;
+}
+/*---------------------------------------------------------------------------*/
+void
+clock_delay_usec(uint16_t dt)
+{
+  virt_time += NS_TO_RTIMER_EXT_HF((uint32_t)dt * 1000);
+}
+/*---------------------------------------------------------------------------*/
+void
+clock_delay(unsigned int i)
+{
+  /* a multiple of 2.83 us as on the msp430 */
+  virt_time += NS_TO_RTIMER_EXT_HF((uint64_t)i * 2830);
+}
+/*---------------------------------------------------------------------------*/
+/* Contiki rtimer, based on RTIMER_ARCH_TIMER_ID                             */
+/*---------------------------------------------------------------------------*/
+static char
+rtimer_arch_cb(rtimer_ext_t *t)
+{
+  rtimer_run_next();
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_init(void)
+{
+  rtimer_ext_stop(RTIMER_ARCH_TIMER_ID);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_schedule(rtimer_clock_t t)
+{
+  /* extend the 16-bit value to the closest 64-bit timestamp */
+  rtimer_ext_clock_t now = rtimer_ext_now_lf();
+  int16_t diff = (int16_t)(t - (uint16_t)now);
+  rtimer_ext_stop(RTIMER_ARCH_TIMER_ID);
+  rtimer_ext_schedule(RTIMER_ARCH_TIMER_ID,
+                      (diff > 0) ? (now + diff) : now, 0, rtimer_arch_cb);
+}
+/*---------------------------------------------------------------------------*/
+/* rtimer-ext                                                                */
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_init(void)
+{
+  memset(rt, 0, sizeof(rt));
+  host_mark = host_cpu_time_ns();
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_schedule(rtimer_ext_id_t timer, rtimer_ext_clock_t start,
+                    rtimer_ext_clock_t period, rtimer_ext_callback_t func)
+{
+  if((timer < NUM_OF_RTIMER_EXTS)
+      && (rt[timer].state != RTIMER_EXT_SCHEDULED)) {
+    rt[timer].func = func;
+    rt[timer].period = period;
+    rt[timer].time = start + period;
+    rt[timer].state = RTIMER_EXT_SCHEDULED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_wait_for_event(rtimer_ext_id_t timer, rtimer_ext_callback_t func)
+{
+  /* there are no capture inputs on the host, the callback never fires */
+  if((timer < NUM_OF_RTIMER_EXTS)
+      && (rt[timer].state != RTIMER_EXT_SCHEDULED)) {
+    rt[timer].func = func;
+    rt[timer].state = RTIMER_EXT_WFE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_stop(rtimer_ext_id_t timer)
+{
+  if(timer < NUM_OF_RTIMER_EXTS) {
+    rt[timer].state = RTIMER_EXT_INACTIVE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_reset(void)
+{
+  sync_host_time();
+  reset_ofs = virt_time;
+}
+/*---------------------------------------------------------------------------*/
+rtimer_ext_clock_t
+rtimer_ext_now_hf(void)
+{
+  sync_host_time();
+  return local_time(virt_time);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+rtimer_ext_now_lf_hw(void)
+{
+  return (uint16_t)rtimer_ext_now_lf();
+}
+/*---------------------------------------------------------------------------*/
+rtimer_ext_clock_t
+rtimer_ext_now_lf(void)
+{
+  return rtimer_ext_now_hf() / RTIMER_EXT_HF_LF_RATIO;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_now(rtimer_ext_clock_t* const hf_val,
+               rtimer_ext_clock_t* const lf_val)
+{
+  if(hf_val && lf_val) {
+    *hf_val = rtimer_ext_now_hf();
+    *lf_val = *hf_val / RTIMER_EXT_HF_LF_RATIO;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+rtimer_ext_next_expiration(rtimer_ext_id_t timer, rtimer_ext_clock_t* exp_time)
+{
+  if(timer < NUM_OF_RTIMER_EXTS) {
+    *exp_time = rt[timer].time;
+    return (rt[timer].state == RTIMER_EXT_SCHEDULED);
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* native platform only                                                      */
+/*---------------------------------------------------------------------------*/
+uint8_t
+rtimer_ext_native_next_expiration(rtimer_ext_clock_t* t)
+{
+  uint8_t found = 0;
+  uint16_t i;
+  rtimer_ext_clock_t next = 0;
+
+  for(i = 0; i < NUM_OF_RTIMER_EXTS; i++) {
+    if(rt[i].state == RTIMER_EXT_SCHEDULED &&
+       (!found || expiration_time(i) < next)) {
+      next  = expiration_time(i);
+      found = 1;
+    }
+  }
+  if(etimer_pending()) {
+    rtimer_ext_clock_t t_etimer =
+      (rtimer_ext_clock_t)etimer_next_expiration_time() * ETIMER_INTERVAL_HF;
+    if(!found || t_etimer < next) {
+      next  = t_etimer;
+      found = 1;
+    }
+  }
+  *t = next;
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_native_run(rtimer_ext_clock_t t)
+{
+  uint16_t i;
+
+  sync_host_time();
+  if(virt_time < t) {
+    virt_time = t;
+  }
+  while(1) {
+    /* find the timer that has expired first */
+    int16_t next = -1;
+    for(i = 0; i < NUM_OF_RTIMER_EXTS; i++) {
+      if(rt[i].state == RTIMER_EXT_SCHEDULED &&
+         expiration_time(i) <= virt_time &&
+         (next < 0 || expiration_time(i) < expiration_time(next))) {
+        next = i;
+      }
+    }
+    if(next < 0) {
+      break;
+    }
+    rtimer_ext_clock_t latency = virt_time - expiration_time(next);
+    stats.dispatch_cnt++;
+    if(latency) {
+      stats.late_cnt++;
+      stats.latency_sum += latency;
+      if(latency > stats.latency_max) {
+        stats.latency_max = latency;
+      }
+    }
+    /* the timer has expired! */
+    rt[next].state = RTIMER_EXT_JUST_EXPIRED;
+    /* execute the proper callback function */
+    rt[next].func(&rt[next]);
+    /* update or stop the timer */
+    update_rtimer_ext_state(next);
+    sync_host_time();
+  }
+  if(etimer_pending() &&
+     etimer_next_expiration_time() <= virt_time / ETIMER_INTERVAL_HF) {
+    etimer_request_poll();
+  }
+}
+/*---------------------------------------------------------------------------*/
+rtimer_ext_clock_t
+rtimer_ext_native_time(void)
+{
+  sync_host_time();
+  return virt_time;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_native_set_cpu_time(uint8_t enable)
+{
+  sync_host_time();
+  cpu_time_enabled = enable;
+  host_mark = host_cpu_time_ns();
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_ext_native_set_drift(int32_t ppb)
+{
+  drift_ppb = ppb;
+}
+/*---------------------------------------------------------------------------*/
+const rtimer_ext_native_stats_t*
+rtimer_ext_native_get_stats(void)
+{
+  return &stats;
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * rtimer-ext for the native platform.
+ *
+ * Same interface as the msp430 / cc430 implementation, but the timers are
+ * driven by a virtual clock: whenever the system is idle, the platform main
+ * loop advances the clock to the next expiration and executes the due
+ * callbacks (see rtimer_ext_native_next_expiration() and
+ * rtimer_ext_native_run()).
+ * Optionally, the host CPU time spent between two timer dispatches is added
+ * to the virtual clock such that processing times measured by the protocols
+ * (e.g. GMW's t_proc_max) reflect the real computational overhead.
+ */
+
+#ifndef RTIMER_EXT_H_
+#define RTIMER_EXT_H_
+
+#include <stdint.h>
+
+typedef uint64_t rtimer_ext_clock_t;
+
+/* override these default values in platform-conf.h or PROJECT_CONF_PATH */
+
+#ifndef RTIMER_EXT_CONF_NUM_HF       /* number of (usable) high-frequency timers */
+#define RTIMER_EXT_CONF_NUM_HF          1
+#endif /* RTIMER_EXT_CONF_NUM_HF */
+
+#ifndef RTIMER_EXT_CONF_NUM_LF        /* number of (usable) low-frequency timers */
+#define RTIMER_EXT_CONF_NUM_LF          2
+#endif /* RTIMER_EXT_CONF_NUM_LF */
+
+#ifndef RTIMER_EXT_CONF_HF_CLKSPEED
+#define RTIMER_EXT_CONF_HF_CLKSPEED     F_CPU
+#endif /* RTIMER_EXT_CONF_HF_CLKSRC */
+
+#ifndef RTIMER_EXT_CONF_LF_CLKSPEED
+#define RTIMER_EXT_CONF_LF_CLKSPEED     32768UL
+#endif /* RTIMER_EXT_CONF_HF_CLKSRC */
+
+/* the HF timer is always available on the native platform */
+#ifndef RTIMER_EXT_CONF_HF_ENABLE
+#define RTIMER_EXT_CONF_HF_ENABLE       1
+#endif /* RTIMER_EXT_CONF_HF_ENABLE */
+
+/* add the consumed host CPU time to the virtual clock? (can be changed at
+ * runtime with rtimer_ext_native_set_cpu_time()) */
+#ifndef RTIMER_EXT_CONF_NATIVE_CPU_TIME
+#define RTIMER_EXT_CONF_NATIVE_CPU_TIME 1
+#endif /* RTIMER_EXT_CONF_NATIVE_CPU_TIME */
+
+/**
+ * @brief the number of timer ticks that (approx.) correspond to 1s
+ */
+#define RTIMER_EXT_SECOND_HF            ((rtimer_ext_clock_t)RTIMER_EXT_CONF_HF_CLKSPEED)
+#define RTIMER_EXT_SECOND_LF            (RTIMER_EXT_CONF_LF_CLKSPEED)
+#define RTIMER_EXT_HF_LF_RATIO          (RTIMER_EXT_SECOND_HF / RTIMER_EXT_SECOND_LF)
+
+/**
+ * @brief convert rtimer_ext values from clock ticks to milliseconds and
+ * nanoseconds to rtimer_ext ticks
+ */
+#define RTIMER_EXT_HF_TO_MS(t)          ((t) / (RTIMER_EXT_SECOND_HF / 1000))
+#define RTIMER_EXT_LF_TO_MS(t)          ((t * 1000) / (RTIMER_EXT_SECOND_LF))
+#define NS_TO_RTIMER_EXT_HF_32(ns)      ((uint32_t)(ns) / \
+                                     (1000000000 / RTIMER_EXT_SECOND_HF))
+#define NS_TO_RTIMER_EXT_HF(ns)         (((rtimer_ext_clock_t)(ns) * \
+                                      (rtimer_ext_clock_t)RTIMER_EXT_SECOND_HF) / \
+                                     (rtimer_ext_clock_t)1000000000)
+
+/**
+ * @brief the rtimer_ext IDs
+ */
+typedef enum {
+  RTIMER_EXT_HF_0 = 0,
+#if RTIMER_EXT_CONF_NUM_HF > 1
+  RTIMER_EXT_HF_1,
+#endif
+#if RTIMER_EXT_CONF_NUM_HF > 2
+  RTIMER_EXT_HF_2,
+#endif
+#if RTIMER_EXT_CONF_NUM_HF > 3
+  RTIMER_EXT_HF_3,
+#endif
+  RTIMER_EXT_LF_0,
+#if RTIMER_EXT_CONF_NUM_LF > 1
+  RTIMER_EXT_LF_1,
+#endif
+#if RTIMER_EXT_CONF_NUM_LF > 2
+  RTIMER_EXT_LF_2,
+#endif
+#if RTIMER_EXT_CONF_NUM_LF > 3
+  RTIMER_EXT_LF_3,
+#endif
+  NUM_OF_RTIMER_EXTS
+} rtimer_ext_id_t;
+
+/* this is necessary for the rtimer_ext_callback_t prototype declaration */
+struct rtimer_ext;
+
+/* prototype of a rtimer_ext callback function */
+typedef char (*rtimer_ext_callback_t)(struct rtimer_ext *rt);
+
+typedef enum {
+  RTIMER_EXT_INACTIVE = 0,
+  RTIMER_EXT_SCHEDULED = 1,
+  RTIMER_EXT_JUST_EXPIRED = 2,
+  RTIMER_EXT_WFE = 3,      /* wait for event */
+} rtimer_ext_state_t;
+
+/**
+ * @brief state and parameters of an rtimer_ext
+ */
+typedef struct rtimer_ext {
+  rtimer_ext_clock_t time;    /* if state = RTIMER_EXT_SCHEDULED: next expiration time;
+                             otherwise: last expiration time */
+  rtimer_ext_clock_t period;  /* if period = 0: one-shot timer; otherwise: timer
+                             period in clock ticks */
+  rtimer_ext_callback_t func; /* callback function to execute when the rtimer_ext
+                             expires */
+  rtimer_ext_state_t state;   /* internal state of the rtimer_ext */
+} rtimer_ext_t;
+
+/**
+ * @brief timer dispatch statistics of the native platform
+ */
+typedef struct {
+  uint32_t           dispatch_cnt;      /* number of executed callbacks */
+  uint32_t           late_cnt;          /* callbacks executed after their
+                                           expiration time */
+  rtimer_ext_clock_t latency_max;       /* max. dispatch latency (HF ticks) */
+  rtimer_ext_clock_t latency_sum;       /* sum of all latencies (HF ticks) */
+  rtimer_ext_clock_t cpu_time;          /* consumed host CPU time (HF ticks) */
+} rtimer_ext_native_stats_t;
+
+
+/**
+ * @brief initialize the virtual timers
+ */
+void rtimer_ext_init(void);
+
+/**
+ * @brief schedule (start) an rtimer_ext
+ * @param[in] timer the ID of the rtimer_ext, must by of type rtimer_ext_id_t
+ * @param[in] start the expiration time (absolute counter value)
+ * @param[in] period the period; set this to zero if you don't want this timer
+ * trigger an interrupt periodically
+ * @param[in] func the callback function; will be executed as soon as the timer
+ * has expired
+ */
+void rtimer_ext_schedule(rtimer_ext_id_t timer,
+                         rtimer_ext_clock_t start,
+                         rtimer_ext_clock_t period,
+                         rtimer_ext_callback_t func);
+
+/**
+ * @brief set a timer to event mode (no effect on the native platform, there
+ * are no capture inputs)
+ */
+void rtimer_ext_wait_for_event(rtimer_ext_id_t timer, rtimer_ext_callback_t func);
+
+/**
+ * @brief stop an rtimer_ext
+ * @param[in] timer the ID of the rtimer_ext, must by of type rtimer_ext_id_t
+ */
+void rtimer_ext_stop(rtimer_ext_id_t timer);
+
+/**
+ * @brief resets the rtimer_ext values (both LF and HF) to zero
+ */
+void rtimer_ext_reset(void);
+
+/**
+ * @brief get the current LF timer value
+ * @return timer value in timer clock ticks (timestamp)
+ */
+rtimer_ext_clock_t rtimer_ext_now_lf(void);
+uint16_t rtimer_ext_now_lf_hw(void);
+
+/**
+ * @brief get the current HF timer value
+ * @return timer value in timer clock ticks (timestamp)
+ */
+rtimer_ext_clock_t rtimer_ext_now_hf(void);
+
+/**
+ * @brief get the current timer value of both, the high and low frequency
+ * timer
+ */
+void rtimer_ext_now(rtimer_ext_clock_t* const hf_val, rtimer_ext_clock_t* const lf_val);
+
+/**
+ * @brief get the timestamp of the next scheduled expiration
+ * @param[in] timer the ID of an rtimer_ext
+ * @param[out] exp_time expiration time
+ * @return 1 if the timer is still active, 0 otherwise
+ */
+uint8_t rtimer_ext_next_expiration(rtimer_ext_id_t timer, rtimer_ext_clock_t* exp_time);
+
+/*--------------------------- native platform only ---------------------------*/
+
+/**
+ * @brief get the virtual time of the next pending event (timer expiration or
+ * etimer tick)
+ * @param[out] t virtual time in HF ticks
+ * @return 1 if there is a pending event, 0 otherwise
+ */
+uint8_t rtimer_ext_native_next_expiration(rtimer_ext_clock_t* t);
+
+/**
+ * @brief advance the virtual clock to time t (HF ticks) and execute all
+ * timer callbacks that are due by then
+ * @note the clock is never moved backwards
+ */
+void rtimer_ext_native_run(rtimer_ext_clock_t t);
+
+/**
+ * @brief get the current virtual time in HF ticks (not affected by
+ * rtimer_ext_reset())
+ */
+rtimer_ext_clock_t rtimer_ext_native_time(void);
+
+/**
+ * @brief set the rate error of the local clock (rtimer_ext_now_hf() and
+ * the timers), to simulate the clock drift of a node
+ * @param ppb deviation from the virtual time in parts per billion
+ * @note call before the first rtimer_ext_reset(), the local time jumps
+ * otherwise
+ */
+void rtimer_ext_native_set_drift(int32_t ppb);
+
+/**
+ * @brief enable or disable the accounting of host CPU time
+ * @note disable it to get deterministic and reproducible runs
+ */
+void rtimer_ext_native_set_cpu_time(uint8_t enable);
+
+/**
+ * @brief get the timer dispatch statistics
+ */
+const rtimer_ext_native_stats_t* rtimer_ext_native_get_stats(void);
+
+
+#endif /* RTIMER_EXT_H_ */
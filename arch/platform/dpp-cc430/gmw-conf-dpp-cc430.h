@@ -77,6 +77,12 @@
 #define GMW_CONF_RF_TX_CHANNEL          GMW_RF_TX_CHANNEL_870_0_MHz
 #endif /* GMW_CONF_RF_TX_CHANNEL */
 
+/* channels 1 to 9 (0 and 10 are often used by other networks), successive
+ * entries are at least 400 kHz apart */
+#ifndef GMW_CONF_HOPPING_CHANNELS
+#define GMW_CONF_HOPPING_CHANNELS       1, 5, 9, 3, 7, 2, 6, 4, 8
+#endif /* GMW_CONF_HOPPING_CHANNELS */
+
 #define GMW_CONF_RTIMER_ID              RTIMER_EXT_LF_0
 
 /* min. duration of 1 packet transmission with Glossy in us
@@ -110,6 +116,7 @@
   #define GMW_PRIM_DEFAULT           0     /* default Glossy */
   #define GMW_PRIM_CHAOS             1
   #define GMW_PRIM_STROBING          2
+  /* no GMW_PRIM_GLOSSY_HOPPING (GMW_IN_FLOOD_HOPPING is not supported) */
 
   #if GMW_PRIM2_ENABLE
   #define GMW_START_PRIM2(initiator_id, payload, payload_len, n_tx_max, sync, rf_cal)  strobing_start((initiator_id == node_id), payload, payload_len, n_tx_max)
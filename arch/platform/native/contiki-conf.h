@@ -0,0 +1,71 @@
+/* -*- C -*- */
+
+/**
+ * \file
+ *         Configuration of the native platform (x86-64 Linux)
+ *
+ * The native platform runs the GMW round engine as a regular Linux process
+ * on top of a virtual clock and a software flood primitive (see
+ * dev/glossy.c and arch/cpu/native/rtimer-ext.c).
+ */
+
+#ifndef CONTIKI_CONF_H
+#define CONTIKI_CONF_H
+
+/* include the project config */
+#ifdef PROJECT_CONF_PATH
+#include PROJECT_CONF_PATH
+#endif /* PROJECT_CONF_PATH */
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <inttypes.h>
+/*---------------------------------------------------------------------------*/
+/* virtual CPU frequency (same as on the sky mote, must be a multiple of
+ * 32768 Hz) */
+#ifndef F_CPU
+#define F_CPU                           4194304UL
+#endif /* F_CPU */
+
+/* RAM size, only used for the debug-print stack guard */
+#ifndef SRAM_START
+#define SRAM_START                      0
+#endif /* SRAM_START */
+#ifndef SRAM_SIZE
+#define SRAM_SIZE                       0
+#endif /* SRAM_SIZE */
+
+/* one LF timer for GMW, one for the Contiki rtimer */
+#ifndef RTIMER_EXT_CONF_NUM_LF
+#define RTIMER_EXT_CONF_NUM_LF          2
+#endif /* RTIMER_EXT_CONF_NUM_LF */
+
+#define CLOCK_CONF_SECOND               128UL
+
+typedef unsigned long clock_time_t;
+typedef unsigned short uip_stats_t;
+
+#define CC_CONF_INLINE                  inline
+
+#define BV(x)                           (1 << x)
+
+/* the node ID is passed on the command line (see platform.c) */
+#define PLATFORM_CONF_MAIN_ACCEPTS_ARGS 1
+#define PLATFORM_CONF_PROVIDES_MAIN_LOOP 1
+
+/* no radio driver, all communication goes through the flood primitives */
+#ifndef NETSTACK_CONF_RADIO
+#define NETSTACK_CONF_RADIO             nullradio_driver
+#endif /* NETSTACK_CONF_RADIO */
+
+/* the stack check library relies on linker symbols of the MCU targets */
+#ifndef STACK_CHECK_CONF_ENABLED
+#define STACK_CHECK_CONF_ENABLED        0
+#endif
+
+/* heapmem is not used by GMW, but a 1-byte arena triggers array-bounds
+ * warnings with recent host compilers */
+#ifndef HEAPMEM_CONF_ARENA_SIZE
+#define HEAPMEM_CONF_ARENA_SIZE         64
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+/*---------------------------------------------------------------------------*/
+#endif /* CONTIKI_CONF_H */
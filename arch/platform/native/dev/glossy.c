@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *
+ * Glossy for the native platform (software flood on the virtual medium).
+ */
+
+#include <string.h>
+#include "glossy.h"
+#include "node-id.h"
+#include "gpio.h"
+#include "native-medium.h"
+
+/*---------------------------------------------------------------------------*/
+/* mainly for debugging purposes */
+#ifdef GLOSSY_START_PIN
+#define GLOSSY_STARTED      PIN_SET(GLOSSY_START_PIN)
+#define GLOSSY_STOPPED      PIN_CLR(GLOSSY_START_PIN)
+#else
+#define GLOSSY_STARTED
+#define GLOSSY_STOPPED
+#endif
+
+#if GLOSSY_CONF_SETUPTIME_WITH_SYNC
+#define GLOSSY_SYNC_SETUP_TICKS       (GLOSSY_CONF_SETUPTIME_WITH_SYNC * RTIMER_EXT_SECOND_LF / 1000000)
+#else
+#define GLOSSY_SYNC_SETUP_TICKS       0
+#endif /* GLOSSY_CONF_SETUPTIME_WITH_SYNC */
+
+/*---------------------------------------------------------------------------*/
+enum glossy_state {
+  GLOSSY_STATE_OFF,          /**< Glossy is not executing */
+  GLOSSY_STATE_WAITING,      /**< Glossy is waiting for a packet being flooded */
+  GLOSSY_STATE_RECEIVING,    /**< Glossy is receiving a packet */
+  GLOSSY_STATE_RECEIVED,     /**< Glossy has just finished receiving a packet */
+  GLOSSY_STATE_TRANSMITTING, /**< Glossy is transmitting a packet */
+  GLOSSY_STATE_TRANSMITTED,  /**< Glossy has just finished transmitting a packet */
+  GLOSSY_STATE_ABORTED       /**< Glossy has just aborted a packet reception */
+};
+/*---------------------------------------------------------------------------*/
+static native_medium_op_t op;
+static uint8_t state = GLOSSY_STATE_OFF;
+static const uint8_t hop_channels[] = { GLOSSY_CONF_HOPPING_CHANNELS };
+/* stats */
+static uint32_t flood_cnt, flood_cnt_success;
+static uint32_t total_rx_success_cnt, total_rx_try_cnt;
+/*---------------------------------------------------------------------------*/
+static void
+start(uint16_t initiator_id, uint8_t *payload, uint8_t payload_len,
+      uint8_t n_tx_max, uint8_t with_sync, uint8_t hopping)
+{
+  GLOSSY_STARTED;
+
+  op.primitive    = NATIVE_MEDIUM_GLOSSY;
+  op.is_initiator = (initiator_id == node_id);
+  op.initiator_id = initiator_id;
+  op.payload      = payload;
+  op.payload_len  = payload_len;
+  op.n_tx_max     = n_tx_max;
+  op.with_sync    = with_sync;
+  /* in-flood channel hopping: the medium switches the channel after each
+   * relay step */
+  op.hop_channels   = hopping ? hop_channels : NULL;
+  op.n_hop_channels = hopping ? sizeof(hop_channels) : 0;
+  op.t_start      = rtimer_ext_now_lf();
+  /* the first transmission starts after the constant setup time */
+  op.t_tx         = op.t_start + (with_sync ? GLOSSY_SYNC_SETUP_TICKS : 0);
+
+  state = op.is_initiator ? GLOSSY_STATE_TRANSMITTING : GLOSSY_STATE_WAITING;
+
+  native_medium_start(&op);
+
+  if(op.is_initiator) {
+    op.t_ref = op.t_tx;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*------------------------------- Main interface ----------------------------*/
+/*---------------------------------------------------------------------------*/
+void
+glossy_start(uint16_t initiator_id,
+             uint8_t *payload,
+             uint8_t payload_len,
+             uint8_t n_tx_max,
+             uint8_t with_sync,
+             uint8_t dco_cal)
+{
+  start(initiator_id, payload, payload_len, n_tx_max, with_sync, 0);
+}
+/*---------------------------------------------------------------------------*/
+void
+glossy_start_hopping(uint16_t initiator_id,
+                     uint8_t *payload,
+                     uint8_t payload_len,
+                     uint8_t n_tx_max,
+                     uint8_t with_sync,
+                     uint8_t dco_cal)
+{
+  start(initiator_id, payload, payload_len, n_tx_max, with_sync, 1);
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+glossy_stop(void)
+{
+  if(state == GLOSSY_STATE_OFF) {
+    return op.rx_cnt;
+  }
+  native_medium_stop(&op);
+  state = GLOSSY_STATE_OFF;
+
+  if(!op.is_initiator) {
+    if(op.rx_try_cnt) {
+      flood_cnt++;
+    }
+    if(op.rx_cnt) {
+      flood_cnt_success++;
+    }
+  }
+  total_rx_success_cnt += op.rx_cnt;
+  total_rx_try_cnt     += op.rx_try_cnt;
+
+  GLOSSY_STOPPED;
+
+  return op.rx_cnt;
+}
+/*---------------------------------------------------------------------------*/
+void
+glossy_timer_int_cb(void)
+{
+  /* nothing to do, there are no radio interrupts on the native platform */
+}
+/*---------------------------------------------------------------------------*/
+/*----------------------------- Get functions -------------------------------*/
+/*---------------------------------------------------------------------------*/
+uint8_t
+glossy_get_rx_cnt(void)
+{
+  return op.rx_cnt;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+glossy_get_rx_try_cnt(void)
+{
+  return op.rx_try_cnt;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+glossy_get_relay_cnt(void)
+{
+  return op.relay_cnt;
+}
+/*---------------------------------------------------------------------------*/
+rtimer_ext_clock_t
+glossy_get_t_rf_off(void)
+{
+  return op.t_rf_off ? op.t_rf_off : op.t_stop;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+glossy_is_t_ref_updated(void)
+{
+  return op.t_ref_updated;
+}
+/*---------------------------------------------------------------------------*/
+rtimer_ext_clock_t
+glossy_get_t_ref(void)
+{
+  return op.t_ref;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+glossy_get_payload_len(void)
+{
+  return op.payload_len;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+glossy_get_fsr(void)
+{
+  if(flood_cnt) {
+    return (uint16_t) ((uint64_t) flood_cnt_success * 10000 / (uint64_t) flood_cnt);
+  }
+  return 10000;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+glossy_get_per(void)
+{
+  if(total_rx_try_cnt) {
+    return (uint16_t)((total_rx_try_cnt - total_rx_success_cnt) * 100 / total_rx_try_cnt);
+  }
+  return 10000;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+glossy_get_state(void)
+{
+  return state;
+}
+/*---------------------------------------------------------------------------*/
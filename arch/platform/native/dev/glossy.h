@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *
+ * Glossy for the native platform.
+ *
+ * Software implementation of the Glossy interface on top of the virtual
+ * radio medium (see native-medium.h). The timing follows the real
+ * implementation: the initiator waits GLOSSY_CONF_SETUPTIME_WITH_SYNC before
+ * the first transmission, which is the reference time for all receivers.
+ */
+
+#ifndef GLOSSY_H_
+#define GLOSSY_H_
+
+#include "contiki.h"
+#include "rtimer-ext.h"
+
+/* include the Baloo configuration to overwrite the default settings */
+#if BALOO
+#include "gmw.h"
+#endif
+
+#ifndef GLOSSY_CONF_PAYLOAD_LEN
+#define GLOSSY_CONF_PAYLOAD_LEN         100
+#endif /* GLOSSY_CONF_PACKET_SIZE */
+
+/* magic number / identifier for a Glossy packet (4 bits only) */
+#ifndef GLOSSY_CONF_HEADER_BYTE
+#define GLOSSY_CONF_HEADER_BYTE         0x0a
+#endif /* GLOSSY_CONF_HEADER_BYTE */
+
+/* Constant setup time of the initiator (see the sky implementation). */
+#ifndef GLOSSY_CONF_SETUPTIME_WITH_SYNC
+#define GLOSSY_CONF_SETUPTIME_WITH_SYNC 1000UL    /* in us */
+#endif /* GLOSSY_CONF_SETUPTIME_WITH_SYNC */
+
+/* RF channels of the in-flood channel hopping (see glossy_start_hopping()),
+ * same sequence as robust Glossy on the sky platform */
+#ifndef GLOSSY_CONF_HOPPING_CHANNELS
+#define GLOSSY_CONF_HOPPING_CHANNELS    26, 11, 20, 16
+#endif /* GLOSSY_CONF_HOPPING_CHANNELS */
+
+/* do not change */
+#define GLOSSY_MAX_HEADER_LEN               4
+
+
+/* ----------------------- Application interface -------------------- */
+
+/**
+ * \brief               Start Glossy.
+ * \param initiator_id  Node ID of the flood initiator.
+ * \param payload       A pointer to the data.
+ * \param payload_len   Length of the flooding data, in bytes.
+ * \param n_tx_max      Maximum number of transmissions (N).
+ * \param with_sync     Not zero if Glossy must provide time synchronization,
+ *                      zero otherwise.
+ * \param dco_cal       Ignored on the native platform.
+ */
+void glossy_start(uint16_t initiator_id,
+                  uint8_t *payload,
+                  uint8_t payload_len,
+                  uint8_t n_tx_max,
+                  uint8_t with_sync,
+                  uint8_t dco_cal);
+
+/**
+ * \brief               Start Glossy with in-flood channel hopping.
+ *
+ * Same as glossy_start(), but all nodes switch to the next channel of
+ * GLOSSY_CONF_HOPPING_CHANNELS after each relay step (packet transmission),
+ * starting with the first channel of the list. A narrowband interferer
+ * therefore only corrupts some of the N transmissions of each node.
+ * \note                As with robust Glossy, the receivers follow the
+ *                      channel sequence based on the packet duration: on
+ *                      real hardware, they must know the payload length in
+ *                      advance.
+ */
+void glossy_start_hopping(uint16_t initiator_id,
+                          uint8_t *payload,
+                          uint8_t payload_len,
+                          uint8_t n_tx_max,
+                          uint8_t with_sync,
+                          uint8_t dco_cal);
+
+/**
+ * \brief            Stop Glossy.
+ * \returns          Number of times the packet has been received during
+ *                   last Glossy phase.
+ */
+uint8_t glossy_stop(void);
+
+/**
+ * \brief            Get the last received counter.
+ */
+uint8_t glossy_get_rx_cnt(void);
+
+/**
+ * \brief            Get the number of started receptions
+ */
+uint8_t glossy_get_rx_try_cnt(void);
+
+/**
+ * \brief            Get the current Glossy state.
+ */
+uint8_t glossy_get_state(void);
+
+/**
+ * \brief            Get the relay counter of the first received packet.
+ */
+uint8_t glossy_get_relay_cnt(void);
+
+/**
+ * \brief            Get the time the radio was turned off after the last
+ *                   transmission of the flood (LF ticks), i.e. the end of the
+ *                   flood for this node.
+ */
+rtimer_ext_clock_t glossy_get_t_rf_off(void);
+
+/**
+ * \brief            Not zero if the synchronization reference time was
+ *                   updated during the last Glossy phase, zero otherwise.
+ */
+uint8_t glossy_is_t_ref_updated(void);
+
+/**
+ * \brief            Get the sync reference time.
+ * \returns          Timestamp in rtimer-ext clock ticks (LF)
+ */
+rtimer_ext_clock_t glossy_get_t_ref(void);
+
+/**
+ * \brief get the received payload length of the last flood
+ */
+uint8_t glossy_get_payload_len(void);
+
+/**
+ * \brief            get the average flood success rate
+ * \returns          percentage * 100 of successful floods
+ */
+uint16_t glossy_get_fsr(void);
+
+/**
+ * \brief            get the average packet error rate
+ */
+uint16_t glossy_get_per(void);
+
+/**
+ * \brief timer callback (not used on the native platform)
+ */
+void glossy_timer_int_cb(void);
+
+
+#endif /* GLOSSY_H_ */
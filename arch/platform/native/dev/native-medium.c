@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *
+ * Virtual radio medium interface of the native platform.
+ */
+
+#include <string.h>
+#include "native-medium.h"
+/*---------------------------------------------------------------------------*/
+static const native_medium_t* medium;
+static uint8_t rf_channel;
+static rtimer_ext_clock_t rf_on_time;
+/*---------------------------------------------------------------------------*/
+void
+native_medium_set(const native_medium_t* m)
+{
+  medium = m;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_medium_set_rf_channel(uint8_t channel)
+{
+  rf_channel = channel;
+}
+/*---------------------------------------------------------------------------*/
+rtimer_ext_clock_t
+native_medium_get_rf_on_time(void)
+{
+  return rf_on_time;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_medium_start(native_medium_op_t* op)
+{
+  op->rf_channel    = rf_channel;
+  op->rx_cnt        = 0;
+  op->rx_try_cnt    = 0;
+  op->relay_cnt     = 0;
+  op->t_ref_updated = 0;
+  op->t_ref         = 0;
+  op->t_rf_off      = 0;
+  op->t_stop        = 0;
+  if(medium && medium->start) {
+    medium->start(op);
+  }
+}
+/*---------------------------------------------------------------------------*/
+rtimer_ext_clock_t
+native_medium_stop(native_medium_op_t* op)
+{
+  rtimer_ext_clock_t t_on;
+
+  op->t_stop = rtimer_ext_now_lf();
+  if(medium && medium->stop) {
+    medium->stop(op);
+  }
+  if(op->t_rf_off && op->t_rf_off < op->t_stop) {
+    t_on = (op->t_rf_off > op->t_start) ? (op->t_rf_off - op->t_start) : 0;
+  } else {
+    t_on = op->t_stop - op->t_start;
+  }
+  rf_on_time += t_on;
+  return t_on;
+}
+/*---------------------------------------------------------------------------*/
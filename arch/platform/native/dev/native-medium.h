@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *
+ * Virtual radio medium interface of the native platform.
+ *
+ * The software implementations of the communication primitives (Glossy and
+ * strobing) describe each slot as a native_medium_op_t. When a medium is
+ * attached (e.g. by a network simulator), it is notified at the start and
+ * at the end of each slot and fills in the outcome (number of receptions,
+ * reference time, radio-on time). Without a medium the node is alone: the
+ * initiator transmits into the void and receivers never hear anything.
+ */
+
+#ifndef NATIVE_MEDIUM_H_
+#define NATIVE_MEDIUM_H_
+
+#include "contiki.h"
+#include "rtimer-ext.h"
+
+typedef enum {
+  NATIVE_MEDIUM_GLOSSY = 0,
+  NATIVE_MEDIUM_STROBING,
+} native_medium_primitive_t;
+
+/**
+ * @brief one slot (flood) as seen by a single node
+ * @note all timestamps are local LF timestamps (rtimer_ext_now_lf())
+ */
+typedef struct {
+  /* input, set by the primitive */
+  uint8_t             primitive;    /* native_medium_primitive_t */
+  uint8_t             is_initiator;
+  uint16_t            initiator_id;
+  uint8_t*            payload;      /* TX data or RX buffer */
+  uint8_t             payload_len;  /* 0 if unknown (receiver) */
+  uint8_t             n_tx_max;
+  uint8_t             with_sync;
+  uint8_t             rf_channel;   /* set by native_medium_start() */
+  const uint8_t*      hop_channels; /* channel of each relay step (in-flood
+                                       hopping), NULL = stay on rf_channel */
+  uint8_t             n_hop_channels;
+  rtimer_ext_clock_t  t_start;      /* radio on */
+  rtimer_ext_clock_t  t_tx;         /* first transmission (initiator only) */
+  rtimer_ext_clock_t  t_stop;       /* radio off (set before stop is called) */
+  /* output, set by the medium (zero if no medium is attached) */
+  uint8_t             rx_cnt;
+  uint8_t             rx_try_cnt;
+  uint8_t             relay_cnt;    /* relay counter of the first RX */
+  uint8_t             t_ref_updated;
+  rtimer_ext_clock_t  t_ref;
+  rtimer_ext_clock_t  t_rf_off;     /* time the radio was actually turned off,
+                                       0 = at t_stop */
+} native_medium_op_t;
+
+/**
+ * @brief medium callbacks
+ */
+typedef struct {
+  void (*start)(native_medium_op_t* op);
+  void (*stop)(native_medium_op_t* op);
+} native_medium_t;
+
+/**
+ * @brief attach a medium (NULL to detach)
+ */
+void native_medium_set(const native_medium_t* medium);
+
+/**
+ * @brief set the RF channel for all subsequent slots
+ */
+void native_medium_set_rf_channel(uint8_t channel);
+
+/**
+ * @brief get the accumulated radio-on time of all slots in LF ticks
+ */
+rtimer_ext_clock_t native_medium_get_rf_on_time(void);
+
+/**
+ * @brief notify the attached medium about the start of a slot
+ */
+void native_medium_start(native_medium_op_t* op);
+
+/**
+ * @brief notify the attached medium about the end of a slot and collect the
+ * outcome
+ * @return the radio-on time of this node during the slot in LF ticks
+ */
+rtimer_ext_clock_t native_medium_stop(native_medium_op_t* op);
+
+#endif /* NATIVE_MEDIUM_H_ */
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *
+ * Strobing for the native platform (software implementation on the virtual
+ * medium).
+ */
+
+#include "strobing.h"
+#include "node-id.h"
+#include "native-medium.h"
+/*---------------------------------------------------------------------------*/
+static native_medium_op_t op;
+static uint8_t active;
+/*---------------------------------------------------------------------------*/
+void
+strobing_start(uint8_t is_initiator,
+               uint8_t* payload,
+               uint8_t payload_len,
+               uint8_t n_tx)
+{
+  op.primitive    = NATIVE_MEDIUM_STROBING;
+  op.is_initiator = is_initiator;
+  op.initiator_id = is_initiator ? node_id : 0;
+  op.payload      = payload;
+  op.payload_len  = payload_len;
+  op.n_tx_max     = n_tx;
+  op.with_sync    = 0;
+  op.t_start      = rtimer_ext_now_lf();
+  op.t_tx         = op.t_start;
+  active = 1;
+  native_medium_start(&op);
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+strobing_stop(void)
+{
+  if(active) {
+    native_medium_stop(&op);
+    active = 0;
+  }
+  return op.rx_cnt;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+strobing_is_active(void)
+{
+  return active;
+}
+/*---------------------------------------------------------------------------*/
+void
+strobing_timer_int_cb(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+strobing_get_rx_cnt(void)
+{
+  return op.rx_cnt;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+strobing_get_rx_try_cnt(void)
+{
+  return op.rx_try_cnt;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+strobing_get_payload_len(void)
+{
+  return op.payload_len;
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,1267 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *
+ * Multi-node network simulator of the native platform.
+ *
+ * Booting: the first node is booted by the regular main(). The simulator
+ * then boots all other nodes by restoring the initial memory image and
+ * calling main() again (platform_main_loop() returns immediately while a
+ * node is being booted).
+ *
+ * Medium: a flood is resolved lazily when the first participating node
+ * turns off its radio. All nodes that listen on the same channel take part;
+ * the flood is propagated step by step (one step = one packet transmission)
+ * as in Glossy: a node that receives the packet in step s transmits it in
+ * steps s+1, s+3, ... (n_tx times) and listens in between. A node that
+ * listens in step s receives the packet with probability
+ * 1 - prod(1 - prr(t, node)) over all neighbors t that transmit in step s.
+ *
+ * Interference: optionally, a Wi-Fi network in range of all nodes occupies
+ * one Wi-Fi channel (-w). No packet is received on the overlapping
+ * IEEE 802.15.4 channels while a Wi-Fi burst is on the air. With in-flood
+ * channel hopping, step s of a flood uses channel s of the hopping sequence
+ * (modulo its length), i.e. only the steps on an overlapping channel are
+ * affected.
+ *
+ * All state of the simulator lives on the heap, only the pointer 'sim' is
+ * part of the (swapped) program memory and has the same value in all node
+ * images.
+ *
+ * Memory images: only the pages of the program memory (.data and .bss) that
+ * a node has written are saved and restored when switching nodes, all other
+ * pages equal the initial image. Writes are detected with the MMU: the pages
+ * that the loaded node has not written yet are write-protected and the first
+ * write to such a page (SIGSEGV) marks it as written by this node. The cost
+ * of a switch is thus proportional to the memory a node actually uses (e.g.
+ * the stream table of an LWB host is only copied for the host) and the
+ * protection only changes for the pages in which the two nodes differ. System
+ * calls must therefore not write to the program memory (they would fail with
+ * EFAULT on a protected page).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/mman.h>
+
+#include "contiki.h"
+#include "node-id.h"
+#include "rtimer-ext.h"
+#include "native-medium.h"
+#include "native-sim.h"
+/*---------------------------------------------------------------------------*/
+/* boundaries of the writable memory of the program (set by the linker) */
+extern char __data_start[], _end[];
+/* the firmware entry point, executed once for each node */
+extern int main(int argc, char** argv);
+/*---------------------------------------------------------------------------*/
+#define US_TO_HF(us)        ((rtimer_ext_clock_t)(us) * RTIMER_EXT_SECOND_HF / \
+                             1000000)
+#define HF_TO_MS(t)         ((double)(t) * 1000.0 / RTIMER_EXT_SECOND_HF)
+#define LF_TO_MS(t)         ((double)(t) * 1000.0 / RTIMER_EXT_SECOND_LF)
+#define NO_STEP             INT16_MIN
+#define MAX_STEPS           1024
+#define MAX_NODE_ID         0xffff
+/*---------------------------------------------------------------------------*/
+typedef struct {
+  uint32_t node;                /* index of the other node */
+  float    prr;                 /* packet reception ratio */
+} sim_link_t;
+
+typedef struct {
+  uint16_t           id;
+  uint8_t            listening; /* radio turned on by a primitive */
+  uint8_t            primitive;
+  uint8_t            channel;
+  uint8_t            n_hop;     /* length of the hopping sequence, 0 = none */
+  uint8_t            n_tx;
+  int16_t            flood;     /* flood initiated by this node or -1 */
+  rtimer_ext_clock_t t_start;   /* radio on (global time) */
+} sim_node_t;
+
+typedef struct {
+  uint8_t            used;
+  uint8_t            computed;
+  uint8_t            primitive;
+  uint8_t            channel;
+  uint8_t            with_sync;
+  uint8_t            len;       /* max. payload length of all initiators */
+  uint8_t            n_init;
+  uint32_t           init[NATIVE_SIM_CONF_MAX_INITIATORS];
+  uint8_t            payload_len[NATIVE_SIM_CONF_MAX_INITIATORS];
+  uint8_t            payload[NATIVE_SIM_CONF_MAX_INITIATORS]
+                            [NATIVE_SIM_CONF_MAX_PKT_LEN];
+  uint32_t           seq;       /* sequence number, seeds the PRNG */
+  int16_t            n_steps;
+  rtimer_ext_clock_t t_tx;      /* first transmission (global time) */
+  rtimer_ext_clock_t t_hop;     /* duration of one step */
+  uint8_t            n_hop;     /* length of the hopping sequence, 0 = none */
+  const uint8_t*     hop;       /* hopping sequence (firmware constant) */
+  uint8_t            jammed;    /* channel overlaps with the Wi-Fi channel */
+  uint32_t           hop_jam;   /* hopping channels that overlap */
+  uint8_t            jam[MAX_STEPS / 8];  /* steps hit by a Wi-Fi burst */
+  /* per node */
+  int16_t*           has;       /* step of the first reception */
+  int16_t*           start_step;/* first step the radio is on */
+  uint8_t*           part;      /* participates in the flood */
+  uint8_t*           n_tx;
+  uint8_t*           rx_cnt;
+  uint8_t*           rx_try;
+  uint8_t*           src;       /* initiator of the received packet */
+} sim_flood_t;
+
+typedef struct {
+  uint32_t floods;
+  uint32_t expected;            /* flood receptions by listening nodes */
+  uint32_t delivered;
+  uint32_t ctrl_expected;       /* same for floods with sync */
+  uint32_t ctrl_delivered;
+  uint64_t rf_on;               /* radio-on time of all nodes (LF ticks) */
+} sim_stats_t;
+
+typedef struct {
+  rtimer_ext_clock_t t;
+  uint32_t           node;
+} sim_event_t;
+
+typedef struct {
+  native_sim_cfg_t   cfg;
+  int                argc;
+  char**             argv;
+  /* nodes and topology */
+  uint32_t           n;
+  sim_node_t*        nodes;
+  uint32_t*          out_ofs;   /* outgoing links of node i: out_ofs[i] */
+  sim_link_t*        out;       /*   ... out_ofs[i + 1] - 1 */
+  uint32_t*          in_ofs;    /* incoming links */
+  sim_link_t*        in;
+  uint32_t           n_links;
+  /* memory images */
+  size_t             image_size;
+  size_t             page_size;
+  uint32_t           n_pages;   /* pages that overlap with the image */
+  uint8_t*           pristine;
+  uint8_t*           images;
+  uint8_t*           dirty;     /* node i has written page p:
+                                   dirty[i * n_pages + p] */
+  uint64_t           swaps;
+  uint64_t           swapped;   /* bytes copied */
+  uint32_t           cur;       /* node that is currently executing */
+  uint32_t           loaded;    /* node whose image is in memory */
+  uint8_t            booting;
+  /* event queue (binary heap) */
+  sim_event_t*       queue;
+  uint32_t           queue_len;
+  uint64_t           events;
+  /* medium */
+  sim_flood_t        floods[NATIVE_SIM_CONF_MAX_FLOODS];
+  uint32_t           flood_seq;
+  uint64_t           rng;
+  double*            fail;      /* scratch: probability of no reception */
+  uint32_t*          best;      /* scratch: strongest transmitter */
+  float*             best_prr;
+  uint32_t*          touched;
+  uint32_t*          active;
+  /* statistics */
+  sim_stats_t        round;
+  sim_stats_t        total;
+  uint32_t           round_cnt;
+  double             min_rel;
+  rtimer_ext_clock_t round_start;
+  /* output */
+  FILE*              report;
+  int                fd_stdout;
+  int                fd_null;
+  uint8_t            stdout_on;
+} native_sim_t;
+/*---------------------------------------------------------------------------*/
+static native_sim_t* sim;
+/*---------------------------------------------------------------------------*/
+static void*
+sim_alloc(size_t size)
+{
+  void* p = calloc(1, size ? size : 1);
+  if(!p) {
+    fprintf(stderr, "sim: out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+/* xorshift64* */
+static inline double
+rng_uniform(void)
+{
+  sim->rng ^= sim->rng >> 12;
+  sim->rng ^= sim->rng << 25;
+  sim->rng ^= sim->rng >> 27;
+  return (double)((sim->rng * 2685821657736338717ULL) >> 11) /
+         9007199254740992.0;
+}
+/*---------------------------------------------------------------------------*/
+static inline void
+rng_seed(uint64_t s)
+{
+  sim->rng = (sim->cfg.seed + 1) * 0x9e3779b97f4a7c15ULL ^
+             (s + 1) * 0xbf58476d1ce4e5b9ULL;
+  if(!sim->rng) {
+    sim->rng = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*------------------------------- Topology ----------------------------------*/
+/*---------------------------------------------------------------------------*/
+typedef struct {
+  uint32_t tx;
+  uint32_t rx;
+  double   prr;
+} sim_edge_t;
+
+static sim_edge_t* edges;
+static uint32_t    n_edges, edges_size;
+/*---------------------------------------------------------------------------*/
+static void
+add_edge(uint32_t tx, uint32_t rx, double prr)
+{
+  if(tx == rx || tx > MAX_NODE_ID || rx > MAX_NODE_ID) {
+    return;
+  }
+  if(prr > 1.0) {
+    prr /= 100.0;     /* given in percent */
+  }
+  if(prr > 1.0) {
+    prr = 1.0;
+  }
+  if(n_edges == edges_size) {
+    edges_size = edges_size ? edges_size * 2 : 1024;
+    edges = realloc(edges, edges_size * sizeof(sim_edge_t));
+    if(!edges) {
+      fprintf(stderr, "sim: out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  edges[n_edges].tx  = tx;
+  edges[n_edges].rx  = rx;
+  edges[n_edges].prr = prr;
+  n_edges++;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cmp_edge(const void* a, const void* b)
+{
+  const sim_edge_t* ea = a;
+  const sim_edge_t* eb = b;
+  if(ea->tx != eb->tx) {
+    return (ea->tx < eb->tx) ? -1 : 1;
+  }
+  if(ea->rx != eb->rx) {
+    return (ea->rx < eb->rx) ? -1 : 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* parse one line of a link-quality file, supported formats:
+ * - "<tx> <rx> <prr>" (prr as ratio or in percent, ',' or ' ' separated)
+ * - the output of baloo-link-quality-test, e.g. a FlockLab serial log line
+ *   "<timestamp>,<observer>,<rx>,r,Log:<tx>:<n_rcvd>:..."; the receiver is
+ *   the last integer field in front of "Log:" */
+static void
+parse_line(char* line)
+{
+  char* p = strstr(line, "Log:");
+  unsigned int tx, rx, cnt;
+  double prr;
+
+  if(p) {
+    char* tok;
+    long last = -1;
+    *p = 0;
+    for(tok = strtok(line, ", \t;"); tok; tok = strtok(NULL, ", \t;")) {
+      char* end;
+      long v = strtol(tok, &end, 10);
+      if(end != tok && *end == 0) {
+        last = v;
+      }
+    }
+    if(last >= 0 && sscanf(p + 1, "og:%u:%u", &tx, &cnt) == 2) {
+      add_edge(tx, (uint32_t)last, (double)cnt / sim->cfg.lq_strobes);
+    }
+    return;
+  }
+  for(p = line; *p; p++) {
+    if(*p == ',' || *p == ';') {
+      *p = ' ';
+    }
+  }
+  if(line[0] != '#' && sscanf(line, "%u %u %lf", &tx, &rx, &prr) == 3) {
+    add_edge(tx, rx, prr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+load_link_file(const char* file)
+{
+  char line[1024];
+  FILE* fp = fopen(file, "r");
+  if(!fp) {
+    perror(file);
+    exit(EXIT_FAILURE);
+  }
+  while(fgets(line, sizeof(line), fp)) {
+    parse_line(line);
+  }
+  fclose(fp);
+}
+/*---------------------------------------------------------------------------*/
+/* nodes on a square grid (unit spacing) with distance-dependent link
+ * qualities, node IDs 1..n */
+static void
+create_grid(uint32_t n)
+{
+  static const double prr_d2[] = { 0, 0.98, 0.9, 0, 0.6, 0.3 };
+  uint32_t side = 1, i;
+  int dx, dy;
+
+  while(side * side < n) {
+    side++;
+  }
+  rng_seed(0xffffffff);
+  for(i = 0; i < n; i++) {
+    int x = i % side, y = i / side;
+    for(dy = -2; dy <= 2; dy++) {
+      for(dx = -2; dx <= 2; dx++) {
+        int d2 = dx * dx + dy * dy;
+        int nx = x + dx, ny = y + dy;
+        uint32_t j = ny * side + nx;
+        if(d2 == 0 || d2 > 5 || nx < 0 || ny < 0 || nx >= (int)side ||
+           j >= n || prr_d2[d2] == 0) {
+          continue;
+        }
+        add_edge(i + 1, j + 1, prr_d2[d2] - 0.1 * rng_uniform() + 0.05);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+build_topology(void)
+{
+  uint32_t* idx = sim_alloc((MAX_NODE_ID + 1) * sizeof(uint32_t));
+  uint32_t i, j, k;
+
+  /* merge duplicates (average) */
+  qsort(edges, n_edges, sizeof(sim_edge_t), cmp_edge);
+  for(i = 0, j = 0; i < n_edges; j++) {
+    double sum = 0;
+    for(k = i; k < n_edges && !cmp_edge(&edges[k], &edges[i]); k++) {
+      sum += edges[k].prr;
+    }
+    edges[j] = edges[i];
+    edges[j].prr = sum / (k - i);
+    i = k;
+  }
+  n_edges = j;
+
+  /* node indices in ascending order of the IDs */
+  for(i = 0; i < n_edges; i++) {
+    idx[edges[i].tx] = idx[edges[i].rx] = 1;
+  }
+  for(i = 0; i <= MAX_NODE_ID; i++) {
+    if(idx[i]) {
+      sim->n++;
+    }
+  }
+  if(!sim->n) {
+    fprintf(stderr, "sim: no links found\n");
+    exit(EXIT_FAILURE);
+  }
+  sim->nodes = sim_alloc(sim->n * sizeof(sim_node_t));
+  for(i = 0, j = 0; i <= MAX_NODE_ID; i++) {
+    if(idx[i]) {
+      sim->nodes[j].id = i;
+      idx[i] = j++;
+    }
+  }
+
+  /* adjacency lists (compressed rows) */
+  sim->out_ofs = sim_alloc((sim->n + 1) * sizeof(uint32_t));
+  sim->in_ofs  = sim_alloc((sim->n + 1) * sizeof(uint32_t));
+  sim->out     = sim_alloc(n_edges * sizeof(sim_link_t));
+  sim->in      = sim_alloc(n_edges * sizeof(sim_link_t));
+  for(i = 0; i < n_edges; i++) {
+    if(edges[i].prr <= 0) {
+      continue;
+    }
+    sim->out_ofs[idx[edges[i].tx] + 1]++;
+    sim->in_ofs[idx[edges[i].rx] + 1]++;
+    sim->n_links++;
+  }
+  for(i = 0; i < sim->n; i++) {
+    sim->out_ofs[i + 1] += sim->out_ofs[i];
+    sim->in_ofs[i + 1]  += sim->in_ofs[i];
+  }
+  {
+    uint32_t* out_pos = sim_alloc(sim->n * sizeof(uint32_t));
+    uint32_t* in_pos  = sim_alloc(sim->n * sizeof(uint32_t));
+    memcpy(out_pos, sim->out_ofs, sim->n * sizeof(uint32_t));
+    memcpy(in_pos, sim->in_ofs, sim->n * sizeof(uint32_t));
+    for(i = 0; i < n_edges; i++) {
+      uint32_t tx = idx[edges[i].tx], rx = idx[edges[i].rx];
+      if(edges[i].prr <= 0) {
+        continue;
+      }
+      sim->out[out_pos[tx]].node = rx;
+      sim->out[out_pos[tx]++].prr = (float)edges[i].prr;
+      sim->in[in_pos[rx]].node = tx;
+      sim->in[in_pos[rx]++].prr = (float)edges[i].prr;
+    }
+    free(out_pos);
+    free(in_pos);
+  }
+  free(idx);
+  free(edges);
+  edges = NULL;
+  n_edges = edges_size = 0;
+}
+/*---------------------------------------------------------------------------*/
+/*---------------------------- Node execution -------------------------------*/
+/*---------------------------------------------------------------------------*/
+static inline uint8_t*
+image(uint32_t node)
+{
+  return sim->images + (size_t)node * sim->image_size;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_output(uint32_t node)
+{
+  uint8_t on = (sim->cfg.output_node == NATIVE_SIM_OUTPUT_ALL ||
+                sim->cfg.output_node == sim->nodes[node].id);
+  if(on != sim->stdout_on) {
+    fflush(stdout);
+    dup2(on ? sim->fd_stdout : sim->fd_null, STDOUT_FILENO);
+    sim->stdout_on = on;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static inline uint8_t*
+page_addr(uint32_t p)
+{
+  /* the first page starts at the beginning of the image */
+  return p ? (uint8_t*)(((uintptr_t)__data_start & ~(sim->page_size - 1)) +
+                        p * sim->page_size)
+           : (uint8_t*)__data_start;
+}
+/*---------------------------------------------------------------------------*/
+static void
+protect_pages(const uint8_t* dirty_a, const uint8_t* dirty_b, int prot)
+{
+  /* (un)protects all runs of pages written by node a but not by node b; the
+   * first and the last page may be shared with other program data or the
+   * heap, they are never protected and always copied */
+  uint32_t p = 1, q;
+
+  while(p < sim->n_pages - 1) {
+    if(dirty_a[p] && !dirty_b[p]) {
+      for(q = p + 1; q < sim->n_pages - 1 && dirty_a[q] && !dirty_b[q]; q++);
+      mprotect(page_addr(p), (q - p) * sim->page_size, prot);
+      p = q;
+    } else {
+      p++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+on_segv(int sig, siginfo_t* info, void* ctx)
+{
+  uint8_t* addr  = info->si_addr;
+  uint8_t* dirty = sim->dirty + (size_t)sim->loaded * sim->n_pages;
+  uint32_t p;
+
+  if(addr >= page_addr(1) && addr < page_addr(sim->n_pages - 1)) {
+    p = (addr - page_addr(1)) / sim->page_size + 1;
+    if(!dirty[p]) {
+      /* first write of the loaded node to this page */
+      dirty[p] = 1;
+      mprotect(page_addr(p), sim->page_size, PROT_READ | PROT_WRITE);
+      return;
+    }
+  }
+  /* a real segmentation fault */
+  signal(SIGSEGV, SIG_DFL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+swap_image(uint32_t node)
+{
+  uint8_t* out       = image(sim->loaded);
+  uint8_t* in        = image(node);
+  uint8_t* out_dirty = sim->dirty + (size_t)sim->loaded * sim->n_pages;
+  uint8_t* in_dirty  = sim->dirty + (size_t)node * sim->n_pages;
+  size_t   ofs, len;
+  uint32_t p;
+
+  /* make the pages writable that only the new node has written */
+  protect_pages(in_dirty, out_dirty, PROT_READ | PROT_WRITE);
+  for(p = 0; p < sim->n_pages; p++) {
+    ofs = page_addr(p) - page_addr(0);
+    len = ((p == sim->n_pages - 1) ? (uint8_t*)_end : page_addr(p + 1)) -
+          page_addr(p);
+    if(p == 0 || p == sim->n_pages - 1) {
+      out_dirty[p] = 1;   /* shared page, not protected */
+    }
+    if(out_dirty[p]) {
+      memcpy(out + ofs, page_addr(p), len);
+      sim->swapped += len;
+      if(!in_dirty[p]) {
+        memcpy(page_addr(p), sim->pristine + ofs, len);
+      }
+    }
+    if(in_dirty[p]) {
+      memcpy(page_addr(p), in + ofs, len);
+      sim->swapped += len;
+    }
+  }
+  /* write-protect the pages that the new node has not written */
+  protect_pages(out_dirty, in_dirty, PROT_READ);
+  sim->loaded = node;
+  sim->swaps++;
+}
+/*---------------------------------------------------------------------------*/
+static inline void
+switch_to(uint32_t node)
+{
+  if(sim->loaded != node) {
+    swap_image(node);
+  }
+  sim->cur = node;
+  set_output(node);
+}
+/*---------------------------------------------------------------------------*/
+static inline int
+event_before(const sim_event_t* a, const sim_event_t* b)
+{
+  return (a->t < b->t) || (a->t == b->t && a->node < b->node);
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_push(rtimer_ext_clock_t t, uint32_t node)
+{
+  uint32_t i = sim->queue_len++;
+  sim_event_t ev = { t, node };
+  while(i) {
+    uint32_t parent = (i - 1) / 2;
+    if(!event_before(&ev, &sim->queue[parent])) {
+      break;
+    }
+    sim->queue[i] = sim->queue[parent];
+    i = parent;
+  }
+  sim->queue[i] = ev;
+}
+/*---------------------------------------------------------------------------*/
+static sim_event_t
+queue_pop(void)
+{
+  sim_event_t top = sim->queue[0];
+  sim_event_t last = sim->queue[--sim->queue_len];
+  uint32_t i = 0;
+  while(1) {
+    uint32_t c = 2 * i + 1;
+    if(c >= sim->queue_len) {
+      break;
+    }
+    if(c + 1 < sim->queue_len && event_before(&sim->queue[c + 1],
+                                              &sim->queue[c])) {
+      c++;
+    }
+    if(!event_before(&sim->queue[c], &last)) {
+      break;
+    }
+    sim->queue[i] = sim->queue[c];
+    i = c;
+  }
+  if(sim->queue_len) {
+    sim->queue[i] = last;
+  }
+  return top;
+}
+/*---------------------------------------------------------------------------*/
+/* run the current node until it is idle and schedule its next event */
+static void
+run_node(void)
+{
+  rtimer_ext_clock_t next;
+  while(process_run() > 0);
+  if(rtimer_ext_native_next_expiration(&next)) {
+    queue_push(next, sim->cur);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*-------------------------------- Medium -----------------------------------*/
+/*---------------------------------------------------------------------------*/
+/* offset between the local HF time of the current node and the global time */
+static inline rtimer_ext_clock_t
+local_ofs(void)
+{
+  return rtimer_ext_native_time() - rtimer_ext_now_hf();
+}
+/*---------------------------------------------------------------------------*/
+static inline rtimer_ext_clock_t
+to_local_lf(rtimer_ext_clock_t t)
+{
+  return (t - local_ofs()) / RTIMER_EXT_HF_LF_RATIO;
+}
+/*---------------------------------------------------------------------------*/
+static void
+round_close(void)
+{
+  sim_stats_t* r = &sim->round;
+  double rel = r->expected ? (double)r->delivered / r->expected : 1.0;
+
+  if(!sim->round_cnt) {
+    return;
+  }
+  if(rel < sim->min_rel) {
+    sim->min_rel = rel;
+  }
+  if(sim->cfg.print_rounds) {
+    fprintf(sim->report, "round %u: t=%.3fs, floods %u, reliability %.2f%%, "
+            "control %.2f%%, radio-on %.3fms/node\n",
+            sim->round_cnt, HF_TO_MS(sim->round_start) / 1000.0, r->floods,
+            rel * 100.0, r->ctrl_expected ?
+            (100.0 * r->ctrl_delivered / r->ctrl_expected) : 100.0,
+            LF_TO_MS(r->rf_on) / sim->n);
+  }
+  sim->total.floods         += r->floods;
+  sim->total.expected       += r->expected;
+  sim->total.delivered      += r->delivered;
+  sim->total.ctrl_expected  += r->ctrl_expected;
+  sim->total.ctrl_delivered += r->ctrl_delivered;
+  sim->total.rf_on          += r->rf_on;
+  memset(r, 0, sizeof(sim_stats_t));
+}
+/*---------------------------------------------------------------------------*/
+/* channel of the first step of a flood */
+static inline uint8_t
+op_channel(const native_medium_op_t* op)
+{
+  return op->n_hop_channels ? op->hop_channels[0] : op->rf_channel;
+}
+/*---------------------------------------------------------------------------*/
+static sim_flood_t*
+flood_join(const native_medium_op_t* op, rtimer_ext_clock_t t_tx)
+{
+  sim_flood_t* f;
+  sim_flood_t* oldest = NULL;
+  rtimer_ext_clock_t window = US_TO_HF(NATIVE_SIM_CONF_SYNC_WINDOW);
+
+  for(f = sim->floods; f < sim->floods + NATIVE_SIM_CONF_MAX_FLOODS; f++) {
+    if(f->used && !f->computed && f->primitive == op->primitive &&
+       f->channel == op_channel(op) && f->n_hop == op->n_hop_channels &&
+       ((t_tx >= f->t_tx) ? (t_tx - f->t_tx) : (f->t_tx - t_tx)) <= window) {
+      return f;
+    }
+    if(!oldest || !f->used || (oldest->used && f->t_tx < oldest->t_tx)) {
+      oldest = f;
+    }
+  }
+  /* start a new flood (replaces the oldest one) */
+  f = oldest;
+  f->used      = 1;
+  f->computed  = 0;
+  f->primitive = op->primitive;
+  f->channel   = op_channel(op);
+  f->n_hop     = MIN(op->n_hop_channels, NATIVE_SIM_MAX_HOP_CHANNELS);
+  f->hop       = op->hop_channels;
+  f->with_sync = 0;
+  f->len       = 0;
+  f->n_init    = 0;
+  f->t_tx      = t_tx;
+  f->seq       = sim->flood_seq++;
+  return f;
+}
+/*---------------------------------------------------------------------------*/
+static sim_flood_t*
+flood_find(const sim_node_t* n, rtimer_ext_clock_t t_stop)
+{
+  sim_flood_t* f;
+  sim_flood_t* found = NULL;
+  rtimer_ext_clock_t window = US_TO_HF(NATIVE_SIM_CONF_SYNC_WINDOW);
+
+  for(f = sim->floods; f < sim->floods + NATIVE_SIM_CONF_MAX_FLOODS; f++) {
+    if(f->used && f->primitive == n->primitive && f->channel == n->channel &&
+       f->n_hop == n->n_hop && f->t_tx + window >= n->t_start && f->t_tx < t_stop &&
+       (!found || f->t_tx < found->t_tx)) {
+      found = f;
+    }
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static inline uint8_t
+transmits(const sim_flood_t* f, uint32_t i, int s)
+{
+  int d = s - f->has[i] - 1;
+  return f->has[i] != NO_STEP && d >= 0 && !(d & 1) && (d >> 1) < f->n_tx[i];
+}
+/*---------------------------------------------------------------------------*/
+static inline uint8_t
+listens(const sim_flood_t* f, uint32_t i, int s)
+{
+  int d = s - f->has[i] - 1;
+  return f->has[i] == NO_STEP ||
+         (d > 0 && (d & 1) && (d >> 1) < f->n_tx[i] - 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+flood_add_node(sim_flood_t* f, uint32_t i)
+{
+  const sim_node_t* n = &sim->nodes[i];
+  f->part[i]  = 1;
+  f->n_tx[i]  = n->n_tx;
+  f->has[i]   = NO_STEP;
+  f->start_step[i] = (n->t_start <= f->t_tx) ? 0 :
+                     (int16_t)MIN(MAX_STEPS, (n->t_start - f->t_tx +
+                                              f->t_hop - 1) / f->t_hop);
+}
+/*---------------------------------------------------------------------------*/
+static inline uint8_t
+jammed(const sim_flood_t* f, int s)
+{
+  return f->jammed && (f->jam[s >> 3] & (1 << (s & 7))) &&
+         (!f->n_hop || (f->hop_jam & (1UL << (s % f->n_hop))));
+}
+/*---------------------------------------------------------------------------*/
+/* does the Wi-Fi channel overlap with an IEEE 802.15.4 channel (11 - 26)? */
+static uint8_t
+wifi_overlaps(uint8_t channel)
+{
+  int d = (2405 + 5 * ((int)channel - 11)) -
+          (2407 + 5 * (int)sim->cfg.wifi_channel);
+  return sim->cfg.wifi_channel && (d < 0 ? -d : d) < NATIVE_SIM_WIFI_HALF_BW;
+}
+/*---------------------------------------------------------------------------*/
+/* draw the Wi-Fi activity during a flood: bursts that occupy the channel
+ * wifi_load percent of the time */
+static void
+flood_jam(sim_flood_t* f)
+{
+  uint32_t burst = MAX(1, US_TO_HF(NATIVE_SIM_CONF_WIFI_BURST) / f->t_hop);
+  double   load  = MIN(sim->cfg.wifi_load, 99) / 100.0;
+  double   p     = load / (burst * (1.0 - load));
+  uint32_t left  = 0;
+  int s;
+
+  /* separate PRNG stream, the link losses do not depend on the Wi-Fi */
+  rng_seed((uint64_t)f->seq | (1ULL << 32));
+  memset(f->jam, 0, sizeof(f->jam));
+  /* the flood starts at a random point of a burst or of an idle period */
+  if(rng_uniform() < load) {
+    left = 1 + (uint32_t)(rng_uniform() * burst);
+  }
+  for(s = 0; s < MAX_STEPS; s++) {
+    if(!left && rng_uniform() < p) {
+      left = burst;
+    }
+    if(left) {
+      f->jam[s >> 3] |= (1 << (s & 7));
+      left--;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+flood_compute_strobing(sim_flood_t* f)
+{
+  uint32_t i, j, l;
+  uint8_t n_strobes = 0;
+
+  for(j = 0; j < f->n_init; j++) {
+    n_strobes = MAX(n_strobes, f->n_tx[f->init[j]]);
+  }
+  for(i = 0; i < sim->n; i++) {
+    double p_fail = 1.0;
+    float best_prr = 0;
+    if(!f->part[i] || f->has[i] == -1) {
+      continue;
+    }
+    for(l = sim->in_ofs[i]; l < sim->in_ofs[i + 1]; l++) {
+      for(j = 0; j < f->n_init; j++) {
+        if(sim->in[l].node == f->init[j]) {
+          p_fail *= 1.0 - sim->in[l].prr;
+          if(sim->in[l].prr > best_prr) {
+            best_prr = sim->in[l].prr;
+            f->src[i] = j;
+          }
+        }
+      }
+    }
+    for(j = f->start_step[i]; j < n_strobes; j++) {
+      f->rx_try[i]++;
+      if(rng_uniform() >= p_fail && !jammed(f, j)) {
+        f->rx_cnt[i]++;
+        if(f->has[i] == NO_STEP) {
+          f->has[i] = j;
+        }
+      }
+    }
+  }
+  f->n_steps = n_strobes;
+}
+/*---------------------------------------------------------------------------*/
+static void
+flood_compute(sim_flood_t* f)
+{
+  uint32_t i, l, n_active = 0, n_touched;
+  int s;
+
+  f->computed = 1;
+  f->t_hop = US_TO_HF(NATIVE_SIM_CONF_T_HOP(f->len) +
+                     (f->n_hop ? NATIVE_SIM_CONF_T_CH_SWITCH : 0));
+  sim->round.floods++;
+  f->hop_jam = 0;
+  for(i = 0; i < f->n_hop; i++) {
+    if(wifi_overlaps(f->hop[i])) {
+      f->hop_jam |= (1UL << i);
+    }
+  }
+  f->jammed = f->n_hop ? (f->hop_jam != 0) : wifi_overlaps(f->channel);
+  if(f->jammed) {
+    flood_jam(f);
+  }
+  rng_seed(f->seq);
+
+  memset(f->part, 0, sim->n);
+  memset(f->rx_cnt, 0, sim->n);
+  memset(f->rx_try, 0, sim->n);
+  for(i = 0; i < sim->n; i++) {
+    const sim_node_t* n = &sim->nodes[i];
+    f->has[i] = NO_STEP;
+    if(n->listening && n->primitive == f->primitive &&
+       n->channel == f->channel && n->n_hop == f->n_hop) {
+      flood_add_node(f, i);
+    }
+  }
+  for(i = 0; i < f->n_init; i++) {
+    uint32_t k = f->init[i];
+    flood_add_node(f, k);
+    f->has[k] = -1;
+    f->src[k] = i;
+    f->start_step[k] = 0;
+    sim->active[n_active++] = k;
+  }
+  if(f->primitive == NATIVE_MEDIUM_STROBING) {
+    flood_compute_strobing(f);
+    return;
+  }
+
+  for(s = 0; n_active && s < MAX_STEPS; s++) {
+    n_touched = 0;
+    for(i = 0; i < n_active; i++) {
+      uint32_t t = sim->active[i];
+      if(!transmits(f, t, s)) {
+        continue;
+      }
+      for(l = sim->out_ofs[t]; l < sim->out_ofs[t + 1]; l++) {
+        uint32_t r = sim->out[l].node;
+        if(!f->part[r] || s < f->start_step[r] || !listens(f, r, s)) {
+          continue;
+        }
+        if(sim->fail[r] == 1.0) {
+          sim->touched[n_touched++] = r;
+          sim->best_prr[r] = 0;
+        }
+        sim->fail[r] *= 1.0 - sim->out[l].prr;
+        if(sim->out[l].prr > sim->best_prr[r]) {
+          sim->best_prr[r] = sim->out[l].prr;
+          sim->best[r] = t;
+        }
+      }
+    }
+    for(i = 0; i < n_touched; i++) {
+      uint32_t r = sim->touched[i];
+      f->rx_try[r]++;
+      if(rng_uniform() >= sim->fail[r] && !jammed(f, s)) {
+        f->rx_cnt[r]++;
+        if(f->has[r] == NO_STEP) {
+          f->has[r] = s;
+          f->src[r] = f->src[sim->best[r]];
+          sim->active[n_active++] = r;
+        }
+      }
+      sim->fail[r] = 1.0;
+    }
+    /* remove the nodes that are done */
+    for(i = 0; i < n_active; ) {
+      uint32_t a = sim->active[i];
+      if(s >= f->has[a] + 2 * f->n_tx[a] - 1) {
+        sim->active[i] = sim->active[--n_active];
+      } else {
+        i++;
+      }
+    }
+  }
+  f->n_steps = s;
+}
+/*---------------------------------------------------------------------------*/
+/* a node that turned on its radio after the flood has been computed can
+ * still receive the packet, but does not relay it */
+static void
+flood_add_late(sim_flood_t* f, uint32_t k)
+{
+  int s;
+  uint32_t l;
+
+  flood_add_node(f, k);
+  for(s = f->start_step[k]; s < f->n_steps; s++) {
+    double p_fail = 1.0;
+    float best_prr = 0;
+    for(l = sim->in_ofs[k]; l < sim->in_ofs[k + 1]; l++) {
+      uint32_t t = sim->in[l].node;
+      if(f->part[t] && (f->primitive == NATIVE_MEDIUM_GLOSSY ?
+                        transmits(f, t, s) :
+                        (f->has[t] == -1 && s < f->n_tx[t]))) {
+        p_fail *= 1.0 - sim->in[l].prr;
+        if(sim->in[l].prr > best_prr) {
+          best_prr = sim->in[l].prr;
+          f->src[k] = f->src[t];
+        }
+      }
+    }
+    if(p_fail < 1.0) {
+      f->rx_try[k]++;
+      if(rng_uniform() >= p_fail && !jammed(f, s)) {
+        f->rx_cnt[k]++;
+        if(f->has[k] == NO_STEP) {
+          f->has[k] = s;
+          if(f->primitive == NATIVE_MEDIUM_GLOSSY) {
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+medium_start(native_medium_op_t* op)
+{
+  sim_node_t* n = &sim->nodes[sim->cur];
+  rtimer_ext_clock_t ofs = local_ofs();
+
+  n->listening = 1;
+  n->primitive = op->primitive;
+  n->channel   = op_channel(op);
+  n->n_hop     = MIN(op->n_hop_channels, NATIVE_SIM_MAX_HOP_CHANNELS);
+  n->n_tx      = op->n_tx_max;
+  n->t_start   = op->t_start * RTIMER_EXT_HF_LF_RATIO + ofs;
+  n->flood     = -1;
+
+  if(op->is_initiator) {
+    sim_flood_t* f = flood_join(op, op->t_tx * RTIMER_EXT_HF_LF_RATIO + ofs);
+    if(f->n_init < NATIVE_SIM_CONF_MAX_INITIATORS) {
+      uint8_t len = MIN(op->payload_len, NATIVE_SIM_CONF_MAX_PKT_LEN);
+      f->init[f->n_init] = sim->cur;
+      f->payload_len[f->n_init] = len;
+      if(op->payload) {
+        memcpy(f->payload[f->n_init], op->payload, len);
+      }
+      f->n_init++;
+      f->len = MAX(f->len, len);
+      n->flood = f - sim->floods;
+    }
+    if(op->with_sync && op->primitive == NATIVE_MEDIUM_GLOSSY) {
+      f->with_sync = 1;
+      /* a flood with sync marks the start of a new round */
+      if(f->n_init == 1) {
+        round_close();
+        sim->round_cnt++;
+        sim->round_start = f->t_tx;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+medium_stop(native_medium_op_t* op)
+{
+  uint32_t k = sim->cur;
+  sim_node_t* n = &sim->nodes[k];
+  rtimer_ext_clock_t t_stop = op->t_stop * RTIMER_EXT_HF_LF_RATIO +
+                              local_ofs();
+  sim_flood_t* f = (n->flood >= 0) ? &sim->floods[n->flood] :
+                                     flood_find(n, t_stop);
+  if(f) {
+    if(!f->computed) {
+      flood_compute(f);
+    } else if(!f->part[k]) {
+      flood_add_late(f, k);
+    }
+    op->rx_try_cnt = f->rx_try[k];
+    if(f->has[k] == -1) {
+      /* initiator: radio off after the last transmission */
+      op->rx_cnt   = f->rx_cnt[k];
+      op->t_rf_off = to_local_lf(f->t_tx + f->t_hop *
+                                 (f->primitive == NATIVE_MEDIUM_GLOSSY ?
+                                  (2 * f->n_tx[k] - 1) : f->n_tx[k]));
+    } else {
+      uint8_t rcvd = (f->has[k] != NO_STEP &&
+                      f->t_tx + f->has[k] * f->t_hop < t_stop);
+      sim->round.expected++;
+      sim->round.ctrl_expected += f->with_sync;
+      if(rcvd) {
+        uint8_t src = f->src[k];
+        sim->round.delivered++;
+        sim->round.ctrl_delivered += f->with_sync;
+        op->rx_cnt       = f->rx_cnt[k];
+        op->relay_cnt    = f->has[k];
+        op->payload_len  = f->payload_len[src];
+        if(op->payload) {
+          memcpy(op->payload, f->payload[src], f->payload_len[src]);
+        }
+        if(f->primitive == NATIVE_MEDIUM_GLOSSY) {
+          op->t_ref_updated = f->with_sync;
+          op->t_ref    = to_local_lf(f->t_tx);
+          op->t_rf_off = to_local_lf(f->t_tx + f->t_hop *
+                                     (f->has[k] + 2 * f->n_tx[k]));
+        }
+      }
+    }
+  }
+  n->listening = 0;
+
+  if(op->t_rf_off && op->t_rf_off < op->t_stop) {
+    sim->round.rf_on += (op->t_rf_off > op->t_start) ?
+                        (op->t_rf_off - op->t_start) : 0;
+  } else {
+    sim->round.rf_on += op->t_stop - op->t_start;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const native_medium_t sim_medium = { medium_start, medium_stop };
+/*---------------------------------------------------------------------------*/
+/*------------------------------ Interface ----------------------------------*/
+/*---------------------------------------------------------------------------*/
+void
+native_sim_init(const native_sim_cfg_t* cfg, int argc, char** argv)
+{
+  struct sigaction sa;
+  uint32_t i;
+
+  sim = sim_alloc(sizeof(native_sim_t));
+  sim->cfg  = *cfg;
+  sim->argc = argc;
+  sim->argv = argv;
+  if(!sim->cfg.lq_strobes) {
+    sim->cfg.lq_strobes = NATIVE_SIM_CONF_LQ_STROBES;
+  }
+
+  if(cfg->link_file) {
+    load_link_file(cfg->link_file);
+  } else {
+    create_grid(cfg->num_nodes);
+  }
+  build_topology();
+
+  sim->queue   = sim_alloc(sim->n * sizeof(sim_event_t));
+  sim->fail    = sim_alloc(sim->n * sizeof(double));
+  sim->best    = sim_alloc(sim->n * sizeof(uint32_t));
+  sim->best_prr = sim_alloc(sim->n * sizeof(float));
+  sim->touched = sim_alloc(sim->n * sizeof(uint32_t));
+  sim->active  = sim_alloc(sim->n * sizeof(uint32_t));
+  for(i = 0; i < sim->n; i++) {
+    sim->fail[i] = 1.0;
+  }
+  for(i = 0; i < NATIVE_SIM_CONF_MAX_FLOODS; i++) {
+    sim_flood_t* f = &sim->floods[i];
+    f->has        = sim_alloc(sim->n * sizeof(int16_t));
+    f->start_step = sim_alloc(sim->n * sizeof(int16_t));
+    f->part       = sim_alloc(sim->n);
+    f->n_tx       = sim_alloc(sim->n);
+    f->rx_cnt     = sim_alloc(sim->n);
+    f->rx_try     = sim_alloc(sim->n);
+    f->src        = sim_alloc(sim->n);
+  }
+  sim->min_rel = 1.0;
+
+  /* output: the report goes to the original stdout, the output of the nodes
+   * is discarded unless selected */
+  fflush(stdout);
+  sim->fd_stdout = dup(STDOUT_FILENO);
+  sim->fd_null   = open("/dev/null", O_WRONLY);
+  sim->report    = fdopen(dup(STDOUT_FILENO), "w");
+  sim->stdout_on = 1;
+  set_output(0);
+
+  fprintf(sim->report, "sim: %u nodes, %u links\n", sim->n, sim->n_links);
+  if(sim->cfg.wifi_channel) {
+    fprintf(sim->report, "sim: Wi-Fi interference on channel %u (%u%% load)\n",
+            sim->cfg.wifi_channel, sim->cfg.wifi_load);
+  }
+  if(sim->cfg.max_drift) {
+    fprintf(sim->report, "sim: clock drift up to +/-%u ppm\n",
+            sim->cfg.max_drift);
+  }
+
+  /* the current memory content is the initial image of all nodes */
+  sim->image_size = _end - __data_start;
+  sim->page_size  = sysconf(_SC_PAGESIZE);
+  sim->n_pages    = (((uintptr_t)_end - 1) / sim->page_size) -
+                    ((uintptr_t)__data_start / sim->page_size) + 1;
+  sim->pristine   = sim_alloc(sim->image_size);
+  sim->images     = sim_alloc(sim->image_size * sim->n);
+  sim->dirty      = sim_alloc((size_t)sim->n_pages * sim->n);
+  memcpy(sim->pristine, __data_start, sim->image_size);
+  /* from now on, detect the pages that node 0 writes */
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = on_segv;
+  sa.sa_flags     = SA_SIGINFO;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGSEGV, &sa, NULL);
+  if(sim->n_pages > 2) {
+    mprotect(page_addr(1), (sim->n_pages - 2) * sim->page_size, PROT_READ);
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+native_sim_active(void)
+{
+  return (sim != NULL);
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_init_node(void)
+{
+  node_id = sim->nodes[sim->cur].id;
+  if(sim->cfg.max_drift) {
+    rtimer_ext_native_set_drift((int32_t)((2.0 * rng_uniform() - 1.0) *
+                                          sim->cfg.max_drift * 1000));
+  }
+  native_medium_set(&sim_medium);
+}
+/*---------------------------------------------------------------------------*/
+static double
+wall_time(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_main_loop(void)
+{
+  rtimer_ext_clock_t t_end = (rtimer_ext_clock_t)sim->cfg.run_time *
+                             RTIMER_EXT_SECOND_HF;
+  rtimer_ext_clock_t t_now = 0;
+  double t_boot, t_run;
+  uint32_t i;
+
+  if(sim->booting) {
+    /* called from main() while booting a node, return to the simulator */
+    while(process_run() > 0);
+    return;
+  }
+
+  /* node 0 has been booted by the initial call to main() */
+  t_boot = wall_time();
+  run_node();
+  sim->loaded = 0;
+  sim->booting = 1;
+  for(i = 1; i < sim->n; i++) {
+    swap_image(i);    /* no pages written yet: loads the initial image */
+    sim->cur    = i;
+    set_output(i);
+    main(sim->argc, sim->argv);
+    run_node();
+  }
+  sim->booting = 0;
+  t_boot = wall_time() - t_boot;
+
+  /* discrete-event loop */
+  t_run = wall_time();
+  while(sim->queue_len) {
+    sim_event_t ev = queue_pop();
+    if(t_end && ev.t > t_end) {
+      break;
+    }
+    t_now = ev.t;
+    switch_to(ev.node);
+    rtimer_ext_native_run(ev.t);
+    run_node();
+    sim->events++;
+  }
+  t_run = wall_time() - t_run;
+  if(t_end) {
+    t_now = t_end;
+  }
+  round_close();
+
+  fflush(stdout);
+  fprintf(sim->report,
+          "sim: memory image %lu bytes/node, %.0f bytes copied per switch, "
+          "boot time %.3fs\n"
+          "sim: %u rounds, %u floods, reliability %.2f%% (min. round %.2f%%), "
+          "control %.2f%%, data %.2f%%\n"
+          "sim: radio-on %.3fms/node/round, duty cycle %.3f%%\n"
+          "sim: %.1fs of network time in %.3fs (%.0fx real time), "
+          "%lu events (%.0f/s)\n",
+          (unsigned long)sim->image_size,
+          sim->swaps ? ((double)sim->swapped / sim->swaps) : 0.0, t_boot,
+          sim->round_cnt, sim->total.floods,
+          sim->total.expected ?
+          (100.0 * sim->total.delivered / sim->total.expected) : 100.0,
+          100.0 * sim->min_rel,
+          sim->total.ctrl_expected ?
+          (100.0 * sim->total.ctrl_delivered / sim->total.ctrl_expected) :
+          100.0,
+          (sim->total.expected > sim->total.ctrl_expected) ?
+          (100.0 * (sim->total.delivered - sim->total.ctrl_delivered) /
+           (sim->total.expected - sim->total.ctrl_expected)) : 100.0,
+          sim->round_cnt ?
+          (LF_TO_MS(sim->total.rf_on) / sim->n / sim->round_cnt) : 0,
+          t_now ? (100.0 * LF_TO_MS(sim->total.rf_on) / sim->n /
+                   HF_TO_MS(t_now)) : 0,
+          HF_TO_MS(t_now) / 1000.0, t_run,
+          t_run > 0 ? (HF_TO_MS(t_now) / 1000.0 / t_run) : 0,
+          (unsigned long)sim->events,
+          t_run > 0 ? (sim->events / t_run) : 0);
+  fflush(sim->report);
+}
+/*---------------------------------------------------------------------------*/
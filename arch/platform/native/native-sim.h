@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *
+ * Multi-node network simulator of the native platform.
+ *
+ * Runs many instances of the same firmware in one process: each node owns a
+ * copy of the writable memory (.data and .bss) of the program, which is
+ * swapped in before the node executes. The nodes are scheduled by a
+ * discrete-event loop in the order of their next timer expiration, and all
+ * floods go through a shared virtual medium (see native-medium.h) that
+ * models the reception of Glossy and strobing packets based on a
+ * link-quality matrix.
+ *
+ * The simulation is fully deterministic: host CPU time is not accounted and
+ * all random decisions are drawn from a seeded PRNG.
+ */
+
+#ifndef NATIVE_SIM_H_
+#define NATIVE_SIM_H_
+
+#include "contiki.h"
+
+/* max. number of floods that are kept in memory at the same time */
+#ifndef NATIVE_SIM_CONF_MAX_FLOODS
+#define NATIVE_SIM_CONF_MAX_FLOODS      16
+#endif /* NATIVE_SIM_CONF_MAX_FLOODS */
+
+/* max. number of concurrent initiators of one flood (contention slots) */
+#ifndef NATIVE_SIM_CONF_MAX_INITIATORS
+#define NATIVE_SIM_CONF_MAX_INITIATORS  8
+#endif /* NATIVE_SIM_CONF_MAX_INITIATORS */
+
+/* max. packet length in bytes */
+#ifndef NATIVE_SIM_CONF_MAX_PKT_LEN
+#define NATIVE_SIM_CONF_MAX_PKT_LEN     128
+#endif /* NATIVE_SIM_CONF_MAX_PKT_LEN */
+
+/* duration of one Glossy hop (packet transmission incl. turnaround) in us
+ * for a payload of 'len' bytes; default: cc2420 (250 kbps, 5 bytes overhead) */
+#ifndef NATIVE_SIM_CONF_T_HOP
+#define NATIVE_SIM_CONF_T_HOP(len)      (3 + 24 + 192 + 192 + ((len) + 5) * 32)
+#endif /* NATIVE_SIM_CONF_T_HOP */
+
+/* additional duration of one hop in us if the channel is switched after each
+ * hop (in-flood channel hopping), as in robust Glossy on the sky platform */
+#ifndef NATIVE_SIM_CONF_T_CH_SWITCH
+#define NATIVE_SIM_CONF_T_CH_SWITCH     81
+#endif /* NATIVE_SIM_CONF_T_CH_SWITCH */
+
+/* max. number of channels of an in-flood hopping sequence */
+#define NATIVE_SIM_MAX_HOP_CHANNELS     32
+
+/* transmissions that start within this window (in us) belong to the same
+ * flood (concurrent initiators) */
+#ifndef NATIVE_SIM_CONF_SYNC_WINDOW
+#define NATIVE_SIM_CONF_SYNC_WINDOW     100
+#endif /* NATIVE_SIM_CONF_SYNC_WINDOW */
+
+/* duration of a Wi-Fi burst in us (-w) */
+#ifndef NATIVE_SIM_CONF_WIFI_BURST
+#define NATIVE_SIM_CONF_WIFI_BURST      2000
+#endif /* NATIVE_SIM_CONF_WIFI_BURST */
+
+/* default Wi-Fi channel load in percent (-w) */
+#ifndef NATIVE_SIM_CONF_WIFI_LOAD
+#define NATIVE_SIM_CONF_WIFI_LOAD       50
+#endif /* NATIVE_SIM_CONF_WIFI_LOAD */
+
+/* a Wi-Fi channel overlaps with all IEEE 802.15.4 channels whose center
+ * frequency is less than this many MHz away */
+#define NATIVE_SIM_WIFI_HALF_BW         12
+
+/* number of strobes per link in the output of baloo-link-quality-test */
+#ifndef NATIVE_SIM_CONF_LQ_STROBES
+#define NATIVE_SIM_CONF_LQ_STROBES      100
+#endif /* NATIVE_SIM_CONF_LQ_STROBES */
+
+#define NATIVE_SIM_OUTPUT_NONE          0xffff  /* hide all node output */
+#define NATIVE_SIM_OUTPUT_ALL           0       /* show output of all nodes */
+
+/**
+ * @brief simulation parameters
+ */
+typedef struct {
+  const char* link_file;    /* link-quality matrix, NULL = synthetic grid */
+  uint32_t    num_nodes;    /* number of nodes in the synthetic grid */
+  uint16_t    lq_strobes;   /* strobes per link in the link-quality logs */
+  uint32_t    seed;         /* seed of the PRNG of the medium */
+  uint32_t    run_time;     /* network time to simulate in seconds */
+  uint16_t    output_node;  /* show the output of this node only */
+  uint8_t     print_rounds; /* print the statistics of each round */
+  uint8_t     wifi_channel; /* Wi-Fi interference on this channel, 0 = off */
+  uint8_t     wifi_load;    /* Wi-Fi channel load in percent */
+  uint16_t    max_drift;    /* clock drift of each node drawn uniformly from
+                               [-max_drift, max_drift] ppm, 0 = ideal */
+} native_sim_cfg_t;
+
+/**
+ * @brief set up the simulation (load the topology and allocate the node
+ * memory images)
+ * @note must be called before the Contiki system is initialized, the memory
+ * of the program at this point is used as the initial image for all nodes
+ */
+void native_sim_init(const native_sim_cfg_t* cfg, int argc, char** argv);
+
+/**
+ * @brief check whether the program runs as a simulation
+ */
+uint8_t native_sim_active(void);
+
+/**
+ * @brief initialize the node that is currently being booted (sets node_id,
+ * the clock drift and attaches the virtual medium)
+ */
+void native_sim_init_node(void);
+
+/**
+ * @brief run the simulation
+ * @note called from platform_main_loop(); boots all nodes, executes the
+ * discrete-event loop and prints the statistics
+ */
+void native_sim_main_loop(void);
+
+#endif /* NATIVE_SIM_H_ */
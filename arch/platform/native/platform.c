@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Native platform: runs a single node as a Linux process, or a
+ *         whole network in the discrete-event simulator (see native-sim.c).
+ *
+ * The main loop executes all pending Contiki processes and then advances the
+ * virtual clock to the next timer expiration, i.e. the simulated time runs
+ * as fast as the host can process the events. At the end of the run (after
+ * the virtual time given with -t has elapsed), a summary of the consumed
+ * host resources is printed.
+ */
+/*---------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "sys/platform.h"
+#include "random.h"
+#include "node-id.h"
+#include "net/linkaddr.h"
+#include "rtimer-ext.h"
+#include "native-medium.h"
+#include "native-sim.h"
+/*---------------------------------------------------------------------------*/
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "Native"
+#define LOG_LEVEL LOG_LEVEL_MAIN
+/*---------------------------------------------------------------------------*/
+#ifndef NODE_ID
+#define NODE_ID         1
+#endif /* NODE_ID */
+
+/* default run time in seconds of virtual time (0 = infinite) */
+#ifndef NATIVE_CONF_RUN_TIME
+#define NATIVE_CONF_RUN_TIME    60
+#endif /* NATIVE_CONF_RUN_TIME */
+/*---------------------------------------------------------------------------*/
+static uint16_t arg_node_id = NODE_ID;
+static uint32_t arg_run_time = NATIVE_CONF_RUN_TIME;
+static uint8_t  arg_deterministic = 0;
+static native_sim_cfg_t sim_cfg = { .output_node = NATIVE_SIM_OUTPUT_NONE };
+/*---------------------------------------------------------------------------*/
+static uint64_t
+host_wall_time_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_summary(uint64_t wall_time_ns)
+{
+  const rtimer_ext_native_stats_t* s = rtimer_ext_native_get_stats();
+  uint64_t virt_us = rtimer_ext_native_time() * 1000000ULL /
+                     RTIMER_EXT_SECOND_HF;
+  uint64_t wall_us = wall_time_ns / 1000;
+  uint64_t rf_on_us = native_medium_get_rf_on_time() * 1000000ULL /
+                      RTIMER_EXT_SECOND_LF;
+  uint64_t cpu_us = s->cpu_time * 1000000ULL / RTIMER_EXT_SECOND_HF;
+  uint64_t lat_max_us = s->latency_max * 1000000ULL / RTIMER_EXT_SECOND_HF;
+  uint64_t lat_avg_us = 0;
+  if(s->late_cnt) {
+    lat_avg_us = s->latency_sum * 1000000ULL / RTIMER_EXT_SECOND_HF /
+                 s->late_cnt;
+  }
+
+  printf("native: virtual time %" PRIu64 "ms, wall time %" PRIu64 "us, "
+         "speed-up %" PRIu64 "x\n",
+         virt_us / 1000, wall_us, wall_us ? (virt_us / wall_us) : 0);
+  printf("native: %" PRIu32 " timer callbacks, %" PRIu32 " late, "
+         "max. latency %" PRIu64 "us, avg. latency %" PRIu64 "us\n",
+         s->dispatch_cnt, s->late_cnt, lat_max_us, lat_avg_us);
+  printf("native: CPU time %" PRIu64 "us, radio-on time %" PRIu64 "us\n",
+         cpu_us, rf_on_us);
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_process_args(int argc, char** argv)
+{
+  int opt;
+
+  /* main() is called again for each simulated node */
+  if(native_sim_active()) {
+    return;
+  }
+  while((opt = getopt(argc, argv, "n:t:dN:l:S:s:v:rw:D:")) != -1) {
+    switch(opt) {
+    case 'n':
+      arg_node_id = (uint16_t)strtoul(optarg, NULL, 0);
+      break;
+    case 't':
+      arg_run_time = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'd':
+      arg_deterministic = 1;
+      break;
+    case 'N':
+      sim_cfg.num_nodes = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'l':
+      sim_cfg.link_file = optarg;
+      break;
+    case 'S':
+      sim_cfg.lq_strobes = (uint16_t)strtoul(optarg, NULL, 0);
+      break;
+    case 's':
+      sim_cfg.seed = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'v':
+      sim_cfg.output_node = (uint16_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      sim_cfg.print_rounds = 1;
+      break;
+    case 'D':
+      sim_cfg.max_drift = (uint16_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'w': {
+      char* end;
+      sim_cfg.wifi_channel = (uint8_t)strtoul(optarg, &end, 0);
+      sim_cfg.wifi_load    = (*end == ':') ?
+                             (uint8_t)strtoul(end + 1, NULL, 0) :
+                             NATIVE_SIM_CONF_WIFI_LOAD;
+      break;
+    }
+    default:
+      fprintf(stderr, "usage: %s [-n node id] [-t virtual time in s] [-d]\n"
+                      "       %s [-N num nodes | -l link file] [-S strobes] "
+                      "[-s seed] [-v node id] [-r] [-w wifi ch[:load]]\n"
+                      "       [-D max. drift in ppm] [-t virtual time in s]\n"
+                      "  -d  deterministic mode (don't add host CPU time "
+                      "to the virtual clock)\n"
+                      "  -N  simulate a grid network with N nodes\n"
+                      "  -l  simulate the network given by a link-quality "
+                      "file ('tx rx prr' or\n"
+                      "      the output of baloo-link-quality-test)\n"
+                      "  -S  number of strobes per link-quality test "
+                      "(default %u)\n"
+                      "  -s  seed of the simulated link losses\n"
+                      "  -v  show the output of one node (0 = all nodes)\n"
+                      "  -r  print the statistics of each round\n"
+                      "  -w  Wi-Fi interference on the given channel (1-13), "
+                      "busy 'load' percent\n"
+                      "      of the time (default %u)\n"
+                      "  -D  clock drift of each node, uniformly distributed "
+                      "within +/- the given ppm\n",
+                      argv[0], argv[0], NATIVE_SIM_CONF_LQ_STROBES,
+                      NATIVE_SIM_CONF_WIFI_LOAD);
+      exit(EXIT_FAILURE);
+    }
+  }
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  if(sim_cfg.num_nodes || sim_cfg.link_file) {
+    /* must be the last step, takes the initial memory image of all nodes */
+    sim_cfg.run_time = arg_run_time;
+    native_sim_init(&sim_cfg, argc, argv);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_init_stage_one(void)
+{
+  rtimer_ext_init();
+  /* the simulator is always deterministic */
+  rtimer_ext_native_set_cpu_time(!arg_deterministic && !native_sim_active());
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_init_stage_two(void)
+{
+  if(native_sim_active()) {
+    native_sim_init_node();
+  } else {
+    node_id = arg_node_id;
+  }
+  linkaddr_node_addr.u8[0] = node_id & 0xff;
+  linkaddr_node_addr.u8[1] = node_id >> 8;
+  random_init(node_id);
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_init_stage_three(void)
+{
+  LOG_INFO("Node started. Node ID is set to %u. Platform native\n", node_id);
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_idle(void)
+{
+  /* nothing to do, the main loop advances the virtual time */
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_main_loop(void)
+{
+  rtimer_ext_clock_t t_end = (rtimer_ext_clock_t)arg_run_time *
+                             RTIMER_EXT_SECOND_HF;
+  uint64_t t_wall;
+
+  if(native_sim_active()) {
+    native_sim_main_loop();
+    return;
+  }
+  t_wall = host_wall_time_ns();
+  while(1) {
+    rtimer_ext_clock_t next;
+    while(process_run() > 0);
+    if(!rtimer_ext_native_next_expiration(&next)) {
+      LOG_WARN("no pending events, stopping\n");
+      break;
+    }
+    if(arg_run_time && next > t_end) {
+      rtimer_ext_native_run(t_end);
+      break;
+    }
+    rtimer_ext_native_run(next);
+  }
+  print_summary(host_wall_time_ns() - t_wall);
+}
+/*---------------------------------------------------------------------------*/
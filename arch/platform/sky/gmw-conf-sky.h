@@ -76,6 +76,12 @@
 #define GMW_CONF_RF_TX_CHANNEL          GMW_RF_TX_CHANNEL_2480_MHz
 #endif /* GMW_CONF_RF_TX_CHANNEL */
 
+/* all 16 channels, successive entries are at least 25 MHz apart */
+#ifndef GMW_CONF_HOPPING_CHANNELS
+#define GMW_CONF_HOPPING_CHANNELS       11, 16, 21, 26, 12, 17, 22, 13, \
+                                        18, 23, 14, 19, 24, 15, 20, 25
+#endif /* GMW_CONF_HOPPING_CHANNELS */
+
 #define GMW_CONF_RF_TX_BITRATE          250000 /* kbps */
 #ifndef GMW_CONF_T_REF_OFS
 #define GMW_CONF_T_REF_OFS              (GLOSSY_CONF_SETUPTIME_WITH_SYNC + 420LU)    /* us */
@@ -113,6 +119,9 @@
   #define GMW_PRIM_GLOSSY            0
   #define GMW_PRIM_CHAOS             1
   #define GMW_PRIM_STROBING          2
+  /* no GMW_PRIM_GLOSSY_HOPPING (GMW_IN_FLOOD_HOPPING is not supported):
+   * dev/robust-glossy.c implements the same functions as dev/glossy.c and
+   * can only replace it, not be registered as an additional primitive */
 
   #if GMW_PRIM1_ENABLE
   #define GMW_START_PRIM1(initiator_id, payload, payload_len, n_tx_max, sync, rf_cal) chaos_start(payload, payload_len, (initiator_id == node_id), n_tx_max, rf_cal)
@@ -102,6 +102,9 @@ static uint16_t     sent_ack            = 0;
 static uint16_t     RF_DC               = 0;
 static uint8_t      first_reset         = 0;
 rtimer_ext_clock_t  stat_resettime      = 0;
+#ifdef PLATFORM_NATIVE
+static rtimer_ext_clock_t stat_rf_on_time = 0;
+#endif /* PLATFORM_NATIVE */
 
 
 /* Packet buffer */
@@ -140,6 +143,10 @@ channels 0 and 10 are used by other networks */
 static uint8_t      channel_array[] = {1,2,3,4,
                                        5,6,7,8,9
                                        };  /* Available channels to hop */
+#elif defined PLATFORM_NATIVE
+static uint8_t      channel_array[] = {11,12,13,14,15,
+                                       16,17,18,19,20,
+                                       21,22,23,24,26};   /*Available channels to hop */
 #endif
 /*---------------------------------------------------------------------------*/
 
@@ -211,6 +218,19 @@ PROCESS_THREAD(app_process, ev, data)
       DCSTAT_RESET;
       first_reset = 1;
     }
+#elif defined PLATFORM_NATIVE
+
+    /* radio-on time as accounted by the virtual medium */
+    RF_DC = (native_medium_get_rf_on_time() - stat_rf_on_time) * 10000 /
+            (rtimer_ext_now_lf() - stat_resettime);
+    DEBUG_PRINT_INFO("Radio DC: %u.%02u", RF_DC/100, RF_DC%100);
+    if(!first_reset) {
+
+      /* Reset stats when you bootstrap the first time */
+      stat_rf_on_time = native_medium_get_rf_on_time();
+      stat_resettime = rtimer_ext_now_lf();
+      first_reset = 1;
+    }
 #endif /* ENERGEST_CONF_ON */
 
     /* poll the debug-print task, this will output
@@ -245,7 +265,7 @@ host_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-host_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
+host_on_slot_pre_callback(uint16_t slot_index, uint16_t slot_assignee,
               uint8_t* out_len, uint8_t* out_payload,
               uint8_t is_initiator, uint8_t is_contention_slot)
 {
@@ -291,7 +311,7 @@ host_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-host_on_slot_post_callback(uint8_t slot_index, uint16_t slot_assignee,
+host_on_slot_post_callback(uint16_t slot_index, uint16_t slot_assignee,
                uint8_t len, uint8_t* payload,
                uint8_t is_initiator, uint8_t is_contention_slot,
                gmw_pkt_event_t event)
@@ -394,7 +414,7 @@ host_on_round_finished(gmw_pre_post_processes_t* in_out_pre_post_processes)
     DEBUG_PRINT_INFO("Received %u out of %u packets. PRR: %lu",
                      received_packets,
                      expected_packets,
-                     (uint32_t) 10000LU*received_packets/expected_packets);
+                     (unsigned long) 10000LU*received_packets/expected_packets);
 
     /* Set the radio channel for the next control packet */
     rf_channel = get_channel_epoch(epoch + 1);
@@ -483,7 +503,7 @@ src_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-src_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
+src_on_slot_pre_callback(uint16_t slot_index, uint16_t slot_assignee,
              uint8_t* out_len, uint8_t* out_payload,
              uint8_t is_initiator, uint8_t is_contention_slot)
 {
@@ -518,7 +538,7 @@ src_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-src_on_slot_post_callback(uint8_t slot_index, uint16_t slot_assignee,
+src_on_slot_post_callback(uint16_t slot_index, uint16_t slot_assignee,
               uint8_t len, uint8_t* payload,
               uint8_t is_initiator, uint8_t is_contention_slot,
               gmw_pkt_event_t event)
@@ -724,7 +744,9 @@ app_control_init(gmw_control_t* control)
   /* Config */
   GMW_CONTROL_SET_CONFIG(control);
   control->config.n_retransmissions = 0; /* Specified in the slot config */
-  control->config.channel_hopping_mode = GMW_PER_SLOT_HOPPING;
+  /* Crystal hops the channel itself (based on the epoch counter, which also
+   * advances if the control packet is missed) */
+  control->config.channel_hopping_mode = GMW_NO_HOPPING;
   control->config.gap_time  = GMW_US_TO_GAP_TIME(GMW_CONF_T_GAP);
   control->config.slot_time = GMW_US_TO_SLOT_TIME(GMW_CONF_T_DATA);
 
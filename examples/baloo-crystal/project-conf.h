@@ -99,6 +99,11 @@
 
   #endif /* FLOCKLAB */
 
+#elif defined PLATFORM_NATIVE
+
+  /* radio configuration */
+  #define GMW_CONF_RF_TX_CHANNEL        GMW_RF_TX_CHANNEL_2480_MHz
+
 #else
   #error "unknown target platform"
 #endif
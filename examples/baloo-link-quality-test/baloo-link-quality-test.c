@@ -390,7 +390,7 @@ on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
+on_slot_pre_callback(uint16_t slot_index, uint16_t slot_assignee,
                          uint8_t* out_len, uint8_t* out_payload,
                          uint8_t is_initiator, uint8_t is_contention_slot)
 {
@@ -407,7 +407,7 @@ on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-on_slot_post_callback(uint8_t   slot_index,
+on_slot_post_callback(uint16_t  slot_index,
                       uint16_t  slot_assignee,
                       uint8_t   len,
                       uint8_t*  payload,
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark of the host side of the LWB scheduler
+ *
+ *         For 30, 300 and 3000 streams (one per source node), the streams
+ *         are registered and BENCH_ROUNDS schedules are computed. Before each
+ *         computation, the host is fed one received data packet for each
+ *         data slot of the previous schedule, as in the main round. The
+ *         average host CPU time of lwb_sched_compute() is printed; it should
+ *         grow linearly with the number of streams.
+ *
+ *         Run with: ./baloo-lwb-sched-bench.native -d
+ */
+
+/*---------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lwb/gmw-lwb.h"
+/*---------------------------------------------------------------------------*/
+#define FIRST_SOURCE_ID     (HOST_ID + 1)
+/*---------------------------------------------------------------------------*/
+static const uint16_t       bench_n_streams[] = { 30, 300, 3000 };
+static lwb_schedule_t       sched;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+host_cpu_time_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_bench(uint16_t n_streams)
+{
+  lwb_stream_req_t req;
+  lwb_stream_ack_t sack;
+  uint64_t         t_sum = 0;
+  uint16_t         n_data_slots = 0;
+  uint16_t         i, j;
+
+  lwb_sched_init(&sched);
+
+  /* register the streams, discard the S-ACKs */
+  memset(&req, 0, sizeof(req));
+  req.header.recipient_id = HOST_ID;
+  req.header.type         = LWB_PACKET_TYPE_REQ;
+  req.ipi                 = BENCH_IPI;
+  for(i = 0; i < n_streams; i++) {
+    req.sender_id = FIRST_SOURCE_ID + i;
+    lwb_sched_process_stream_req(&req);
+    while(lwb_sched_prepare_sack(&sack));
+  }
+
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    /* a packet has been received in each data slot */
+    n_data_slots = 0;
+    for(j = 0; j < GMW_SCHED_N_SLOTS(&sched); j++) {
+      if(sched.slot[j] != HOST_ID && sched.slot[j] != GMW_SLOT_CONTENTION) {
+        lwb_sched_process_data(sched.slot[j], 0, 0);
+        n_data_slots++;
+      }
+    }
+    uint64_t t_start = host_cpu_time_ns();
+    lwb_sched_compute(&sched, 0);
+    t_sum += host_cpu_time_ns() - t_start;
+  }
+  printf("%4u streams: %lu ns per schedule (%u data slots)\n", n_streams,
+         (unsigned long)(t_sum / BENCH_ROUNDS), n_data_slots);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(app_process, "Application Task");
+AUTOSTART_PROCESSES(&app_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(app_process, ev, data)
+{
+  uint8_t i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < sizeof(bench_n_streams) / sizeof(bench_n_streams[0]); i++) {
+    run_bench(bench_n_streams[i]);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
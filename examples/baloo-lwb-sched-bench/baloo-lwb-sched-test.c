@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Rate accuracy test of the LWB host scheduler
+ *
+ *         1. 200 streams with pairwise co-prime IPIs (the first 200 primes):
+ *            the round period must be the largest period in which the
+ *            aggregate rate fits into the data slots, and each stream must
+ *            get one slot per IPI (+/- one slot) over the whole run.
+ *         2. 500 streams with IPIs of 1, 2, 3, 5 and 7 s saturate the
+ *            network: all data slots must be used, no stream may starve and
+ *            the slots must be shared in proportion to 1/IPI, i.e. the
+ *            assigned number of slots times the IPI must be the same for
+ *            all streams (within the largest IPI).
+ *         3. 20 alarm streams (priority class 1, deadline 3 s) compete with
+ *            500 bulk streams in a saturated network: the alarm streams must
+ *            get all their slots in time. Then, one stream with a deadline of
+ *            20 s must limit the round period to 20 s.
+ *         4. 30 sources with an IPI of 10 s and random bursts of 10 packets:
+ *            with backlog reports, the 99th percentile of the packet latency
+ *            (from generation to the round with the slot) must drop, while
+ *            the number of rounds and slots (i.e. the energy) may grow by at
+ *            most 10%.
+ *
+ *         Run with: ./baloo-lwb-sched-test.native -d
+ *         The exit code is 0 if all checks passed.
+ */
+
+/*---------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lwb/gmw-lwb.h"
+/*---------------------------------------------------------------------------*/
+#define FIRST_SOURCE_ID     (HOST_ID + 1)
+#define MAX_TEST_STREAMS    500
+#define TEST_ROUNDS         200
+#define BURST_SOURCES       30
+#define BURST_IPI           10
+#define BURST_LEN           10
+#define BURST_QUEUE_SIZE    256       /* power of 2 */
+#define BURST_TIME          20000     /* seconds */
+#define BURST_MAX_LATENCY   1024      /* seconds, histogram size */
+/*---------------------------------------------------------------------------*/
+static lwb_schedule_t       sched;
+static uint16_t             ipi[MAX_TEST_STREAMS];
+static uint8_t              prio[MAX_TEST_STREAMS];
+static uint16_t             deadline[MAX_TEST_STREAMS];
+static uint32_t             n_assigned[MAX_TEST_STREAMS];
+static uint16_t             n_failed;
+/*---------------------------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  if(!(cond)) { \
+    printf("FAIL: " __VA_ARGS__); \
+    printf("\n"); \
+    n_failed++; \
+  }
+/*---------------------------------------------------------------------------*/
+static void
+register_streams(uint16_t n_streams)
+{
+  lwb_stream_req_t req;
+  lwb_stream_ack_t sack;
+  uint16_t         i;
+
+  lwb_sched_init(&sched);
+  memset(n_assigned, 0, sizeof(n_assigned));
+  memset(&req, 0, sizeof(req));
+  req.header.recipient_id = HOST_ID;
+  req.header.type         = LWB_PACKET_TYPE_REQ;
+  for(i = 0; i < n_streams; i++) {
+    req.sender_id = FIRST_SOURCE_ID + i;
+    req.ipi       = ipi[i];
+    req.prio      = prio[i];
+    req.deadline  = deadline[i];
+    lwb_sched_process_stream_req(&req);
+    while(lwb_sched_prepare_sack(&sack));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* compute a schedule, return the number of data slots */
+static uint16_t
+next_round(void)
+{
+  uint16_t i, n_data_slots = 0;
+
+  /* a packet has been received in each data slot of the last round */
+  for(i = 0; i < GMW_SCHED_N_SLOTS(&sched); i++) {
+    if(sched.slot[i] != HOST_ID && sched.slot[i] != GMW_SLOT_CONTENTION) {
+      lwb_sched_process_data(sched.slot[i], 0, 0);
+    }
+  }
+  lwb_sched_compute(&sched, 0);
+  for(i = 0; i < GMW_SCHED_N_SLOTS(&sched); i++) {
+    if(sched.slot[i] != HOST_ID && sched.slot[i] != GMW_SLOT_CONTENTION) {
+      n_assigned[sched.slot[i] - FIRST_SOURCE_ID]++;
+      n_data_slots++;
+    }
+  }
+  return n_data_slots;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_coprime_ipis(void)
+{
+  uint16_t n_streams = 0, i, j, r;
+  double   rate = 0, t_opt;
+
+  /* the first 200 primes */
+  for(i = 2; n_streams < 200; i++) {
+    for(j = 2; j * j <= i && (i % j); j++);
+    if(j * j > i) {
+      prio[n_streams]     = 0;
+      deadline[n_streams] = 0;
+      ipi[n_streams++]    = i;
+      rate += 1.0 / i;
+    }
+  }
+  register_streams(n_streams);
+  next_round();                 /* first round after the stream requests */
+  for(r = 0; r < TEST_ROUNDS; r++) {
+    next_round();
+  }
+  t_opt = LWB_MAX_DATA_SLOTS / rate;
+  if(t_opt > LWB_CONF_SCHED_PERIOD_MAX) {
+    t_opt = LWB_CONF_SCHED_PERIOD_MAX;
+  }
+  CHECK(sched.period <= t_opt && sched.period > t_opt - 1,
+        "co-prime IPIs: period %u, expected %.3f", sched.period, t_opt);
+  for(i = 0; i < n_streams; i++) {
+    uint32_t expected = sched.time / ipi[i];
+    CHECK(n_assigned[i] <= expected && n_assigned[i] + 1 >= expected,
+          "co-prime IPIs: stream %u (IPI %us) got %lu slots, expected %lu",
+          i, ipi[i], (unsigned long)n_assigned[i], (unsigned long)expected);
+  }
+  printf("co-prime IPIs: %u streams, period %us (optimum %.3fs), time %lus\n",
+         n_streams, sched.period, LWB_MAX_DATA_SLOTS / rate,
+         (unsigned long)sched.time);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_saturation(void)
+{
+  static const uint16_t ipis[] = { 1, 2, 3, 5, 7 };
+  uint16_t n_streams = MAX_TEST_STREAMS, i, r;
+  uint32_t min_lag = 0xffffffff, max_lag = 0, n_min = 0xffffffff;
+
+  for(i = 0; i < n_streams; i++) {
+    ipi[i]      = ipis[i % (sizeof(ipis) / sizeof(ipis[0]))];
+    prio[i]     = 0;
+    deadline[i] = 0;
+  }
+  register_streams(n_streams);
+  next_round();
+  memset(n_assigned, 0, sizeof(n_assigned));
+  for(r = 0; r < TEST_ROUNDS; r++) {
+    uint16_t n_data_slots = next_round();
+    CHECK(n_data_slots == LWB_MAX_DATA_SLOTS,
+          "saturation: %u of %u data slots used in round %u",
+          n_data_slots, LWB_MAX_DATA_SLOTS, r);
+  }
+  for(i = 0; i < n_streams; i++) {
+    uint32_t lag = n_assigned[i] * ipi[i];
+    min_lag = MIN(min_lag, lag);
+    max_lag = MAX(max_lag, lag);
+    n_min   = MIN(n_min, n_assigned[i]);
+  }
+  CHECK(n_min > 0, "saturation: a stream starved");
+  CHECK(max_lag - min_lag <= 2 * ipis[4],
+        "saturation: slots x IPI between %lu and %lu",
+        (unsigned long)min_lag, (unsigned long)max_lag);
+  printf("saturation: %u streams, slots x IPI between %lu and %lu\n",
+         n_streams, (unsigned long)min_lag, (unsigned long)max_lag);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_priority_classes(void)
+{
+  const lwb_class_stats_t* stats;
+  uint16_t n_streams = MAX_TEST_STREAMS, n_alarm = 20, i, r;
+
+  for(i = 0; i < n_streams; i++) {
+    ipi[i]      = 1;
+    prio[i]     = (i < n_alarm);
+    deadline[i] = (i < n_alarm) ? 3 : 0;
+  }
+  register_streams(n_streams);
+  for(r = 0; r < TEST_ROUNDS; r++) {
+    next_round();
+  }
+  for(i = 0; i < n_alarm; i++) {
+    CHECK(n_assigned[i] + 1 >= sched.time / ipi[i],
+          "priority: alarm stream %u got %lu slots, expected %lu", i,
+          (unsigned long)n_assigned[i], (unsigned long)sched.time / ipi[i]);
+  }
+  stats = lwb_sched_get_class_stats(1);
+  CHECK(stats->n_slots && !stats->n_deadline_missed && stats->latency_max < 3,
+        "priority: %lu alarm slots, %u missed deadlines, max. latency %us",
+        (unsigned long)stats->n_slots, stats->n_deadline_missed,
+        stats->latency_max);
+  stats = lwb_sched_get_class_stats(0);
+  CHECK(stats->n_slots, "priority: the bulk streams starved");
+  printf("priority: alarm class max. latency %us, bulk class avg. latency "
+         "%lus\n", lwb_sched_get_class_stats(1)->latency_max,
+         (unsigned long)(stats->latency_sum / stats->n_slots));
+
+  /* a light load with one deadline */
+  for(i = 0; i < 10; i++) {
+    ipi[i]      = 100;
+    prio[i]     = 0;
+    deadline[i] = (i == 5) ? 20 : 0;
+  }
+  register_streams(10);
+  for(r = 0; r < 5; r++) {
+    next_round();
+  }
+  CHECK(sched.period == 20, "deadline: period %u, expected 20",
+        sched.period);
+}
+/*---------------------------------------------------------------------------*/
+/* the output queues of the sources: generation times of the packets */
+static uint32_t             queue[BURST_SOURCES][BURST_QUEUE_SIZE];
+static uint16_t             queue_head[BURST_SOURCES];
+static uint16_t             queue_len[BURST_SOURCES];
+static uint32_t             latency_hist[BURST_MAX_LATENCY + 1];
+/*---------------------------------------------------------------------------*/
+static void
+run_bursts(uint8_t report_backlog, uint32_t* out_p99, uint32_t* out_rounds,
+           uint32_t* out_slots, uint32_t* out_empty)
+{
+  uint32_t t_gen = 0, n_pkts = 0, cnt = 0, seed = 12345;
+  uint16_t i, n;
+
+  for(i = 0; i < BURST_SOURCES; i++) {
+    ipi[i]      = BURST_IPI;
+    prio[i]     = 0;
+    deadline[i] = 0;
+  }
+  register_streams(BURST_SOURCES);
+  memset(queue_len, 0, sizeof(queue_len));
+  memset(latency_hist, 0, sizeof(latency_hist));
+  *out_rounds = 0;
+  *out_slots  = 0;
+  *out_empty  = 0;
+  while(sched.time < BURST_TIME) {
+    /* generate the packets up to the start of the next round */
+    for(; t_gen < sched.time; t_gen++) {
+      for(n = 0; n < BURST_SOURCES; n++) {
+        uint8_t k = ((t_gen % BURST_IPI) == n % BURST_IPI);
+        seed = seed * 1103515245 + 12345;
+        if(((seed >> 16) % 2000) == 0) {
+          k += BURST_LEN;
+        }
+        while(k-- && queue_len[n] < BURST_QUEUE_SIZE) {
+          queue[n][(queue_head[n] + queue_len[n]++) %
+                   BURST_QUEUE_SIZE] = t_gen;
+        }
+      }
+    }
+    /* the sources send one packet per slot and report their backlog */
+    for(i = 0; i < GMW_SCHED_N_SLOTS(&sched); i++) {
+      if(sched.slot[i] == HOST_ID || sched.slot[i] == GMW_SLOT_CONTENTION) {
+        continue;
+      }
+      n = sched.slot[i] - FIRST_SOURCE_ID;
+      (*out_slots)++;
+      if(!queue_len[n]) {
+        (*out_empty)++;                 /* slot without a packet to send */
+      } else {
+        uint32_t latency = sched.time - queue[n][queue_head[n]];
+        latency_hist[MIN(latency, BURST_MAX_LATENCY)]++;
+        n_pkts++;
+        queue_head[n] = (queue_head[n] + 1) % BURST_QUEUE_SIZE;
+        queue_len[n]--;
+        lwb_sched_process_data(sched.slot[i], 0, report_backlog ?
+                               MIN(queue_len[n], LWB_BACKLOG_MAX) : 0);
+      }
+    }
+    lwb_sched_compute(&sched, 0);
+    (*out_rounds)++;
+  }
+  /* 99th percentile */
+  for(i = 0; i < BURST_MAX_LATENCY; i++) {
+    cnt += latency_hist[i];
+    if(cnt * 100 >= n_pkts * 99) {
+      break;
+    }
+  }
+  *out_p99 = i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_backlog(void)
+{
+  uint32_t p99[2], rounds[2], slots[2], empty[2];
+
+  run_bursts(0, &p99[0], &rounds[0], &slots[0], &empty[0]);
+  run_bursts(1, &p99[1], &rounds[1], &slots[1], &empty[1]);
+  CHECK(p99[1] < p99[0], "backlog: p99 latency %lus with, %lus without "
+        "reports", (unsigned long)p99[1], (unsigned long)p99[0]);
+  /* the rounds (control and contention slot) and the data slots are checked
+   * separately: the backlog has to fit into about the same number of rounds,
+   * and each extra slot has to carry a packet */
+  CHECK(rounds[1] * 10 <= rounds[0] * 11,
+        "backlog: %lu rounds with, %lu without reports",
+        (unsigned long)rounds[1], (unsigned long)rounds[0]);
+  CHECK(empty[1] <= empty[0] + slots[0] / 1000,
+        "backlog: %lu of %lu slots empty with, %lu of %lu without reports",
+        (unsigned long)empty[1], (unsigned long)slots[1],
+        (unsigned long)empty[0], (unsigned long)slots[0]);
+  printf("backlog: p99 latency %lus -> %lus, %lu -> %lu rounds, "
+         "%lu -> %lu slots (%lu -> %lu empty)\n",
+         (unsigned long)p99[0], (unsigned long)p99[1],
+         (unsigned long)rounds[0], (unsigned long)rounds[1],
+         (unsigned long)slots[0], (unsigned long)slots[1],
+         (unsigned long)empty[0], (unsigned long)empty[1]);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(app_process, "Application Task");
+AUTOSTART_PROCESSES(&app_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(app_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  test_coprime_ipis();
+  test_saturation();
+  test_priority_classes();
+  test_backlog();
+  printf("%s\n", n_failed ? "FAILED" : "all checks passed");
+  exit(n_failed ? EXIT_FAILURE : EXIT_SUCCESS);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
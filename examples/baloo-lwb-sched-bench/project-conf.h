@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/*
+ * application specific config file to override default settings
+ */
+
+#ifndef PLATFORM_NATIVE
+  #error "the scheduler benchmark runs on the native platform only"
+#endif /* PLATFORM_NATIVE */
+
+#define HOST_ID                         1
+
+/* number of schedules computed per step */
+#define BENCH_ROUNDS                    100
+
+/* RF */
+#define GMW_CONF_RF_TX_CHANNEL          GMW_RF_TX_CHANNEL_2405_MHz
+
+/* LWB configuration: up to 3000 streams (one per node), each stream asks for
+ * one slot per round */
+#define LWB_CONF_MAX_N_STREAMS          3000
+#define LWB_CONF_SCHED_PERIOD_MIN       2
+/* the rate test expects a round period of about 115s with its 200 streams */
+#define LWB_CONF_SCHED_PERIOD_MAX       300
+/* the backlog test grants up to 32 extra slots per round */
+#define LWB_CONF_SCHED_BACKLOG_SLOTS    32
+#define BENCH_IPI                       LWB_CONF_SCHED_PERIOD_MIN
+
+/* GMW configuration: the rounds are never executed, the schedule only has to
+ * be large enough (the control packet length is irrelevant) */
+#define GMW_CONF_MAX_SLOTS              256
+#define GMW_CONF_MAX_CONTROL_PKT_LEN    16
+#define GMW_CONF_MAX_DATA_PKT_LEN       15
+#define GMW_CONF_CONTROL_USER_BYTES     1
+
+/* debug config: keep the scheduler quiet while it is measured */
+#define DEBUG_PRINT_CONF_LEVEL          DEBUG_PRINT_LVL_ERROR
+
+#endif /* PROJECT_CONF_H_ */
@@ -112,7 +112,7 @@ PROCESS_THREAD(app_process, ev, data)
       }
       DEBUG_PRINT_INFO("%s time: %lu, FSR: %u, PER: %u", //, CPU DC: %u, RF DC: %u",
                        lwb_sync_state_to_string[lwb_get_sync_state()],
-                       lwb_get_time(0),
+                       (unsigned long)lwb_get_time(0),
                        glossy_get_fsr(),
                        glossy_get_per() /*,
                        DCSTAT_CPU_DC,
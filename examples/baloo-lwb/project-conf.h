@@ -40,8 +40,22 @@
 
 /* to compile for flocklab, pass FLOCKLAB=1 to the make command */
 #define HOST_ID                         1
+#ifndef NUM_NODES
 #define NUM_NODES                       30
+#endif /* NUM_NODES */
+
+#if NUM_NODES > 100
+/* large network, e.g. DEFINES=NUM_NODES=1000 and -N 1000 on the native
+ * platform (32x32 grid, the host sits in a corner): the floods need up to
+ * LARGE_NET_HOPS hops, a round with LARGE_NET_SLOTS slots must end before
+ * the second schedule (LWB_CONF_SCHED2_OFFSET) and the IPI keeps the offered
+ * load below the capacity of the schedule */
+#define LARGE_NET_HOPS                  24
+#define LARGE_NET_SLOTS                 24
+#define SOURCE_IPI                      300  /* seconds */
+#else /* NUM_NODES */
 #define SOURCE_IPI                      4    /* seconds */
+#endif /* NUM_NODES */
 
 #ifdef FLOCKLAB
   #include "../../tools/flocklab/flocklab.h"
@@ -97,6 +111,10 @@
   /* stats */
   #define DCSTAT_CONF_ON                1
 
+#elif defined PLATFORM_NATIVE
+  /* RF */
+  #define GMW_CONF_RF_TX_CHANNEL        GMW_RF_TX_CHANNEL_2405_MHz
+
 #else
   #error "unknown target platform"
 #endif
@@ -105,21 +123,37 @@
 #define LWB_CONF_SCHED_PERIOD_DEFAULT   5
 #define LWB_CONF_SCHED_PERIOD_MIN       2
 #define LWB_CONF_SCHED_PERIOD_MAX       15
-#define LWB_CONF_INPUT_QUEUE_SIZE       NUM_NODES
 #define LWB_CONF_OUTPUT_QUEUE_SIZE      4
 
 /* GMW configuration */
 #define GMW_CONF_MAX_DATA_PKT_LEN       15     /* bytes */
-#define GMW_CONF_MAX_SLOTS              NUM_NODES
 #define GMW_CONF_CONTROL_USER_BYTES     1      /* one byte to mark schedules */
+#if NUM_NODES > 100
+/* slot times derived from the packet lengths and the number of hops */
+#define LWB_CONF_MAX_N_STREAMS          NUM_NODES
+#define LWB_CONF_MAX_CONT_SLOTS         4
+#define LWB_CONF_INPUT_QUEUE_SIZE       LARGE_NET_SLOTS
+#define GMW_CONF_MAX_SLOTS              LARGE_NET_SLOTS
+#define GMW_CONF_MAX_HOPS               LARGE_NET_HOPS
+#define GMW_CONF_T_CONT                 GMW_T_SLOT_MIN(GMW_CONF_MAX_DATA_PKT_LEN + \
+                                          GMW_CONF_RF_OVERHEAD, \
+                                          GMW_CONF_TX_CNT_DATA, \
+                                          GMW_CONF_MAX_HOPS)
+#else /* NUM_NODES */
+#define LWB_CONF_INPUT_QUEUE_SIZE       NUM_NODES
+#define GMW_CONF_MAX_SLOTS              NUM_NODES
 #define GMW_CONF_T_CONTROL              25000  /* 25ms */
 #define GMW_CONF_T_DATA                 20000  /* 20ms */
 #define GMW_CONF_T_CONT                 8000
-#define GMW_CONF_T_GAP                  5000
+#endif /* NUM_NODES */
+#define GMW_CONF_T_GAP                  3000   /* no on_slot_pre in own slots */
+#define GMW_CONF_MAX_ROUND_PRE_SLOTS    (LWB_CONF_OUTPUT_QUEUE_SIZE + 1)
 #define GMW_CONF_TX_CNT_CONTROL         3
 #define GMW_CONF_TX_CNT_DATA            3
 
 /* Debug */
+#ifndef PLATFORM_NATIVE
 #define DEBUG_PRINT_CONF_STACK_GUARD          (SRAM_START + SRAM_SIZE - 0x0200)
+#endif /* PLATFORM_NATIVE */
 
 #endif /* PROJECT_CONF_H_ */
@@ -71,12 +71,34 @@ static const uint16_t static_nodes[GMW_CONF_MAX_SLOTS] =
                                         25,26,27,28,32,
                                         33 };
 static const uint8_t number_of_static_nodes = GMW_CONF_MAX_SLOTS;
+#if GMW_CONF_USE_CONTROL_SKIP
+/* the schedule never changes: the sources may skip this many control slots
+ * after each received control */
+#define APP_CONTROL_SKIP      4
+#endif /* GMW_CONF_USE_CONTROL_SKIP */
+#if GMW_CONF_USE_INTEREST_MASK
+/* a source takes part in the host slot and in every APP_INTEREST_STRIDE-th
+ * slot (the others are relayed by the remaining nodes) */
+#define APP_INTEREST_STRIDE   2
+#endif /* GMW_CONF_USE_INTEREST_MASK */
+#if GMW_CONF_USE_EARLY_TERMINATION
+/* emulate rounds without traffic: every APP_IDLE_ROUND_PERIOD-th round is
+ * ended by the host after its own slot (slot 0) */
+#define APP_IDLE_ROUND_PERIOD 2
+#endif /* GMW_CONF_USE_EARLY_TERMINATION */
+#if GMW_CONF_USE_HISTOGRAMS
+/* print and reset the latency histograms every APP_HIST_ROUNDS rounds */
+#define APP_HIST_ROUNDS       30
+#endif /* GMW_CONF_USE_HISTOGRAMS */
 
 /*---------------------------------------------------------------------------*/
 /*- APP PROTOTYPES ----------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 static void app_control_init(gmw_control_t* control);
 static void app_control_update(gmw_control_t* control);
+#if GMW_CONF_USE_HISTOGRAMS
+static void app_print_hist(const char* name, const uint16_t* hist);
+#endif /* GMW_CONF_USE_HISTOGRAMS */
 /*---------------------------------------------------------------------------*/
 
 /*---------------------------------------------------------------------------*/
@@ -103,6 +125,49 @@ PROCESS_THREAD(app_process, ev, data)
 
     DEBUG_PRINT_INFO("dummy application task");
 
+#if GMW_CONF_USE_ENERGY_STATS
+    {
+      /* radio-on time of the last round per energy class, in us */
+      const gmw_energy_t* e = &gmw_get_stats()->energy_round;
+      DEBUG_PRINT_INFO("rf us: ctrl %lu tx %lu rx %lu wasted %lu idle %lu",
+        (unsigned long)GMW_TICKS_TO_US(e->rf_on[GMW_ENERGY_CONTROL]),
+        (unsigned long)GMW_TICKS_TO_US(e->rf_on[GMW_ENERGY_TX]),
+        (unsigned long)GMW_TICKS_TO_US(e->rf_on[GMW_ENERGY_RX_USED]),
+        (unsigned long)GMW_TICKS_TO_US(e->rf_on[GMW_ENERGY_RX_WASTED]),
+        (unsigned long)GMW_TICKS_TO_US(e->rf_on[GMW_ENERGY_IDLE]));
+      DEBUG_PRINT_INFO("bytes sent %lu rcvd %lu",
+                       (unsigned long)e->bytes_sent,
+                       (unsigned long)e->bytes_rcvd);
+    }
+#endif /* GMW_CONF_USE_ENERGY_STATS */
+
+#if GMW_CONF_USE_ADAPTIVE_N_TX
+    if(HOST_ID == node_id) {
+      /* N_TX the host has learned for the second slot's initiator */
+      const gmw_n_tx_state_t* n = gmw_get_n_tx_state(control.schedule.slot[1]);
+      DEBUG_PRINT_INFO("N_TX raised %u lowered %u, node %u: %u (loss %u%%)",
+                       gmw_get_stats()->n_tx_inc_cnt,
+                       gmw_get_stats()->n_tx_dec_cnt,
+                       control.schedule.slot[1], n ? n->n_tx : 0,
+                       n ? (uint16_t)((uint32_t)n->loss * 100 >> 16) : 0);
+    }
+#endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+
+#if GMW_CONF_USE_HISTOGRAMS
+    static uint16_t round_cnt = 0;
+    if(++round_cnt >= APP_HIST_ROUNDS) {
+      static gmw_histograms_t hist;
+      gmw_get_histograms(&hist, 1);
+      app_print_hist("slot_pre us", hist.slot_pre);
+      app_print_hist("slot_post us", hist.slot_post);
+      app_print_hist("flood_end us", hist.flood_end);
+      app_print_hist("relay_cnt", hist.relay_cnt);
+      app_print_hist("round ms", hist.round);
+      app_print_hist("slack ms", hist.slack);
+      round_cnt = 0;
+    }
+#endif /* GMW_CONF_USE_HISTOGRAMS */
+
     /* poll the debug-print task to print out all queued debug messages */
     debug_print_poll();
   }
@@ -117,11 +182,18 @@ host_on_control_slot_post_callback(gmw_control_t* in_out_control,
 {
   /* return GMW_RUNNING in order to participate in this round */
   leds_on(LEDS_GREEN);
+#if GMW_CONF_USE_EARLY_TERMINATION
+  if((in_out_control->schedule.time / in_out_control->schedule.period) %
+     APP_IDLE_ROUND_PERIOD == 0) {
+    /* no traffic expected, end the round with the first host slot */
+    gmw_end_round();
+  }
+#endif /* GMW_CONF_USE_EARLY_TERMINATION */
   return GMW_RUNNING;
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-host_on_slot_pre_callback(uint8_t  slot_index,
+host_on_slot_pre_callback(uint16_t slot_index,
                           uint16_t slot_assignee,
                           uint8_t* out_len,
                           uint8_t* out_payload,
@@ -139,7 +211,7 @@ host_on_slot_pre_callback(uint8_t  slot_index,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-host_on_slot_post_callback(uint8_t slot_index,
+host_on_slot_post_callback(uint16_t slot_index,
                            uint16_t slot_assignee,
                            uint8_t len,
                            uint8_t* payload,
@@ -195,7 +267,7 @@ src_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-src_on_slot_pre_callback(uint8_t slot_index,
+src_on_slot_pre_callback(uint16_t slot_index,
                          uint16_t slot_assignee,
                          uint8_t* out_len,
                          uint8_t* out_payload,
@@ -215,7 +287,7 @@ src_on_slot_pre_callback(uint8_t slot_index,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-src_on_slot_post_callback(uint8_t slot_index,
+src_on_slot_post_callback(uint16_t slot_index,
                           uint16_t slot_assignee,
                           uint8_t len,
                           uint8_t* payload,
@@ -247,6 +319,22 @@ src_on_round_finished(gmw_pre_post_processes_t* in_out_pre_post_processes)
   leds_off(LEDS_GREEN);
 }
 /*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_INTEREST_MASK
+static void
+src_on_round_interest(const gmw_control_t* control, uint8_t* out_mask)
+{
+  /* select the slots to receive and relay, the middleware sleeps through
+   * all others (own slots are always executed) */
+  uint16_t i;
+  for(i = 0; i < GMW_SCHED_N_SLOTS(&control->schedule); i++) {
+    if(control->schedule.slot[i] == HOST_ID ||
+       (i % APP_INTEREST_STRIDE) == (node_id % APP_INTEREST_STRIDE)) {
+      out_mask[i >> 3] |= (1 << (i & 0x07));
+    }
+  }
+}
+#endif /* GMW_CONF_USE_INTEREST_MASK */
+/*---------------------------------------------------------------------------*/
 static uint32_t
 src_on_bootstrap_timeout(void)
 {
@@ -288,6 +376,11 @@ app_control_init(gmw_control_t* control)
     /* the period is 2 seconds */
     control->schedule.period = 2;
 
+  #if GMW_CONF_USE_CONTROL_SKIP
+    /* announce that the next rounds reuse this schedule and period */
+    control->schedule.n_skip = APP_CONTROL_SKIP;
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
+
     /* we want the control packet to include a
      * config section, which contains all default parameters
      */
@@ -302,10 +395,32 @@ app_control_update(gmw_control_t* control)
   control->schedule.time += control->schedule.period;
 
   /* print debug output */
-  DEBUG_PRINT_INFO("time: %lu, period: %u", control->schedule.time,
+  DEBUG_PRINT_INFO("time: %lu, period: %u",
+                   (unsigned long)control->schedule.time,
                                             control->schedule.period);
 }
 /*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_HISTOGRAMS
+static void
+app_print_hist(const char* name, const uint16_t* hist)
+{
+  /* print the bins up to the last non-empty one (as many as fit into one
+   * debug message) */
+  char     str[80];
+  uint8_t  n = GMW_CONF_HIST_N_BINS;
+  uint8_t  i;
+  uint16_t len = 0;
+  while(n > 1 && !hist[n - 1]) {
+    n--;
+  }
+  str[0] = 0;
+  for(i = 0; i < n && (len + 7) <= sizeof(str); i++) {
+    len += snprintf(str + len, sizeof(str) - len, " %u", hist[i]);
+  }
+  DEBUG_PRINT_INFO("hist %.12s:%s", name, str);
+}
+#endif /* GMW_CONF_USE_HISTOGRAMS */
+/*---------------------------------------------------------------------------*/
 /**
  * GMW initialization function
  */
@@ -326,6 +441,9 @@ gmw_init(gmw_protocol_impl_t* host_impl,
   src_impl->on_slot_post            = &src_on_slot_post_callback;
   src_impl->on_round_finished       = &src_on_round_finished;
   src_impl->on_bootstrap_timeout    = &src_on_bootstrap_timeout;
+#if GMW_CONF_USE_INTEREST_MASK
+  src_impl->on_round_interest       = &src_on_round_interest;
+#endif /* GMW_CONF_USE_INTEREST_MASK */
 
   /* loads __default__ schedule and config parameters */
   gmw_control_init(control);
@@ -85,6 +85,11 @@
   /* RF */
   #define GMW_CONF_RF_TX_CHANNEL        GMW_RF_TX_CHANNEL_868_6_MHz
 
+#elif defined PLATFORM_NATIVE
+
+  /* radio configuration */
+  #define GMW_CONF_RF_TX_CHANNEL        GMW_RF_TX_CHANNEL_2405_MHz
+
 #else
   #error "unknown target platform"
 #endif
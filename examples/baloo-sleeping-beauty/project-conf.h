@@ -116,6 +116,14 @@
   #define GLOSSY_CONF_USE_RF1A_CALLBACKS    0
   #define STROBING_CONF_USE_RF1A_CALLBACKS  0
 
+#elif defined PLATFORM_NATIVE
+
+  /* radio configuration */
+  #define GMW_CONF_RF_TX_CHANNEL        GMW_RF_TX_CHANNEL_2480_MHz
+
+  /* communication primitives */
+  #define GMW_PRIM1_ENABLE                0  /* don't use chaos */
+
 #else
   #error "unknown target platform"
 #endif
@@ -61,6 +61,9 @@ static uint8_t              is_synced;
 static uint16_t     RF_DC               = 0;
 static uint8_t      first_reset         = 0;
 rtimer_ext_clock_t  stat_resettime      = 0;
+#ifdef PLATFORM_NATIVE
+static rtimer_ext_clock_t stat_rf_on_time = 0;
+#endif /* PLATFORM_NATIVE */
 static uint16_t     received_pkt_cnt  = 0;
 static uint16_t     total_pkt_cnt  = 0;
 /*---------------------------------------------------------------------------*/
@@ -228,11 +231,25 @@ PROCESS_THREAD(app_process, ev, data)
       DCSTAT_RESET;
       first_reset = 1;
     }
+#elif defined PLATFORM_NATIVE
+
+    /* radio-on time as accounted by the virtual medium */
+    RF_DC = (native_medium_get_rf_on_time() - stat_rf_on_time) * 10000 /
+            (rtimer_ext_now_lf() - stat_resettime);
+    DEBUG_PRINT_INFO("Radio DC: %u.%02u", RF_DC/100, RF_DC%100);
+    if(!in_bootstrap) {
+
+      /* Reset stats when you bootstrap the first time */
+      stat_rf_on_time = native_medium_get_rf_on_time();
+      stat_resettime = rtimer_ext_now_lf();
+      first_reset = 1;
+    }
 #endif /* ENERGEST_CONF_ON */
 
     if(node_id==HOST_ID) {
       DEBUG_PRINT_INFO("PRR: %lu RCVD:%u TOT:%u Missed: %u",
-                       ((uint32_t)received_pkt_cnt*10000)/total_pkt_cnt,
+                       total_pkt_cnt ?
+                       ((unsigned long)received_pkt_cnt*10000)/total_pkt_cnt : 0,
                        received_pkt_cnt,
                        total_pkt_cnt,
                        total_pkt_cnt-received_pkt_cnt);
@@ -284,7 +301,7 @@ host_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-host_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
+host_on_slot_pre_callback(uint16_t slot_index, uint16_t slot_assignee,
               uint8_t* out_len, uint8_t* out_payload,
               uint8_t is_initiator, uint8_t is_contention_slot)
 {
@@ -327,7 +344,7 @@ host_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-host_on_slot_post_callback(uint8_t slot_index, uint16_t slot_assignee,
+host_on_slot_post_callback(uint16_t slot_index, uint16_t slot_assignee,
                uint8_t len, uint8_t* payload,
                uint8_t is_initiator, uint8_t is_contention_slot,
                gmw_pkt_event_t event)
@@ -569,7 +586,7 @@ src_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-src_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
+src_on_slot_pre_callback(uint16_t slot_index, uint16_t slot_assignee,
              uint8_t* out_len, uint8_t* out_payload,
              uint8_t is_initiator, uint8_t is_contention_slot)
 {
@@ -660,7 +677,7 @@ src_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-src_on_slot_post_callback(uint8_t slot_index, uint16_t slot_assignee,
+src_on_slot_post_callback(uint16_t slot_index, uint16_t slot_assignee,
               uint8_t len, uint8_t* payload,
               uint8_t is_initiator, uint8_t is_contention_slot,
               gmw_pkt_event_t event)
@@ -715,6 +732,10 @@ src_on_slot_post_callback(uint8_t slot_index, uint16_t slot_assignee,
         /* Store received ETX value */
         if(len != SB_STROBE_PKT_LEN) {
           DEBUG_PRINT_ERROR("Wrong packet length. Expect a STROBE (len=%uB), got %uB", SB_STROBE_PKT_LEN, len);
+        } else if(!GMW_GET_N_RX_PRIM2()) {
+          /* packet was not received with the strobe primitive (outdated
+           * slot config), no ETX estimate available */
+          DEBUG_PRINT_ERROR("No strobes received in slot %u", slot_index);
         } else {
           // One should be careful about overflows of the ETX values,
           // but it should not be a problem unless the network becomes __really__ big
@@ -966,7 +987,7 @@ app_control_static_update(gmw_control_t* control)
 
     /* Clean the schedule */
     //memset(&(control->schedule.slot[0]), 0, GMW_CONF_MAX_SLOTS);
-    memset(control->schedule.slot, 0, GMW_CONF_MAX_SLOTS);
+    memset(control->schedule.slot, 0, sizeof(control->schedule.slot));
 
     /* RR slots */
     for(i=0; i < current_rr_pairs; i++) {
@@ -1025,7 +1046,7 @@ app_control_static_update(gmw_control_t* control)
   } else {
 
     /* Clean the schedule */
-    memset(control->schedule.slot, 0, GMW_CONF_MAX_SLOTS);
+    memset(control->schedule.slot, 0, sizeof(control->schedule.slot));
     //memset(&(control->schedule.slot[0]), 0, GMW_CONF_MAX_SLOTS);
 
     /* Data slots*/
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark of the per-slot overhead of the GMW round engine
+ *
+ *         A single host node executes rounds with a growing number of data
+ *         slots (BENCH_MIN_SLOTS up to GMW_CONF_MAX_SLOTS). Every other slot
+ *         is assigned to the host (the host initiates a flood), the others
+ *         are assigned to an absent node (the host listens in vain). The
+ *         consumed host CPU time of all data slots of a round is divided by
+ *         the number of slots; the result should not depend on the schedule
+ *         length.
+ *
+ *         Run with: ./baloo-slot-bench.native -t 400
+ */
+
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "gmw.h"
+#include "node-id.h"
+#include "debug-print.h"
+#include "rtimer-ext.h"
+/*---------------------------------------------------------------------------*/
+#define ABSENT_NODE_ID      (HOST_ID + 1)
+#define BENCH_PERIOD        10          /* round period in seconds */
+/*---------------------------------------------------------------------------*/
+static gmw_protocol_impl_t  host_impl;
+static gmw_protocol_impl_t  src_impl;
+static gmw_control_t        control;
+/*---------------------------------------------------------------------------*/
+static uint16_t             n_slots = BENCH_MIN_SLOTS;
+static uint8_t              round_cnt;
+static uint8_t              counter;
+static rtimer_ext_clock_t   cpu_start;
+static rtimer_ext_clock_t   cpu_sum;    /* CPU time of the data slots */
+/*---------------------------------------------------------------------------*/
+PROCESS(app_process, "Application Task");
+AUTOSTART_PROCESSES(&app_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(app_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  gmw_init(&host_impl, &src_impl, &control);
+  gmw_start(NULL, &app_process, &host_impl, &src_impl);
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    debug_print_poll();
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static gmw_sync_state_t
+host_on_control_slot_post_callback(gmw_control_t* in_out_control,
+                                   gmw_sync_event_t sync_event,
+                                   gmw_pkt_event_t pkt_event)
+{
+  return GMW_RUNNING;
+}
+/*---------------------------------------------------------------------------*/
+static gmw_skip_event_t
+host_on_slot_pre_callback(uint16_t slot_index,
+                          uint16_t slot_assignee,
+                          uint8_t* out_len,
+                          uint8_t* out_payload,
+                          uint8_t  is_initiator,
+                          uint8_t  is_contention_slot)
+{
+  if(slot_index == 0) {
+    cpu_start = rtimer_ext_native_get_stats()->cpu_time;
+  }
+  if(is_initiator) {
+    out_payload[0] = 42;
+    out_payload[1] = counter++;
+    *out_len = 2;
+  }
+  return GMW_EVT_SKIP_DEFAULT;
+}
+/*---------------------------------------------------------------------------*/
+static gmw_repeat_event_t
+host_on_slot_post_callback(uint16_t slot_index,
+                           uint16_t slot_assignee,
+                           uint8_t len,
+                           uint8_t* payload,
+                           uint8_t is_initiator,
+                           uint8_t is_contention_slot,
+                           gmw_pkt_event_t event)
+{
+  if(slot_index == (n_slots - 1)) {
+    cpu_sum += rtimer_ext_native_get_stats()->cpu_time - cpu_start;
+  }
+  return GMW_EVT_REPEAT_DEFAULT;
+}
+/*---------------------------------------------------------------------------*/
+static void
+host_on_round_finished(gmw_pre_post_processes_t* in_out_pre_post_processes)
+{
+  round_cnt++;
+  if(round_cnt < BENCH_ROUNDS_PER_STEP) {
+    return;
+  }
+  DEBUG_PRINT_INFO("%4u slots: %lu ns per slot", n_slots,
+                   (unsigned long)(cpu_sum * 1000000000ULL /
+                                   RTIMER_EXT_SECOND_HF /
+                                   ((uint32_t)n_slots * round_cnt)));
+  round_cnt = 0;
+  cpu_sum   = 0;
+
+  /* next step: double the number of slots */
+  if(n_slots < GMW_CONF_MAX_SLOTS) {
+    n_slots = MIN(n_slots * 2, GMW_CONF_MAX_SLOTS);
+    control.schedule.n_slots = n_slots;
+    gmw_set_new_control(&control);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static gmw_sync_state_t
+src_on_control_slot_post_callback(gmw_control_t* in_out_control,
+                                  gmw_sync_event_t sync_event,
+                                  gmw_pkt_event_t pkt_event)
+{
+  return GMW_DEFAULT;
+}
+/*---------------------------------------------------------------------------*/
+static gmw_skip_event_t
+src_on_slot_pre_callback(uint16_t slot_index,
+                         uint16_t slot_assignee,
+                         uint8_t* out_len,
+                         uint8_t* out_payload,
+                         uint8_t is_initiator,
+                         uint8_t is_contention_slot)
+{
+  return GMW_EVT_SKIP_DEFAULT;
+}
+/*---------------------------------------------------------------------------*/
+static gmw_repeat_event_t
+src_on_slot_post_callback(uint16_t slot_index,
+                          uint16_t slot_assignee,
+                          uint8_t len,
+                          uint8_t* payload,
+                          uint8_t is_initiator,
+                          uint8_t is_contention_slot,
+                          gmw_pkt_event_t event)
+{
+  return GMW_EVT_REPEAT_DEFAULT;
+}
+/*---------------------------------------------------------------------------*/
+static void
+src_on_round_finished(gmw_pre_post_processes_t* in_out_pre_post_processes)
+{
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+src_on_bootstrap_timeout(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+gmw_init(gmw_protocol_impl_t* host_impl,
+         gmw_protocol_impl_t* src_impl,
+         gmw_control_t* control)
+{
+  uint16_t i;
+
+  host_impl->on_control_slot_post   = &host_on_control_slot_post_callback;
+  host_impl->on_slot_pre            = &host_on_slot_pre_callback;
+  host_impl->on_slot_post           = &host_on_slot_post_callback;
+  host_impl->on_round_finished      = &host_on_round_finished;
+
+  src_impl->on_control_slot_post    = &src_on_control_slot_post_callback;
+  src_impl->on_slot_pre             = &src_on_slot_pre_callback;
+  src_impl->on_slot_post            = &src_on_slot_post_callback;
+  src_impl->on_round_finished       = &src_on_round_finished;
+  src_impl->on_bootstrap_timeout    = &src_on_bootstrap_timeout;
+
+  gmw_control_init(control);
+
+  /* static schedule, the first n_slots slots are used */
+  for(i = 0; i < GMW_CONF_MAX_SLOTS; i++) {
+    control->schedule.slot[i] = (i & 1) ? ABSENT_NODE_ID : HOST_ID;
+  }
+  control->schedule.n_slots = n_slots;
+  control->schedule.time    = 0;
+  control->schedule.period  = BENCH_PERIOD;
+  GMW_CONTROL_SET_CONFIG(control);
+
+  gmw_set_new_control(control);
+}
+/*---------------------------------------------------------------------------*/
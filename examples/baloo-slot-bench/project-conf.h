@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/*
+ * application specific config file to override default settings
+ */
+
+#ifndef PLATFORM_NATIVE
+  #error "the slot benchmark runs on the native platform only"
+#endif /* PLATFORM_NATIVE */
+
+#define HOST_ID                         1
+
+/* the schedule grows from BENCH_MIN_SLOTS to GMW_CONF_MAX_SLOTS, doubling the
+ * number of slots after BENCH_ROUNDS_PER_STEP rounds */
+#define BENCH_MIN_SLOTS                 8
+#define BENCH_ROUNDS_PER_STEP           4
+
+/* RF */
+#define GMW_CONF_RF_TX_CHANNEL          GMW_RF_TX_CHANNEL_2405_MHz
+
+/* GMW configuration: the schedule is static (a 1024-slot schedule does not
+ * fit into a control packet), the slots are as short as possible */
+#define GMW_CONF_MAX_SLOTS              1024
+#define GMW_CONF_USE_STATIC_SCHED       1
+#define GMW_CONF_MAX_CONTROL_PKT_LEN    16
+#define GMW_CONF_MAX_DATA_PKT_LEN       2
+#define GMW_CONF_T_GAP                  1000   /* 1ms */
+#define GMW_CONF_USE_MAGIC_NUMBER       1      /* non-empty control packet */
+
+/* debug config */
+#define DEBUG_PRINT_CONF_LEVEL          DEBUG_PRINT_LVL_INFO
+
+#endif /* PROJECT_CONF_H_ */
@@ -142,7 +142,7 @@ host_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-host_on_slot_pre_callback(uint8_t slot_index,
+host_on_slot_pre_callback(uint16_t slot_index,
                           uint16_t slot_assignee,
                           uint8_t* out_len,
                           uint8_t* out_payload,
@@ -157,7 +157,7 @@ host_on_slot_pre_callback(uint8_t slot_index,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-host_on_slot_post_callback(uint8_t slot_index,
+host_on_slot_post_callback(uint16_t slot_index,
                            uint16_t slot_assignee,
                            uint8_t len,
                            uint8_t* payload,
@@ -191,7 +191,7 @@ src_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-src_on_slot_pre_callback(uint8_t slot_index,
+src_on_slot_pre_callback(uint16_t slot_index,
                          uint16_t slot_assignee,
                          uint8_t* out_len,
                          uint8_t* out_payload,
@@ -206,7 +206,7 @@ src_on_slot_pre_callback(uint8_t slot_index,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-src_on_slot_post_callback(uint8_t slot_index,
+src_on_slot_post_callback(uint16_t slot_index,
                           uint16_t slot_assignee,
                           uint8_t len,
                           uint8_t* payload,
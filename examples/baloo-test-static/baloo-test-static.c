@@ -136,7 +136,7 @@ host_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-host_on_slot_pre_callback(uint8_t slot_index,
+host_on_slot_pre_callback(uint16_t slot_index,
                           uint16_t slot_assignee,
                           uint8_t* out_len,
                           uint8_t* out_payload,
@@ -152,7 +152,7 @@ host_on_slot_pre_callback(uint8_t slot_index,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-host_on_slot_post_callback(uint8_t slot_index, uint16_t slot_assignee,
+host_on_slot_post_callback(uint16_t slot_index, uint16_t slot_assignee,
                uint8_t len, uint8_t* payload,
                uint8_t is_initiator, uint8_t is_contention_slot,
                gmw_pkt_event_t event)
@@ -217,7 +217,7 @@ src_on_control_slot_post_callback(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-src_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
+src_on_slot_pre_callback(uint16_t slot_index, uint16_t slot_assignee,
                          uint8_t* out_len, uint8_t* out_payload,
                          uint8_t is_initiator, uint8_t is_contention_slot)
 {
@@ -230,7 +230,7 @@ src_on_slot_pre_callback(uint8_t slot_index, uint16_t slot_assignee,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-src_on_slot_post_callback(uint8_t slot_index, uint16_t slot_assignee,
+src_on_slot_post_callback(uint16_t slot_index, uint16_t slot_assignee,
                           uint8_t len, uint8_t* payload,
                           uint8_t is_initiator, uint8_t is_contention_slot,
                           gmw_pkt_event_t event)
@@ -56,6 +56,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "contiki.h"
 #include "heapmem.h"
 
 /* The HEAPMEM_CONF_ARENA_SIZE parameter determines the size of the
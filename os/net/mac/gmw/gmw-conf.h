@@ -66,12 +66,14 @@
   #if (GMW_CONF_USE_STATIC_SCHED && GMW_CONF_USE_STATIC_CONFIG)
     #define GMW_CONF_MAX_CONTROL_PKT_LEN      (GMW_CONF_CONTROL_USER_BYTES + GMW_CONF_USE_MAGIC_NUMBER)
   #else
-    #define GMW_CONF_MAX_CONTROL_PKT_LEN      ((GMW_CONF_MAX_SLOTS * (2 + GMW_CONF_USE_CONTROL_SLOT_CONFIG)) + \
+    #define GMW_CONF_MAX_CONTROL_PKT_LEN      ((GMW_CONF_MAX_SLOTS * (2 + GMW_CONF_USE_CONTROL_SLOT_CONFIG * \
+                                                                   (1 + (GMW_CONF_MAX_PRIMITIVES > 4)))) + \
                                                (GMW_CONF_USE_CONTROL_SLOT_CONFIG * GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE) + \
                                                GMW_CONF_CONTROL_USER_BYTES + \
                                                GMW_CONF_USE_MAGIC_NUMBER + \
                                                GMW_SCHED_SECTION_HEADER_LEN + \
-                                               GMW_CONFIG_SECTION_HEADER_LEN)
+                                               GMW_CONFIG_SECTION_HEADER_LEN + \
+                                               GMW_CONF_USE_CONTROL_DELTA)
   #endif
 #endif /* GMW_CONF_MAX_CONTROL_PKT_LEN */
 
@@ -94,18 +96,80 @@
  *            GMW_CONF_MAX_DATA_PKT_LEN
  */
 #define GMW_MAX_PKT_LEN                   MAX(GMW_CONF_MAX_CONTROL_PKT_LEN, \
-                                              GMW_CONF_MAX_DATA_PKT_LEN)
+                                              GMW_CONF_MAX_DATA_PKT_LEN + \
+                                              GMW_CONF_USE_EARLY_TERMINATION)
 
 /**
  * @brief     Max number of slots per round.
  *            CONF value is 10 by default.
  *
- * @note      Used to allocate memory for the control structure.
+ * @note      Used to allocate memory for the control structure. Can be as
+ *            large as GMW_CONTROL_SCHED_N_SLOTS_MASK (4095). A schedule with
+ *            more than GMW_CONF_MAX_SLOTS slots is not sent.
+ * @note      The default GMW_CONF_MAX_CONTROL_PKT_LEN grows with the number of
+ *            slots. For large schedules, limit it to the max. packet length of
+ *            the radio and use schedule compression
+ *            (GMW_CONF_USE_CONTROL_SCHED_COMPRESSION) or a static schedule.
  */
-//TODO: Is there a check whether I set n_slots > GMW_CONF_MAX_SLOTS? Would be nice to add...
 #ifndef GMW_CONF_MAX_SLOTS
 #define GMW_CONF_MAX_SLOTS                10
 #endif /* GMW_CONF_MAX_SLOTS */
+
+/**
+ * @brief     Max number of slots per round whose payload can be prepared in
+ *            advance by the on_round_pre callback (see gmw-types.h).
+ *            CONF value is 0 by default (on_round_pre is never called).
+ *
+ * @note      Each entry takes GMW_CONF_MAX_DATA_PKT_LEN + 3 bytes of RAM.
+ *            One entry per own slot and per contention slot in which the
+ *            node wants to transmit is needed.
+ */
+#ifndef GMW_CONF_MAX_ROUND_PRE_SLOTS
+#define GMW_CONF_MAX_ROUND_PRE_SLOTS      0
+#endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
+
+#if GMW_CONF_MAX_ROUND_PRE_SLOTS > 255
+#error "invalid value for GMW_CONF_MAX_ROUND_PRE_SLOTS"
+#endif
+
+/**
+ * @brief     Enable/disable the per-round interest mask.
+ *            If enabled, the optional on_round_interest callback (see
+ *            gmw-types.h) is called after the control slot and marks the
+ *            slots the node wants to take part in. A run of consecutive
+ *            slots without interest is slept through with a single timer
+ *            wake-up, on_slot_pre and on_slot_post are not called for these
+ *            slots.
+ *
+ * @note      CONF disabled by default.
+ * @note      A node that skips a slot does not relay the flood. Own slots
+ *            are always executed.
+ */
+#ifndef GMW_CONF_USE_INTEREST_MASK
+#define GMW_CONF_USE_INTEREST_MASK        0
+#endif /* GMW_CONF_USE_INTEREST_MASK */
+
+/**
+ * @brief     Enable/disable early round termination.
+ *            If enabled, each flood of the host (slots assigned to HOST_ID)
+ *            carries a trailing flags byte (in addition to the max.
+ *            GMW_CONF_MAX_DATA_PKT_LEN bytes of payload). When the host application calls
+ *            gmw_end_round(), the next host flood carries the end-of-round
+ *            flag and all nodes that receive it switch off the radio until
+ *            the next round, see gmw_statistics_t.slot_saved_cnt.
+ *
+ * @note      CONF disabled by default.
+ * @note      Must be identical on all nodes. Nodes that do not take part in
+ *            a host slot (GMW_CONF_USE_INTEREST_MASK) miss the flag of that
+ *            slot.
+ * @note      There is no termination flood outside of the host slots (it
+ *            would collide with the flood of the slot assignee): the host
+ *            application must assign slots to HOST_ID wherever a round may
+ *            end, gmw_end_round() returns 0 if no such slot is left.
+ */
+#ifndef GMW_CONF_USE_EARLY_TERMINATION
+#define GMW_CONF_USE_EARLY_TERMINATION    0
+#endif /* GMW_CONF_USE_EARLY_TERMINATION */
 /*---------------------------------------------------------------------------*/
 
 /*---------------------------------------------------------------------------*/
@@ -164,6 +228,16 @@
                                           GMW_CONF_MAX_HOPS)
 #endif /* GMW_CONF_T_CONTROL */
 
+/**
+ * @brief     Slot time of a control slot with a payload of len bytes,
+ *            in micro-seconds (us). Never longer than GMW_CONF_T_CONTROL.
+ */
+#define GMW_T_CONTROL(len)       MIN(GMW_CONF_T_CONTROL, \
+                                     GMW_T_SLOT_MIN((len) + \
+                                          GMW_CONF_RF_OVERHEAD, \
+                                          GMW_CONF_TX_CNT_CONTROL, \
+                                          GMW_CONF_MAX_HOPS))
+
 /**
  * @brief     Macro holding the maximal slot time of a data slot,
  *            in micro-seconds (us).
@@ -228,6 +302,8 @@
  *
  * @note      It must be large enough to finish all computations between slots
  *            (i.e., post-slot and pre-slot callback) plus the guard time.
+ *            If the payloads are prepared by on_round_pre and on_slot_pre is
+ *            not used, only the post-slot callback needs to fit.
  */
 #ifndef GMW_CONF_T_GAP
 #define GMW_CONF_T_GAP                    4000UL /* in us */
@@ -240,7 +316,8 @@
  *            Default value is set equal to GMW_CONF_T_GAP.
  *
  * @note      The control-post callback might require more processing time,
- *            thus we let this gap time being customizable if necessary.
+ *            thus we let this gap time being customizable if necessary. The
+ *            on_round_pre callback is executed in this gap as well.
  */
 #ifndef GMW_CONF_T_GAP_CONTROL
 #define  GMW_CONF_T_GAP_CONTROL           GMW_CONF_T_GAP
@@ -272,6 +349,301 @@
 #define GMW_CONF_T_GUARD_ROUND            GMW_CONF_T_GUARD_SLOT
 #endif /* GMW_CONF_T_GUARD_ROUND */
 
+/**
+ * @brief     Enable/disable the self-calibration of the gap and the slot guard
+ *            time.
+ *
+ *            The host measures its processing time between slots (see
+ *            gmw_statistics_t.t_gap_used_max) and the round length and
+ *            collects the timing reports of the sources. From these, it
+ *            derives the gap and slot guard times (incl. a safety margin)
+ *            and announces them in the config section of the control
+ *            packet. Both are widened when the host or a source misses a
+ *            slot (GMW_EVT_PKT_MISSED).
+ *
+ * @note      CONF disabled by default.
+ * @note      Adds the field guard_time to the config section. Cannot be used
+ *            with GMW_CONF_USE_STATIC_CONFIG.
+ * @note      The sources feed back their processing time, clock drift and
+ *            missed slots in timing reports (see gmw_get_timing_report()),
+ *            which the protocol on top of GMW has to deliver to the host
+ *            (GMW-LWB appends them to the data packets). Until the first
+ *            report arrives, the processing budget of the static config is
+ *            kept and the guard time assumes a drift of
+ *            GMW_CONF_MAX_CLOCK_DEV.
+ * @note      Nodes that never initiate a flood cannot report. If such nodes
+ *            are slower than the reporting ones, cover them with
+ *            GMW_CONF_AUTO_GAP_T_PROC_MIN.
+ */
+#ifndef GMW_CONF_USE_AUTO_GAP
+#define GMW_CONF_USE_AUTO_GAP             0
+#endif /* GMW_CONF_USE_AUTO_GAP */
+
+/**
+ * @brief     Safety margin added to the calibrated gap and guard times,
+ *            in percent.
+ */
+#ifndef GMW_CONF_AUTO_GAP_MARGIN
+#define GMW_CONF_AUTO_GAP_MARGIN          25
+#endif /* GMW_CONF_AUTO_GAP_MARGIN */
+
+/**
+ * @brief     Lower bound of the processing time budget of the calibrated gap
+ *            (incl. the margin), in micro-seconds (us).
+ *
+ * @note      Only applies once timing reports of the sources are received,
+ *            before that the budget of the static config (GMW_CONF_T_GAP
+ *            without the slot guard time) is the lower bound.
+ * @note      Must not be 0: a receiver that wakes up after the start of its
+ *            guard time listens until the end of the guard time after the
+ *            slot and then misses the next slot.
+ */
+#ifndef GMW_CONF_AUTO_GAP_T_PROC_MIN
+#define GMW_CONF_AUTO_GAP_T_PROC_MIN      100
+#endif /* GMW_CONF_AUTO_GAP_T_PROC_MIN */
+
+/**
+ * @brief     Synchronization error independent of the clock drift (i.e., the
+ *            minimal slot guard time), in micro-seconds (us).
+ */
+#ifndef GMW_CONF_AUTO_GAP_T_JITTER
+#define GMW_CONF_AUTO_GAP_T_JITTER        100
+#endif /* GMW_CONF_AUTO_GAP_T_JITTER */
+
+/**
+ * @brief     Error of the drift estimation of the sources, added to the max.
+ *            reported drift, in ppm.
+ */
+#ifndef GMW_CONF_AUTO_GAP_DRIFT_ERR
+#define GMW_CONF_AUTO_GAP_DRIFT_ERR       20
+#endif /* GMW_CONF_AUTO_GAP_DRIFT_ERR */
+
+/**
+ * @brief     Max. number of rounds between two timing reports of a source
+ *            (a report is only sent with a flood of the source). The host
+ *            keeps a reported value for 2 to 4 times this number of rounds.
+ */
+#ifndef GMW_CONF_AUTO_GAP_REPORT_ROUNDS
+#define GMW_CONF_AUTO_GAP_REPORT_ROUNDS   8
+#endif /* GMW_CONF_AUTO_GAP_REPORT_ROUNDS */
+
+/**
+ * @brief     Number of rounds without a missed slot before the gap and guard
+ *            times are tightened again after they have been widened.
+ */
+#ifndef GMW_CONF_AUTO_GAP_HOLD
+#define GMW_CONF_AUTO_GAP_HOLD            8
+#endif /* GMW_CONF_AUTO_GAP_HOLD */
+
+/**
+ * @brief     Number of consecutive control packets that carry the config
+ *            section after the gap or guard time has changed.
+ */
+#ifndef GMW_CONF_AUTO_GAP_ANNOUNCE
+#define GMW_CONF_AUTO_GAP_ANNOUNCE        3
+#endif /* GMW_CONF_AUTO_GAP_ANNOUNCE */
+
+#if GMW_CONF_USE_AUTO_GAP && GMW_CONF_USE_STATIC_CONFIG
+#error "GMW_CONF_USE_AUTO_GAP requires the config to be sent in the control"
+#endif
+
+/**
+ * @brief     Enable/disable the adaptive number of retransmissions (N_TX) of
+ *            the data slots.
+ *
+ *            The host learns the flood reliability and the relay count of
+ *            each initiator from the outcome of its data slots. The N_TX of
+ *            an initiator is raised when a flood is lost while its loss rate
+ *            is above the target, and lowered again after
+ *            GMW_CONF_ADAPTIVE_N_TX_HOLD successful floods in a row, as long
+ *            as the packets still reach the host over short paths (the relay
+ *            count is close to the smallest one seen). The learned values
+ *            overwrite the n_retransmissions of the slot config before each
+ *            control packet is sent.
+ *
+ * @note      CONF disabled by default.
+ * @note      Requires GMW_CONF_USE_CONTROL_SLOT_CONFIG. Initiators the host
+ *            has no state for yet use the N_TX of the config section.
+ * @note      Only the reception at the host is observed, i.e. the scheme
+ *            targets collection traffic.
+ */
+#ifndef GMW_CONF_USE_ADAPTIVE_N_TX
+#define GMW_CONF_USE_ADAPTIVE_N_TX        0
+#endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+
+/**
+ * @brief     Target flood reliability (as seen by the host) in per mille.
+ */
+#ifndef GMW_CONF_ADAPTIVE_N_TX_TARGET
+#define GMW_CONF_ADAPTIVE_N_TX_TARGET     990
+#endif /* GMW_CONF_ADAPTIVE_N_TX_TARGET */
+
+/**
+ * @brief     Number of consecutive successful floods of an initiator before
+ *            its N_TX is lowered again (max. 255).
+ */
+#ifndef GMW_CONF_ADAPTIVE_N_TX_HOLD
+#define GMW_CONF_ADAPTIVE_N_TX_HOLD       32
+#endif /* GMW_CONF_ADAPTIVE_N_TX_HOLD */
+
+/**
+ * @brief     Range of the N_TX chosen by the controller (max. 7, the size of
+ *            the field in gmw_slot_config_t).
+ */
+#ifndef GMW_CONF_ADAPTIVE_N_TX_MIN
+#define GMW_CONF_ADAPTIVE_N_TX_MIN        1
+#endif /* GMW_CONF_ADAPTIVE_N_TX_MIN */
+
+#ifndef GMW_CONF_ADAPTIVE_N_TX_MAX
+#define GMW_CONF_ADAPTIVE_N_TX_MAX        7
+#endif /* GMW_CONF_ADAPTIVE_N_TX_MAX */
+
+/**
+ * @brief     Number of initiators the host keeps state for. When the table is
+ *            full, the oldest entry is replaced.
+ */
+#ifndef GMW_CONF_ADAPTIVE_N_TX_NODES
+#define GMW_CONF_ADAPTIVE_N_TX_NODES      GMW_CONF_MAX_SLOTS
+#endif /* GMW_CONF_ADAPTIVE_N_TX_NODES */
+
+/**
+ * @brief     Whether a silent data slot counts as a lost flood. Disable this
+ *            if the sources may leave their slots unused.
+ */
+#ifndef GMW_CONF_ADAPTIVE_N_TX_SILENCE_IS_LOSS
+#define GMW_CONF_ADAPTIVE_N_TX_SILENCE_IS_LOSS  1
+#endif /* GMW_CONF_ADAPTIVE_N_TX_SILENCE_IS_LOSS */
+
+#if GMW_CONF_USE_ADAPTIVE_N_TX
+  #if !GMW_CONF_USE_CONTROL_SLOT_CONFIG || GMW_CONF_USE_STATIC_CONFIG
+  #error "GMW_CONF_USE_ADAPTIVE_N_TX requires the slot config in the control"
+  #endif
+  #if GMW_CONF_ADAPTIVE_N_TX_MIN < 1 || GMW_CONF_ADAPTIVE_N_TX_MAX > 7 || \
+      GMW_CONF_ADAPTIVE_N_TX_MIN > GMW_CONF_ADAPTIVE_N_TX_MAX
+  #error "invalid GMW_CONF_ADAPTIVE_N_TX_MIN/MAX (range 1..7)"
+  #endif
+  #if GMW_CONF_ADAPTIVE_N_TX_HOLD > 255
+  #error "GMW_CONF_ADAPTIVE_N_TX_HOLD must not exceed 255"
+  #endif
+#endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+
+/**
+ * @brief     Enable/disable the sizing of the data slots for the observed
+ *            network diameter.
+ *
+ *            The host tracks the largest hop count of the received data
+ *            floods (relay count + 1) and sizes each entry of the slot time
+ *            list with GMW_T_SLOT_MIN for this diameter instead of
+ *            GMW_CONF_MAX_HOPS. Entry k is sized for payloads of up to
+ *            GMW_CONF_AUTO_SLOT_TIME_LEN(k) bytes, i.e. the application
+ *            selects the payload class of a slot with its slot_time_select
+ *            (slots without a slot config use the largest class).
+ *
+ * @note      CONF disabled by default.
+ * @note      Requires GMW_CONF_USE_CONTROL_SLOT_CONFIG. The control and
+ *            contention slots keep their compile-time lengths.
+ */
+#ifndef GMW_CONF_USE_AUTO_SLOT_TIME
+#define GMW_CONF_USE_AUTO_SLOT_TIME       0
+#endif /* GMW_CONF_USE_AUTO_SLOT_TIME */
+
+/**
+ * @brief     Number of hops added to the observed diameter. The host only
+ *            sees the paths towards itself; the floods must also reach the
+ *            nodes on the far side of the network.
+ */
+#ifndef GMW_CONF_AUTO_SLOT_TIME_MARGIN
+#define GMW_CONF_AUTO_SLOT_TIME_MARGIN    1
+#endif /* GMW_CONF_AUTO_SLOT_TIME_MARGIN */
+
+/**
+ * @brief     Number of rounds after which the diameter may shrink again.
+ */
+#ifndef GMW_CONF_AUTO_SLOT_TIME_WINDOW
+#define GMW_CONF_AUTO_SLOT_TIME_WINDOW    16
+#endif /* GMW_CONF_AUTO_SLOT_TIME_WINDOW */
+
+/**
+ * @brief     Max. payload length of payload class k (entry k of the slot time
+ *            list). Default: the max. data length divided into equal steps.
+ */
+#ifndef GMW_CONF_AUTO_SLOT_TIME_LEN
+#define GMW_CONF_AUTO_SLOT_TIME_LEN(k)    ((((k) + 1) * \
+  (GMW_CONF_MAX_DATA_PKT_LEN + GMW_CONF_USE_EARLY_TERMINATION) + \
+  GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE - 1) / \
+  GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE)
+#endif /* GMW_CONF_AUTO_SLOT_TIME_LEN */
+
+#if GMW_CONF_USE_AUTO_SLOT_TIME && \
+    (!GMW_CONF_USE_CONTROL_SLOT_CONFIG || GMW_CONF_USE_STATIC_CONFIG)
+#error "GMW_CONF_USE_AUTO_SLOT_TIME requires the slot config in the control"
+#endif
+
+/**
+ * @brief     Enable/disable the built-in bootstrap scan policy of the sources.
+ *
+ *            A source that lost the synchronization listens for a control
+ *            packet during one round period (the last one it received, or
+ *            GMW_CONF_BOOTSTRAP_SCAN_PERIOD) plus the length of a control
+ *            slot, i.e. long enough to catch the next round if the host is
+ *            active. If no control packet was received, the radio is turned
+ *            off for a backoff time that grows according to
+ *            GMW_CONF_BOOTSTRAP_SCAN_PROFILE, is capped at
+ *            GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MAX and extended by a random
+ *            jitter. Then the next listen window starts.
+ *
+ * @note      CONF disabled by default.
+ * @note      Only applies if on_bootstrap_timeout() returns 0 (or is NULL),
+ *            i.e. a sleep time returned by the application takes precedence.
+ */
+#ifndef GMW_CONF_USE_BOOTSTRAP_SCAN
+#define GMW_CONF_USE_BOOTSTRAP_SCAN       0
+#endif /* GMW_CONF_USE_BOOTSTRAP_SCAN */
+
+/**
+ * @brief     Backoff profiles of the bootstrap scan
+ */
+#define GMW_BOOTSTRAP_SCAN_CONSTANT       0   /* always the min. backoff */
+#define GMW_BOOTSTRAP_SCAN_LINEAR         1   /* + min. backoff per window */
+#define GMW_BOOTSTRAP_SCAN_EXPONENTIAL    2   /* doubled after each window */
+
+#ifndef GMW_CONF_BOOTSTRAP_SCAN_PROFILE
+#define GMW_CONF_BOOTSTRAP_SCAN_PROFILE   GMW_BOOTSTRAP_SCAN_EXPONENTIAL
+#endif /* GMW_CONF_BOOTSTRAP_SCAN_PROFILE */
+
+/**
+ * @brief     Round period assumed by a node that has never been synchronized,
+ *            in milliseconds (ms).
+ */
+#ifndef GMW_CONF_BOOTSTRAP_SCAN_PERIOD
+#define GMW_CONF_BOOTSTRAP_SCAN_PERIOD    10000
+#endif /* GMW_CONF_BOOTSTRAP_SCAN_PERIOD */
+
+/**
+ * @brief     Min. and max. backoff between two listen windows, in
+ *            milliseconds (ms).
+ */
+#ifndef GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MIN
+#define GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MIN   1000
+#endif /* GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MIN */
+
+#ifndef GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MAX
+#define GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MAX   60000
+#endif /* GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MAX */
+
+/**
+ * @brief     Max. random extension of a backoff, in percent of the backoff.
+ *            Keeps the nodes that lost the host at the same time from
+ *            scanning in lockstep.
+ */
+#ifndef GMW_CONF_BOOTSTRAP_SCAN_JITTER
+#define GMW_CONF_BOOTSTRAP_SCAN_JITTER    10
+#endif /* GMW_CONF_BOOTSTRAP_SCAN_JITTER */
+
+#if GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MIN > GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MAX
+#error "GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MIN exceeds the max. backoff"
+#endif
+
 /**
  * @brief     The time reserved for the execution of the pre-process running
  *            before a GMW round. Time in milliseconds (ms).
@@ -462,6 +834,132 @@
 #define GMW_CONF_USE_STATIC_CONFIG        0
 #endif /*GMW_CONF_USE_STATIC_CONFIG*/
 
+/**
+ * @brief     Enable/disable delta-encoded control packets.
+ *            When enabled, the host only sends the slot ranges that changed
+ *            since the previous round, together with a hash of the resulting
+ *            schedule. A full schedule is sent at least every
+ *            GMW_CONF_CONTROL_DELTA_FULL_PERIOD rounds.
+ *
+ * @note      CONF disabled by default.
+ * @note      A node that missed the previous control packet cannot apply the
+ *            delta (hash mismatch). The control slot is then reported with
+ *            GMW_EVT_CONTROL_PARTIAL: the node stays synchronized and keeps
+ *            its state, but the round has no data slots for it until the
+ *            next full schedule.
+ * @note      The host sends a full schedule whenever the announced config
+ *            differs from the one sent with the previous config section.
+ */
+#ifndef GMW_CONF_USE_CONTROL_DELTA
+#define GMW_CONF_USE_CONTROL_DELTA        0
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
+
+/**
+ * @brief     Max. number of rounds between two full (not delta-encoded)
+ *            schedules.
+ *
+ *            Default value is set to 8.
+ */
+#ifndef GMW_CONF_CONTROL_DELTA_FULL_PERIOD
+#define GMW_CONF_CONTROL_DELTA_FULL_PERIOD  8
+#endif /* GMW_CONF_CONTROL_DELTA_FULL_PERIOD */
+
+/**
+ * @brief     Enable/disable the run-length compression of the slot list in
+ *            the control packet (see gmw-sched-compress.h).
+ *            The host compresses the slot list whenever this makes the
+ *            control packet shorter and flags the schedule section
+ *            accordingly (GMW_CONTROL_HAS_SCHED_COMPRESSED), i.e. the
+ *            compression works with any protocol and any slot order.
+ *
+ * @note      CONF disabled by default.
+ */
+#ifndef GMW_CONF_USE_CONTROL_SCHED_COMPRESSION
+#define GMW_CONF_USE_CONTROL_SCHED_COMPRESSION  0
+#endif /* GMW_CONF_USE_CONTROL_SCHED_COMPRESSION */
+
+/**
+ * @brief     Enable/disable the dynamic control slot time.
+ *            When enabled, the host ends the control slot after
+ *            GMW_T_CONTROL(len) instead of GMW_CONF_T_CONTROL, len being the
+ *            actual length of the compiled control packet.
+ *
+ * @note      CONF enabled by default if the delta-encoding is used.
+ * @note      Only the host benefits: it gets the rest of GMW_CONF_T_CONTROL
+ *            as additional processing time before the first data slot.
+ *            The sources do not know the length of the control packet
+ *            before they have received it and still listen for
+ *            GMW_CONF_T_CONTROL plus the round guard time (the radio is
+ *            off after the last relay though, so the listen window only
+ *            costs energy if the control packet is not received). The data
+ *            slots are still scheduled relative to GMW_CONF_T_CONTROL such
+ *            that all nodes agree on the slot timing, i.e. the round does
+ *            not get shorter.
+ */
+#ifndef GMW_CONF_USE_DYNAMIC_T_CONTROL
+#define GMW_CONF_USE_DYNAMIC_T_CONTROL    GMW_CONF_USE_CONTROL_DELTA
+#endif /* GMW_CONF_USE_DYNAMIC_T_CONTROL */
+
+/**
+ * @brief     RF channels used for the channel hopping (comma-separated list
+ *            of gmw_rf_tx_channel_t values).
+ *
+ *            If the channel_hopping_mode of the current config is set to
+ *            GMW_PER_SLOT_HOPPING, the channel of each data slot is taken
+ *            from this list, based on the round time (schedule.time) and the
+ *            number of slots executed so far in the round (including
+ *            repeated slots). The control slot always uses
+ *            GMW_CONF_RF_TX_CHANNEL.
+ *
+ * @note      Must be the same on all nodes. The list is not announced in the
+ *            control packet, a node with a different list hops out of sync
+ *            with the host without noticing (only the seed can be announced,
+ *            see GMW_CONF_USE_HOPPING_SEED). The platform configuration
+ *            defines a default list, otherwise no channel hopping takes place.
+ * @note      Successive entries should be far apart in frequency such that
+ *            successive slots are not hit by the same interferer.
+ */
+#ifndef GMW_CONF_HOPPING_CHANNELS
+#define GMW_CONF_HOPPING_CHANNELS         GMW_CONF_RF_TX_CHANNEL
+#endif /* GMW_CONF_HOPPING_CHANNELS */
+
+/**
+ * @brief     Default channel hopping mode of the config
+ *            (see gmw_hopping_mode_t), set by gmw_control_init().
+ *
+ * @note      CONF set to GMW_NO_HOPPING by default.
+ * @note      GMW_IN_FLOOD_HOPPING requires the primitive
+ *            GMW_PRIM_GLOSSY_HOPPING of the platform (native only), the build
+ *            fails otherwise.
+ */
+#ifndef GMW_CONF_CHANNEL_HOPPING_MODE
+#define GMW_CONF_CHANNEL_HOPPING_MODE     GMW_NO_HOPPING
+#endif /* GMW_CONF_CHANNEL_HOPPING_MODE */
+
+/**
+ * @brief     Enable/disable the announcement of the hopping sequence.
+ *            The host sends the seed of the per-slot hopping sequence in the
+ *            config section (field hopping_seed). The seed is hashed together
+ *            with the round time to select the first channel of a round, thus
+ *            networks sharing GMW_CONF_HOPPING_CHANNELS can use different
+ *            sequences and the host can change the sequence at runtime.
+ *
+ * @note      CONF disabled by default: the sequence only depends on the
+ *            round time and GMW_CONF_HOPPING_CHANNELS.
+ * @note      Adds the field hopping_seed to the config section.
+ */
+#ifndef GMW_CONF_USE_HOPPING_SEED
+#define GMW_CONF_USE_HOPPING_SEED         0
+#endif /* GMW_CONF_USE_HOPPING_SEED */
+
+/**
+ * @brief     Default hopping seed of the config, set by gmw_control_init()
+ *            (only used with GMW_CONF_USE_HOPPING_SEED).
+ */
+#ifndef GMW_CONF_HOPPING_SEED
+#define GMW_CONF_HOPPING_SEED             0
+#endif /* GMW_CONF_HOPPING_SEED */
+
 /**
  * @brief     Enable/disable the use of multiple synchronous transmission
  *            primitives.
@@ -472,6 +970,26 @@
 #define GMW_CONF_USE_MULTI_PRIMITIVES     0
 #endif /* GMW_CONF_USE_MULTI_PRIMITIVES */
 
+/**
+ * @brief     Size of the primitive table, i.e. max. primitive ID + 1
+ *            (see gmw_register_primitive()).
+ *
+ *            The slot config has room for the primitive IDs 0 to 3. With
+ *            more than 4 primitives, the ID 3 of the slot config is an escape
+ *            code: the actual primitive ID of these slots follows the slot
+ *            config list in the control packet (1 byte per slot that uses a
+ *            primitive ID above 2).
+ *
+ * @note      CONF set to 4 by default (must be between 4 and 256).
+ */
+#ifndef GMW_CONF_MAX_PRIMITIVES
+#define GMW_CONF_MAX_PRIMITIVES           4
+#endif /* GMW_CONF_MAX_PRIMITIVES */
+
+#if GMW_CONF_MAX_PRIMITIVES < 4 || GMW_CONF_MAX_PRIMITIVES > 256
+#error "invalid value for GMW_CONF_MAX_PRIMITIVES"
+#endif
+
 /**
  * @brief     Enable/disable the use of clock drift compensation.
  *
@@ -494,6 +1012,101 @@
 #define GMW_CONF_MAX_CLOCK_DEV            150
 #endif /* GMW_CONF_MAX_CLOCK_DEV */
 
+/**
+ * @brief     Number of (global time, t_ref) samples kept by the regression
+ *            based drift estimator of the sources.
+ *            CONF value is 0 by default (the drift is estimated from the last
+ *            two control packets).
+ *
+ * @note      The estimator fits the drift and the offset of the local clock
+ *            over the last GMW_CONF_DRIFT_WINDOW received control packets.
+ *            The window is kept when a control packet is missed. The start of
+ *            the next round is predicted from the fit, and the round guard
+ *            time is derived from the fitting error (see
+ *            gmw_statistics_t.t_ref_err), bounded by
+ *            GMW_CONF_DRIFT_T_GUARD_MIN and GMW_CONF_T_GUARD_ROUND.
+ * @note      Each sample takes 4 bytes plus the size of gmw_rtimer_clock_t.
+ */
+#ifndef GMW_CONF_DRIFT_WINDOW
+#define GMW_CONF_DRIFT_WINDOW             0
+#endif /* GMW_CONF_DRIFT_WINDOW */
+
+/**
+ * @brief     Number of samples needed before the fit of the drift estimator
+ *            is used. Until then, GMW_CONF_T_GUARD_ROUND applies.
+ */
+#ifndef GMW_CONF_DRIFT_MIN_SAMPLES
+#define GMW_CONF_DRIFT_MIN_SAMPLES        3
+#endif /* GMW_CONF_DRIFT_MIN_SAMPLES */
+
+/**
+ * @brief     Safety margin added to the estimated error of t_ref to get the
+ *            round guard time, in percent.
+ */
+#ifndef GMW_CONF_DRIFT_GUARD_MARGIN
+#define GMW_CONF_DRIFT_GUARD_MARGIN       100
+#endif /* GMW_CONF_DRIFT_GUARD_MARGIN */
+
+/**
+ * @brief     Lower bound of the round guard time derived by the drift
+ *            estimator, in micro-seconds (us).
+ */
+#ifndef GMW_CONF_DRIFT_T_GUARD_MIN
+#define GMW_CONF_DRIFT_T_GUARD_MIN        100
+#endif /* GMW_CONF_DRIFT_T_GUARD_MIN */
+
+#if GMW_CONF_DRIFT_WINDOW && !GMW_CONF_USE_DRIFT_COMPENSATION
+#error "GMW_CONF_DRIFT_WINDOW requires GMW_CONF_USE_DRIFT_COMPENSATION"
+#endif
+#if GMW_CONF_DRIFT_WINDOW && (GMW_CONF_DRIFT_WINDOW < 2 || \
+    GMW_CONF_DRIFT_WINDOW > 255 || \
+    GMW_CONF_DRIFT_MIN_SAMPLES < 2 || \
+    GMW_CONF_DRIFT_MIN_SAMPLES > GMW_CONF_DRIFT_WINDOW)
+#error "invalid value for GMW_CONF_DRIFT_WINDOW or GMW_CONF_DRIFT_MIN_SAMPLES"
+#endif
+
+/**
+ * @brief     Enable/disable the skip-control mode.
+ *            The host announces in the schedule section (n_skip) that the
+ *            next n_skip rounds reuse the current schedule and period.
+ *            A synced source whose predicted t_ref is accurate enough (see
+ *            GMW_CONF_CONTROL_SKIP_MAX_ERR) does not listen to the control
+ *            slot of these rounds, it only wakes up for the data slots.
+ *
+ * @note      CONF disabled by default.
+ * @note      Requires the regression based drift estimator
+ *            (GMW_CONF_DRIFT_WINDOW) and a schedule section in the control
+ *            (i.e. no GMW_CONF_USE_STATIC_SCHED).
+ * @note      The host application must not change the control during the
+ *            announced rounds. The engine holds back its own changes (n_tx
+ *            adaptation, slot time and gap calibration) until the next
+ *            control slot the sources listen to, and announces n_skip = 0 as
+ *            long as the config or slot config differs from the previous
+ *            announcement. The sources report the skipped control slots with
+ *            GMW_EVT_CONTROL_SKIPPED.
+ */
+#ifndef GMW_CONF_USE_CONTROL_SKIP
+#define GMW_CONF_USE_CONTROL_SKIP         0
+#endif /* GMW_CONF_USE_CONTROL_SKIP */
+
+/**
+ * @brief     Max. estimated error of the predicted t_ref
+ *            (gmw_statistics_t.t_ref_err) for a source to skip a control
+ *            slot, in micro-seconds (us).
+ *
+ * @note      Without the control, the data slots are aligned to the
+ *            predicted t_ref, i.e. its error must be covered by the slot
+ *            guard time.
+ */
+#ifndef GMW_CONF_CONTROL_SKIP_MAX_ERR
+#define GMW_CONF_CONTROL_SKIP_MAX_ERR     (GMW_CONF_T_GUARD_SLOT / 2)
+#endif /* GMW_CONF_CONTROL_SKIP_MAX_ERR */
+
+#if GMW_CONF_USE_CONTROL_SKIP && \
+    (!GMW_CONF_DRIFT_WINDOW || GMW_CONF_USE_STATIC_SCHED)
+#error "GMW_CONF_USE_CONTROL_SKIP requires GMW_CONF_DRIFT_WINDOW and a schedule section"
+#endif
+
 /**
  * @brief     Enable/disable the autoclean feature.
  *            When enabled, the packet buffer (gmw_payload) is memset to 0 after
@@ -505,6 +1118,51 @@
 #define GMW_CONF_USE_AUTOCLEAN            0
 #endif /* GMW_CONF_USE_AUTOCLEAN */
 
+/**
+ * @brief     Enable/disable the latency histograms (gmw_histograms_t in
+ *            gmw_statistics_t): duration of the slot callbacks, flood
+ *            completion time, relay count, round duration and slack.
+ *            Each sample costs a few shifts and an increment, the histograms
+ *            can be taken and reset with gmw_get_histograms().
+ *
+ * @note      CONF disabled by default.
+ * @note      Takes 6 * GMW_CONF_HIST_N_BINS * 2 bytes of RAM.
+ */
+#ifndef GMW_CONF_USE_HISTOGRAMS
+#define GMW_CONF_USE_HISTOGRAMS           0
+#endif /* GMW_CONF_USE_HISTOGRAMS */
+
+/**
+ * @brief     Number of bins per histogram. Bin 0 holds the value 0, bin i the
+ *            values in [2^(i-1), 2^i), the last bin all values above.
+ *            CONF value is 16 by default.
+ */
+#ifndef GMW_CONF_HIST_N_BINS
+#define GMW_CONF_HIST_N_BINS              16
+#endif /* GMW_CONF_HIST_N_BINS */
+
+#if GMW_CONF_HIST_N_BINS < 2 || GMW_CONF_HIST_N_BINS > 32
+#error "invalid value for GMW_CONF_HIST_N_BINS"
+#endif
+
+/**
+ * @brief     Enable/disable the energy accounting per round: the RF and CPU
+ *            on-time is split into control, own TX, used RX, wasted RX and
+ *            idle (gmw_statistics_t.energy_round and energy_total).
+ *
+ * @note      CONF disabled by default.
+ * @note      Requires the cumulative on-times GMW_GET_RF_ON_TIME() and
+ *            GMW_GET_CPU_ON_TIME() in LF ticks, provided by dc-stat
+ *            (DCSTAT_CONF_ON) or by the platform configuration.
+ */
+#ifndef GMW_CONF_USE_ENERGY_STATS
+#define GMW_CONF_USE_ENERGY_STATS         0
+#endif /* GMW_CONF_USE_ENERGY_STATS */
+
+#if GMW_CONF_USE_ENERGY_STATS && !defined(GMW_GET_RF_ON_TIME)
+#error "GMW_CONF_USE_ENERGY_STATS requires GMW_GET_RF_ON_TIME (DCSTAT_CONF_ON)"
+#endif
+
 /**
  * @brief     Enable/disable the use of the noise detection feature.
  *
@@ -46,9 +46,14 @@
  */
 
 /*---------------------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
 #include "contiki.h"
 #include "gmw.h"
 #include "debug-print.h"
+#if GMW_CONF_USE_CONTROL_DELTA
+#include "lib/crc16.h"
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
 /*---------------------------------------------------------------------------*/
 #if GMW_CONF_USE_CONTROL_SLOT_CONFIG
 static const uint8_t slot_times[GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE] = {
@@ -62,10 +67,82 @@ static const uint8_t slot_times[GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE] = {
   GMW_US_TO_SLOT_TIME(GMW_SLOT_TIME_7)
 };
 #endif /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
+/* primitive IDs above 2 are sent after the slot config list */
+#define HAS_EXT_PRIMITIVES  (GMW_CONF_USE_CONTROL_SLOT_CONFIG && \
+                             GMW_CONF_MAX_PRIMITIVES > 4)
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_CONTROL_DELTA
+/* host only: the last sent schedule is the base of the next delta */
+static uint16_t delta_base[GMW_CONF_MAX_SLOTS];
+static uint16_t delta_base_n_slots;
+static uint8_t  delta_base_valid;
+static uint8_t  delta_cnt;          /* rounds since the last full schedule */
+static gmw_config_t delta_config;   /* last config sent by the host */
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
 /*---------------------------------------------------------------------------*/
 static void config_init(  gmw_config_t*   config  );
 static void schedule_init(gmw_schedule_t* schedule);
 /*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_CONTROL_DELTA
+static uint16_t
+schedule_hash(const gmw_schedule_t* schedule)
+{
+  uint16_t n_slots = GMW_SCHED_N_SLOTS(schedule);
+  return crc16_data((const unsigned char*)schedule->slot, n_slots * 2,
+                    n_slots);
+}
+/*---------------------------------------------------------------------------*/
+/* encode the slots that changed w.r.t. the last sent schedule, returns the
+ * number of bytes written to buffer (at most max_len) or 0 if a full schedule
+ * must be sent */
+static uint8_t
+schedule_delta_encode(const gmw_schedule_t* schedule,
+                      uint8_t* buffer,
+                      uint16_t max_len)
+{
+  uint16_t n_slots  = GMW_SCHED_N_SLOTS(schedule);
+  uint16_t full_len = MIN(n_slots * 2 + 1, max_len + 1);
+  uint16_t len      = 3;        /* encoding byte and hash */
+  uint16_t i        = 0;
+  uint16_t hash;
+  uint8_t  n_ranges = 0;
+
+  if(!delta_base_valid || n_slots > 0xff ||
+     delta_cnt >= GMW_CONF_CONTROL_DELTA_FULL_PERIOD) {
+    return 0;
+  }
+  while(i < n_slots) {
+    uint16_t start;
+    if(i < delta_base_n_slots && schedule->slot[i] == delta_base[i]) {
+      i++;
+      continue;
+    }
+    /* range of changed slots (all slots beyond the old schedule changed) */
+    start = i;
+    while(i < n_slots &&
+          (i >= delta_base_n_slots || schedule->slot[i] != delta_base[i])) {
+      i++;
+    }
+    if(n_ranges == GMW_CONTROL_DELTA_MAX_RANGES ||
+       (len + 2 + (i - start) * 2) >= full_len) {
+      return 0;     /* delta is not shorter than the full schedule */
+    }
+    buffer[len]     = (uint8_t)start;
+    buffer[len + 1] = (uint8_t)(i - start);
+    memcpy(&buffer[len + 2], &schedule->slot[start], (i - start) * 2);
+    len += 2 + (i - start) * 2;
+    n_ranges++;
+  }
+  if(len >= full_len) {
+    return 0;
+  }
+  hash = schedule_hash(schedule);
+  buffer[0] = GMW_CONTROL_DELTA_FLAG | n_ranges;
+  memcpy(&buffer[1], &hash, 2);
+  return (uint8_t)len;
+}
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
+/*---------------------------------------------------------------------------*/
 void
 gmw_control_init(gmw_control_t *control)
 {
@@ -87,7 +164,8 @@ gmw_control_init(gmw_control_t *control)
       "sizeof(gmw_slot_config_t) != GMW_CONTROL_SLOT_CONFIG_TYPE_SIZE");
   }
 
-  if(sizeof(gmw_control_t) > GMW_MAX_PKT_LEN) {
+  if((sizeof(gmw_control_t) -
+      GMW_CONF_USE_STATIC_SCHED * sizeof(gmw_schedule_t)) > GMW_MAX_PKT_LEN) {
     DEBUG_PRINT_WARNING("A full control structure does not fit in a packet!");
     DEBUG_PRINT_WARNING("Reduce control size or use static schedule/config.");
   }
@@ -97,38 +175,134 @@ gmw_control_init(gmw_control_t *control)
 #endif /*GMW_CONF_USE_MAGIC_NUMBER*/
 }
 /*---------------------------------------------------------------------------*/
+/* write the full slot list (at most max_len bytes), compressed if this saves
+ * space, and update the flags in the already written schedule section header;
+ * returns NULL if the slot list does not fit */
+static uint8_t*
+slot_list_compile(const gmw_schedule_t* schedule,
+                  uint8_t* header,
+                  uint8_t* buffer,
+                  uint16_t max_len)
+{
+  uint16_t n_slots = GMW_SCHED_N_SLOTS(schedule);
+
+#if GMW_CONF_USE_CONTROL_SCHED_COMPRESSION
+  uint16_t flags = schedule->n_slots;
+  uint16_t compr_len = gmw_sched_compress((const uint8_t*)schedule->slot,
+                                          n_slots, buffer,
+                                          MIN(n_slots * 2, max_len));
+  if(compr_len) {
+    flags |= GMW_CONTROL_SCHED_N_SLOTS_COMPRESSED_MASK;
+  } else {
+    flags &= ~GMW_CONTROL_SCHED_N_SLOTS_COMPRESSED_MASK;
+  }
+  memcpy(header + offsetof(gmw_schedule_t, n_slots), &flags, 2);
+  if(compr_len) {
+    return buffer + compr_len;
+  }
+#endif /* GMW_CONF_USE_CONTROL_SCHED_COMPRESSION */
+
+  if(n_slots * 2 > max_len) {
+    return NULL;
+  }
+  memcpy(buffer, schedule->slot, n_slots * 2);
+  return buffer + n_slots * 2;
+}
+/*---------------------------------------------------------------------------*/
+#if HAS_EXT_PRIMITIVES
+/* number of slots whose primitive ID follows the slot config list */
+static uint16_t
+count_ext_primitives(const gmw_control_t* control, uint16_t n_slots)
+{
+  uint16_t i, cnt = 0;
+  for(i = 0; i < n_slots; i++) {
+    cnt += (control->slot_config[i].primitive ==
+            GMW_CONTROL_SLOT_PRIMITIVE_EXT);
+  }
+  return cnt;
+}
+#endif /* HAS_EXT_PRIMITIVES */
+/*---------------------------------------------------------------------------*/
 uint8_t
 gmw_control_compile_to_buffer(const gmw_control_t* control,
                               uint8_t* buffer,
                               uint8_t len)
 {
-  uint16_t start_address = (uint16_t)buffer;
+  const uint8_t* start_address = buffer;
   uint16_t n_slots       = GMW_SCHED_N_SLOTS(&control->schedule);
+  uint16_t fixed_len     = GMW_CONF_USE_MAGIC_NUMBER;
+  uint16_t slot_list_len;
 
-  if(( sizeof(gmw_control_t)            // size of full control
-      - GMW_CONF_USE_STATIC_SCHED *     // if static sched substract
-        sizeof(gmw_schedule_t)          // size of schedule
-      - GMW_CONF_USE_STATIC_CONFIG *    // if static config substract
-       (sizeof(gmw_config_t)            // size of config plus
-        + (sizeof(gmw_slot_config_t)
-          * GMW_CONF_MAX_SLOTS          // size of slot_config
-          + GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE)  // size of slot_time_list
-        * GMW_CONF_USE_CONTROL_SLOT_CONFIG)) > len) {
+  if(GMW_CONF_MAX_SLOTS < n_slots) {
+    DEBUG_PRINT_ERROR("n_slots is too large (> GMW_CONF_MAX_SLOTS)");
+    return 0;
+  }
+
+  /* length of all sections except the slot list, which is checked once its
+   * (possibly compressed) length is known */
+  if(!GMW_CONF_USE_STATIC_SCHED) {
+    fixed_len += GMW_SCHED_SECTION_HEADER_LEN + GMW_CONF_USE_CONTROL_DELTA;
+  }
+  if(GMW_CONTROL_HAS_CONFIG(control) && !GMW_CONF_USE_STATIC_CONFIG) {
+    fixed_len += GMW_CONFIG_SECTION_HEADER_LEN;
+  }
+#if GMW_CONF_USE_CONTROL_SLOT_CONFIG
+  if(GMW_CONTROL_HAS_SLOT_CONFIG(control) && !GMW_CONF_USE_STATIC_CONFIG) {
+    fixed_len += n_slots + GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE;
+#if HAS_EXT_PRIMITIVES
+    fixed_len += count_ext_primitives(control, n_slots);
+#endif /* HAS_EXT_PRIMITIVES */
+  }
+#endif /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
+#if GMW_CONF_CONTROL_USER_BYTES
+  if(GMW_CONTROL_HAS_USER_BYTES(control)) {
+    fixed_len += GMW_CONF_CONTROL_USER_BYTES;
+  }
+#endif /* GMW_CONF_CONTROL_USER_BYTES */
+  if(fixed_len > len) {
     DEBUG_PRINT_WARNING("Packet buffer too small to send the required control "
                         "information.");
     return 0;
   }
+  slot_list_len = len - fixed_len;
 
   /* schedule section */
   if(!GMW_CONF_USE_STATIC_SCHED) {
-
-    if(GMW_CONF_MAX_SLOTS < n_slots) {
-      DEBUG_PRINT_ERROR("n_slots is too large (>= GMW_CONF_MAX_SLOTS)");
-    }
+    uint8_t* header = buffer;
     memcpy(buffer, &control->schedule, GMW_SCHED_SECTION_HEADER_LEN);
     buffer += GMW_SCHED_SECTION_HEADER_LEN;
-    memcpy(buffer, control->schedule.slot, n_slots * 2);
-    buffer += n_slots * 2;
+#if GMW_CONF_USE_CONTROL_DELTA
+    /* announce a config change together with a full schedule */
+    if(GMW_CONTROL_HAS_CONFIG(control) &&
+       memcmp(&delta_config, &control->config, sizeof(gmw_config_t))) {
+      memcpy(&delta_config, &control->config, sizeof(gmw_config_t));
+      delta_base_valid = 0;
+    }
+    uint8_t delta_len = schedule_delta_encode(&control->schedule, buffer,
+                                              slot_list_len + 1);
+    if(delta_len) {
+      buffer += delta_len;
+      delta_cnt++;
+    } else {
+      *buffer++ = 0;    /* full encoding */
+      buffer = slot_list_compile(&control->schedule, header, buffer,
+                                 slot_list_len);
+      delta_cnt = 0;
+    }
+#else /* GMW_CONF_USE_CONTROL_DELTA */
+    buffer = slot_list_compile(&control->schedule, header, buffer,
+                               slot_list_len);
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
+    if(!buffer) {
+      DEBUG_PRINT_WARNING("Packet buffer too small to send the schedule.");
+      return 0;
+    }
+#if GMW_CONF_USE_CONTROL_DELTA
+    /* the sent schedule is the base for the delta of the next round */
+    delta_base_valid   = 1;
+    memcpy(delta_base, control->schedule.slot, n_slots * 2);
+    delta_base_n_slots = n_slots;
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
   }
 
   /* config section */
@@ -148,6 +322,15 @@ gmw_control_compile_to_buffer(const gmw_control_t* control,
       buffer += n_slots;
       memcpy(buffer, &control->slot_time_list , 8);
       buffer += 8;
+#if HAS_EXT_PRIMITIVES
+      uint16_t i;
+      for(i = 0; i < n_slots; i++) {
+        if(control->slot_config[i].primitive ==
+           GMW_CONTROL_SLOT_PRIMITIVE_EXT) {
+          *buffer++ = control->slot_primitive[i];
+        }
+      }
+#endif /* HAS_EXT_PRIMITIVES */
     }
   }
 #endif /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
@@ -166,13 +349,13 @@ gmw_control_compile_to_buffer(const gmw_control_t* control,
   buffer++;
 #endif /*GMW_CONF_USE_MAGIC_NUMBER*/
 
-  if(!((uint16_t)buffer - start_address)) {
+  if(buffer == start_address) {
     DEBUG_PRINT_WARNING("Control packet contains no payload! Glossy behavior "
                         "undefined.");
     return 1;
 
   } else {
-    return ((uint16_t)buffer - start_address);
+    return (uint8_t)(buffer - start_address);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -195,7 +378,10 @@ gmw_control_decompile_from_buffer(gmw_control_t* control,
                                   uint8_t* buffer,
                                   uint8_t len)
 {
-  uint8_t n_slots = 0;
+  uint16_t n_slots = 0;
+#if GMW_CONF_USE_CONTROL_DELTA
+  uint8_t delta_mismatch = 0;
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
 
   if(( sizeof(gmw_control_t)            // size of full control
       - GMW_CONF_USE_STATIC_SCHED *     // if static sched substract
@@ -205,10 +391,11 @@ gmw_control_decompile_from_buffer(gmw_control_t* control,
        + (sizeof(gmw_slot_config_t)
          * GMW_CONF_MAX_SLOTS           // size of slot_config
          + GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE)  // size of slot_time_list
-       * GMW_CONF_USE_CONTROL_SLOT_CONFIG)) < len) {
+       * GMW_CONF_USE_CONTROL_SLOT_CONFIG)
+      + GMW_CONF_USE_CONTROL_DELTA) < len) {    // slot list encoding
     DEBUG_PRINT_WARNING("Received packet bigger than maximal expected control size.");
     DEBUG_PRINT_MSG_NOW("exp %u, rcv %u",
-                        ( sizeof(gmw_control_t)            // size of full control
+                        (unsigned int)( sizeof(gmw_control_t)            // size of full control
                               - GMW_CONF_USE_STATIC_SCHED *     // if static sched substract
                                 sizeof(gmw_schedule_t)          // size of schedule
                               - GMW_CONF_USE_STATIC_CONFIG *    // if static config substract
@@ -216,7 +403,8 @@ gmw_control_decompile_from_buffer(gmw_control_t* control,
                                + (sizeof(gmw_slot_config_t)
                                  * GMW_CONF_MAX_SLOTS           // size of slot_config
                                  + GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE)  // size of slot_time_list
-                               * GMW_CONF_USE_CONTROL_SLOT_CONFIG)), len );
+                               * GMW_CONF_USE_CONTROL_SLOT_CONFIG)
+                              + GMW_CONF_USE_CONTROL_DELTA), len );
     return 0;
   }
 
@@ -224,7 +412,46 @@ gmw_control_decompile_from_buffer(gmw_control_t* control,
   if(!GMW_CONF_USE_STATIC_SCHED) {
     /*Like this, nothing at all will be sent (not even time and period)*/
     ITERATE_BUFFER(&control->schedule, GMW_SCHED_SECTION_HEADER_LEN, "sched");
-    n_slots = GMW_SCHED_N_SLOTS(&control->schedule);;
+    n_slots = GMW_SCHED_N_SLOTS(&control->schedule);
+    if(n_slots > GMW_CONF_MAX_SLOTS) {
+      /* applies to all encodings of the slot list */
+      DEBUG_PRINT_ERROR("invalid number of slots (%u)", n_slots);
+      return 0;
+    }
+#if GMW_CONF_USE_CONTROL_DELTA
+    uint8_t encoding;
+    ITERATE_BUFFER(&encoding, 1, "encoding");
+    if(encoding & GMW_CONTROL_DELTA_FLAG) {
+      /* apply the changed ranges to the previous schedule */
+      uint16_t hash;
+      uint8_t  range[2];
+      uint8_t  i;
+      ITERATE_BUFFER(&hash, 2, "hash");
+      for(i = 0; i < (encoding & GMW_CONTROL_DELTA_MAX_RANGES); i++) {
+        ITERATE_BUFFER(range, 2, "range");
+        if((uint16_t)range[0] + range[1] > n_slots) {
+          DEBUG_PRINT_ERROR("invalid slot range in delta schedule");
+          return 0;
+        }
+        ITERATE_BUFFER(&control->schedule.slot[range[0]], 2 * range[1],
+                       "range");
+      }
+      delta_mismatch = (schedule_hash(&control->schedule) != hash);
+    } else
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
+#if GMW_CONF_USE_CONTROL_SCHED_COMPRESSION
+    if(GMW_CONTROL_HAS_SCHED_COMPRESSED(control)) {
+      uint16_t compr_len = gmw_sched_uncompress(buffer, len,
+                                            (uint8_t*)control->schedule.slot,
+                                            n_slots);
+      if(!compr_len) {
+        DEBUG_PRINT_ERROR("invalid compressed schedule");
+        return 0;
+      }
+      len    -= compr_len;
+      buffer += compr_len;
+    } else
+#endif /* GMW_CONF_USE_CONTROL_SCHED_COMPRESSION */
     ITERATE_BUFFER(&control->schedule.slot[0], 2*n_slots, "n_slots");
   }
 
@@ -242,6 +469,15 @@ gmw_control_decompile_from_buffer(gmw_control_t* control,
       /*If static config, the slot config is also static*/
       ITERATE_BUFFER(&control->slot_config    , n_slots, "sconfig");
       ITERATE_BUFFER(&control->slot_time_list , 8, "slot_time_list");
+#if HAS_EXT_PRIMITIVES
+      uint16_t i;
+      for(i = 0; i < n_slots; i++) {
+        if(control->slot_config[i].primitive ==
+           GMW_CONTROL_SLOT_PRIMITIVE_EXT) {
+          ITERATE_BUFFER(&control->slot_primitive[i], 1, "sprimitive");
+        }
+      }
+#endif /* HAS_EXT_PRIMITIVES */
     }
   }
 #endif /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
@@ -258,6 +494,14 @@ gmw_control_decompile_from_buffer(gmw_control_t* control,
   ITERATE_BUFFER(&control->magic_number, 1, "magicNb");
 #endif /*GMW_CONF_USE_MAGIC_NUMBER*/
 
+#if GMW_CONF_USE_CONTROL_DELTA
+  if(delta_mismatch) {
+    /* previous schedule unknown, the slot list must not be used */
+    control->schedule.n_slots &= ~GMW_CONTROL_SCHED_N_SLOTS_MASK;
+    return GMW_CONTROL_DELTA_MISMATCH;
+  }
+#endif /* GMW_CONF_USE_CONTROL_DELTA */
+
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -265,12 +509,19 @@ static void
 config_init(gmw_config_t* config)
 {
   config->n_retransmissions    = GMW_CONF_TX_CNT_DATA;
-  config->channel_hopping_mode = 0;
+  config->channel_hopping_mode = GMW_CONF_CHANNEL_HOPPING_MODE;
   config->max_packet_length    = GMW_CONF_MAX_DATA_PKT_LEN +
+                                 GMW_CONF_USE_EARLY_TERMINATION +
                                  GMW_CONF_RF_OVERHEAD;
   config->primitive            = 0;
   config->gap_time             = GMW_US_TO_GAP_TIME(GMW_CONF_T_GAP);
   config->slot_time            = GMW_US_TO_SLOT_TIME(GMW_CONF_T_DATA);
+#if GMW_CONF_USE_AUTO_GAP
+  config->guard_time           = GMW_US_TO_GAP_TIME(GMW_CONF_T_GUARD_SLOT);
+#endif /* GMW_CONF_USE_AUTO_GAP */
+#if GMW_CONF_USE_HOPPING_SEED
+  config->hopping_seed         = GMW_CONF_HOPPING_SEED;
+#endif /* GMW_CONF_USE_HOPPING_SEED */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -279,6 +530,9 @@ schedule_init(gmw_schedule_t* schedule)
   schedule->n_slots             = 0;
   schedule->time                = 0;
   schedule->period              = 5;
+#if GMW_CONF_USE_CONTROL_SKIP
+  schedule->n_skip              = 0;
+#endif /* GMW_CONF_USE_CONTROL_SKIP */
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -49,10 +49,15 @@
 #ifndef GMW_CONTROL_H_
 #define GMW_CONTROL_H_
 
-#define GMW_CONTROL_SCHED_N_SLOTS_MASK              (0x1fff)
+#define GMW_CONTROL_SCHED_N_SLOTS_MASK              (0x0fff)
 #define GMW_CONTROL_SCHED_N_SLOTS_CONFIG_MASK       (0x8000)
 #define GMW_CONTROL_SCHED_N_SLOTS_SLOT_CONFIG_MASK  (0x4000)
 #define GMW_CONTROL_SCHED_N_SLOTS_USER_BYTES_MASK   (0x2000)
+#define GMW_CONTROL_SCHED_N_SLOTS_COMPRESSED_MASK   (0x1000)
+
+#if GMW_CONF_MAX_SLOTS > GMW_CONTROL_SCHED_N_SLOTS_MASK
+#error "GMW_CONF_MAX_SLOTS must not exceed GMW_CONTROL_SCHED_N_SLOTS_MASK"
+#endif
 
 /**
  * @brief                       Return the number of data slots
@@ -65,6 +70,27 @@
  */
 #define GMW_SLOT_CONTENTION     0xffff  /* a contention slot */
 
+/**
+ * @brief                       Encoding of the slot list (first byte after
+ *                              the schedule section header, only if
+ *                              GMW_CONF_USE_CONTROL_DELTA is enabled).
+ *                              Full encoding: 0, followed by all slots.
+ *                              Delta encoding: GMW_CONTROL_DELTA_FLAG | number
+ *                              of ranges, followed by the 16-bit hash of the
+ *                              resulting slot list and the changed ranges
+ *                              (first slot index, number of slots, slots).
+ */
+#define GMW_CONTROL_DELTA_FLAG          0x80
+#define GMW_CONTROL_DELTA_MAX_RANGES    0x7f
+
+/**
+ * @brief                       Return value of
+ *                              gmw_control_decompile_from_buffer() if a
+ *                              delta-encoded schedule could not be applied
+ *                              (the previous schedule is not known).
+ */
+#define GMW_CONTROL_DELTA_MISMATCH      2
+
 /**
  * @brief                       Helpers to set, clear, or check if the control
  *                              packet contains a config section.
@@ -87,6 +113,29 @@
 #define GMW_CONTROL_CLR_SLOT_CONFIG(c)  ((c)->schedule.n_slots &= \
                             ~GMW_CONTROL_SCHED_N_SLOTS_SLOT_CONFIG_MASK)
 
+/**
+ * @brief                       Get or set the primitive ID of a slot in the
+ *                              slot config (constant time).
+ *                              With GMW_CONF_MAX_PRIMITIVES > 4, the IDs above
+ *                              2 are stored in slot_primitive and the slot
+ *                              config holds the escape code
+ *                              GMW_CONTROL_SLOT_PRIMITIVE_EXT.
+ */
+#define GMW_CONTROL_SLOT_PRIMITIVE_EXT  3
+#if GMW_CONF_MAX_PRIMITIVES > 4
+#define GMW_CONTROL_GET_SLOT_PRIMITIVE(c, i) \
+  (((c)->slot_config[i].primitive == GMW_CONTROL_SLOT_PRIMITIVE_EXT) ? \
+   (c)->slot_primitive[i] : (c)->slot_config[i].primitive)
+#define GMW_CONTROL_SET_SLOT_PRIMITIVE(c, i, p) { \
+  (c)->slot_config[i].primitive = MIN((p), GMW_CONTROL_SLOT_PRIMITIVE_EXT); \
+  (c)->slot_primitive[i] = (p); \
+}
+#else /* GMW_CONF_MAX_PRIMITIVES */
+#define GMW_CONTROL_GET_SLOT_PRIMITIVE(c, i)    ((c)->slot_config[i].primitive)
+#define GMW_CONTROL_SET_SLOT_PRIMITIVE(c, i, p) \
+  ((c)->slot_config[i].primitive = (p))
+#endif /* GMW_CONF_MAX_PRIMITIVES */
+
 /**
  * @brief                       Helpers to set, clear, or check if the control
  *                              packet contains user bytes.
@@ -98,6 +147,18 @@
 #define GMW_CONTROL_CLR_USER_BYTES(c)  ((c)->schedule.n_slots &= \
                             ~GMW_CONTROL_SCHED_N_SLOTS_USER_BYTES_MASK)
 
+/**
+ * @brief                       Helpers to set, clear, or check if the slot
+ *                              list in the control packet is compressed
+ *                              (set by gmw_control_compile_to_buffer()).
+ */
+#define GMW_CONTROL_HAS_SCHED_COMPRESSED(c)  (((c)->schedule.n_slots & \
+                            GMW_CONTROL_SCHED_N_SLOTS_COMPRESSED_MASK) > 0)
+#define GMW_CONTROL_SET_SCHED_COMPRESSED(c)  ((c)->schedule.n_slots |= \
+                            GMW_CONTROL_SCHED_N_SLOTS_COMPRESSED_MASK)
+#define GMW_CONTROL_CLR_SCHED_COMPRESSED(c)  ((c)->schedule.n_slots &= \
+                            ~GMW_CONTROL_SCHED_N_SLOTS_COMPRESSED_MASK)
+
 /**
  * @brief                       Initializes the control structure on the
  *                              application side with all default parameters.
@@ -118,6 +179,9 @@ void gmw_control_init(gmw_control_t* control);
  * @note                        The payload size (i.e., sent control
  *                              information) must be at least one byte. Glossy
  *                              does not execute in case of 0-byte payload.
+ * @note                        With GMW_CONF_USE_CONTROL_DELTA, the compiled
+ *                              schedule becomes the base for the delta of the
+ *                              next call (i.e., call once per round).
  */
 uint8_t gmw_control_compile_to_buffer(const gmw_control_t* control,
                                       uint8_t* buffer, 
@@ -129,7 +193,10 @@ uint8_t gmw_control_compile_to_buffer(const gmw_control_t* control,
  * @param control               Pointer to the control struct to be filled
  * @param buffer                Pointer to the received buffer
  * @param len                   of the valid data in buffer
- * @return                      1 if successful, 0 otherwise
+ * @return                      1 if successful, 0 otherwise,
+ *                              GMW_CONTROL_DELTA_MISMATCH if the schedule
+ *                              is delta-encoded and could not be applied
+ *                              (the number of slots is set to zero)
  */
 uint8_t gmw_control_decompile_from_buffer(gmw_control_t* control,
                                           uint8_t* buffer, 
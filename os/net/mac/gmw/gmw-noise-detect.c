@@ -49,6 +49,7 @@
  * \note      Currently supported platforms are:
  *            - TelosB
  *            - DPP-CC430
+ *            - native (the virtual medium is free of noise)
  */
 
 #include "contiki.h"
@@ -90,9 +91,11 @@ PROCESS(gmw_noise_detection, "GMW detect noise");
 PROCESS_THREAD(gmw_noise_detection, ev, data)
 {
 
+#ifndef PLATFORM_NATIVE
   static uint8_t end_noise_detect;
   static uint8_t i;
   static uint8_t max_loop_counter = 1;
+#endif /* PLATFORM_NATIVE */
 
   PROCESS_BEGIN();
 
@@ -182,6 +185,13 @@ PROCESS_THREAD(gmw_noise_detection, ev, data)
       GLOSSY_DETECT_OFF;
     }
 
+#elif defined PLATFORM_NATIVE
+
+    /* there is no noise on the virtual medium, and the flood is executed
+     * within the timer callbacks, i.e. before this task gets to run */
+    counter                 = 0;
+    counter_high_noise      = 0;
+
 #else
   #error "noise detection feature not implemented for the target platform"
 #endif
@@ -217,6 +227,8 @@ gmw_get_rssi_average(void)
   } else {
     return -127;
   }
+#else
+  return -127;
 #endif
 }
 /*---------------------------------------------------------------------------*/
@@ -228,6 +240,8 @@ gmw_get_rssi_high_noise_average(void)
   return 0;
 #elif defined PLATFORM_DPP_CC430
   return (rssi_value_high_noise / counter_high_noise) ;
+#else
+  return -127;
 #endif
 }
 /*---------------------------------------------------------------------------*/
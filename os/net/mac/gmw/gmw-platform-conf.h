@@ -139,6 +139,33 @@
 #define GMW_RTIMER_SECOND               RTIMER_EXT_SECOND_LF
 #endif /* GMW_RTIMER_SECOND */
 
+/* cumulative RF and CPU on-time in LF ticks (GMW_CONF_USE_ENERGY_STATS) */
+#if DCSTAT_CONF_ON
+#ifndef GMW_GET_RF_ON_TIME
+#define GMW_GET_RF_ON_TIME()            DCSTAT_RF_SUM
+#endif /* GMW_GET_RF_ON_TIME */
+#ifndef GMW_GET_CPU_ON_TIME
+#define GMW_GET_CPU_ON_TIME()           ((uint32_t)dc_stat_sum_cpu)
+#endif /* GMW_GET_CPU_ON_TIME */
+#endif /* DCSTAT_CONF_ON */
+
+#ifndef GMW_GET_CPU_ON_TIME
+#define GMW_GET_CPU_ON_TIME()           0
+#endif /* GMW_GET_CPU_ON_TIME */
+
+/* high-frequency clock, only used to measure short durations */
+#ifndef GMW_RTIMER_NOW_HF
+#define GMW_RTIMER_NOW_HF()             rtimer_ext_now_hf()
+#endif /* GMW_RTIMER_NOW_HF */
+
+#ifndef GMW_RTIMER_SECOND_HF
+#define GMW_RTIMER_SECOND_HF            RTIMER_EXT_SECOND_HF
+#endif /* GMW_RTIMER_SECOND_HF */
+
+/* optional: GMW_GET_T_FLOOD_END() returns the time (GMW_RTIMER_NOW) the
+ * primitive turned off the radio after its last transmission in the last
+ * flood, used for the histogram of the flood end (GMW_CONF_USE_HISTOGRAMS) */
+
 /*---------------------------------------------------------------------------*/
 /*--- RADIO MACROS ---*/
 /*---------------------------------------------------------------------------*/
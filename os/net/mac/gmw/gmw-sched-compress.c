@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*---------------------------------------------------------------------------*/
+/**
+ * @addtogroup  gmw
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+
+/**
+ * \file
+ *            Run-length compression of the slot list of a schedule
+ *            (see gmw-sched-compress.h for the format).
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "gmw.h"
+
+#if GMW_CONF_USE_CONTROL_SCHED_COMPRESSION
+/*---------------------------------------------------------------------------*/
+#define COMPR_HEADER_LEN    3
+#define MAX_L_BITS          7
+/*---------------------------------------------------------------------------*/
+static inline uint16_t
+get_slot(const uint8_t* slots, uint16_t idx)
+{
+  uint16_t slot;
+  memcpy(&slot, slots + 2 * idx, 2);
+  return slot;
+}
+/*---------------------------------------------------------------------------*/
+/* zig-zag encoded difference between slot idx and its predecessor */
+static inline uint16_t
+get_delta(const uint8_t* slots, uint16_t idx)
+{
+  int16_t d = (int16_t)(get_slot(slots, idx) - get_slot(slots, idx - 1));
+  return (uint16_t)((d << 1) ^ (d >> 15));
+}
+/*---------------------------------------------------------------------------*/
+static inline uint8_t
+get_min_bits(uint16_t a)
+{
+  uint8_t i = 0;
+  while(a) {
+    a >>= 1;
+    i++;
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/* number of subsequent slots with the same delta as slot idx */
+static inline uint16_t
+get_run_length(const uint8_t* slots, uint16_t idx, uint16_t n_slots)
+{
+  uint16_t z = get_delta(slots, idx);
+  uint16_t run = 1;
+  while((idx + run) < n_slots && get_delta(slots, idx + run) == z) {
+    run++;
+  }
+  return run;
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_bits(uint8_t* buffer, uint16_t* ofs, uint16_t val, uint8_t n_bits)
+{
+  while(n_bits--) {
+    if(val & 1) {
+      buffer[*ofs >> 3] |= (1 << (*ofs & 7));
+    }
+    val >>= 1;
+    (*ofs)++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get_bits(const uint8_t* buffer, uint16_t* ofs, uint8_t n_bits)
+{
+  uint16_t val = 0;
+  uint8_t  i;
+  for(i = 0; i < n_bits; i++) {
+    if(buffer[*ofs >> 3] & (1 << (*ofs & 7))) {
+      val |= (1 << i);
+    }
+    (*ofs)++;
+  }
+  return val;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+gmw_sched_compress(const uint8_t* slots,
+                   uint16_t n_slots,
+                   uint8_t* out,
+                   uint16_t max_len)
+{
+  uint16_t n_runs[MAX_L_BITS + 1] = { 0 };
+  uint16_t z_max = 0;
+  uint32_t bits = 0xffffffff;
+  uint16_t i, run, len, ofs;
+  uint8_t  d_bits, l_bits = 0, lb;
+
+  if(n_slots < 2) {
+    return 0;   /* nothing to gain */
+  }
+
+  /* first pass: find the largest delta and count the runs for each possible
+   * size of the length field (longer runs need to be split) */
+  for(i = 1; i < n_slots; i += run) {
+    run   = get_run_length(slots, i, n_slots);
+    z_max = MAX(z_max, get_delta(slots, i));
+    for(lb = 0; lb <= MAX_L_BITS; lb++) {
+      n_runs[lb] += (run + (1 << lb) - 1) >> lb;
+    }
+  }
+  d_bits = get_min_bits(z_max);
+  for(lb = 0; lb <= MAX_L_BITS; lb++) {
+    if((uint32_t)n_runs[lb] * (d_bits + lb) < bits) {
+      bits   = (uint32_t)n_runs[lb] * (d_bits + lb);
+      l_bits = lb;
+    }
+  }
+  len = COMPR_HEADER_LEN + (uint16_t)((bits + 7) >> 3);
+  if(len >= n_slots * 2 || len > max_len) {
+    return 0;
+  }
+
+  /* second pass: write the runs */
+  memcpy(out, slots, 2);
+  memset(out + 2, 0, len - 2);
+  out[2] = (d_bits << 3) | l_bits;
+  ofs = 0;
+  for(i = 1; i < n_slots; i += run) {
+    uint16_t z = get_delta(slots, i);
+    run = get_run_length(slots, i, n_slots);
+    uint16_t left = run;
+    while(left) {
+      uint16_t chunk = MIN(left, (uint16_t)(1 << l_bits));
+      put_bits(out + COMPR_HEADER_LEN, &ofs, z, d_bits);
+      put_bits(out + COMPR_HEADER_LEN, &ofs, chunk - 1, l_bits);
+      left -= chunk;
+    }
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+gmw_sched_uncompress(const uint8_t* in,
+                     uint16_t len,
+                     uint8_t* slots,
+                     uint16_t n_slots)
+{
+  uint16_t slot, i, ofs = 0;
+  uint8_t  d_bits, l_bits;
+
+  if(n_slots < 2 || len < COMPR_HEADER_LEN) {
+    return 0;
+  }
+  memcpy(&slot, in, 2);
+  memcpy(slots, &slot, 2);
+  d_bits = in[2] >> 3;
+  l_bits = in[2] & 0x07;
+  if(d_bits > 16) {
+    return 0;
+  }
+
+  for(i = 1; i < n_slots; ) {
+    uint16_t z, run;
+    int16_t  d;
+    if(COMPR_HEADER_LEN + ((ofs + d_bits + l_bits + 7) >> 3) > len) {
+      return 0;   /* truncated */
+    }
+    z   = get_bits(in + COMPR_HEADER_LEN, &ofs, d_bits);
+    run = get_bits(in + COMPR_HEADER_LEN, &ofs, l_bits) + 1;
+    d   = (int16_t)((z >> 1) ^ -(z & 1));
+    if(i + run > n_slots) {
+      return 0;
+    }
+    while(run--) {
+      slot += d;
+      memcpy(slots + 2 * i, &slot, 2);
+      i++;
+    }
+  }
+  return COMPR_HEADER_LEN + ((ofs + 7) >> 3);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* GMW_CONF_USE_CONTROL_SCHED_COMPRESSION */
+
+/** @} */
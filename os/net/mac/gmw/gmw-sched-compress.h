@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2018, Swiss Federal Institute of Technology (ETH Zurich).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*---------------------------------------------------------------------------*/
+/**
+ * @addtogroup  gmw
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+
+/**
+ * \file
+ *            Run-length compression of the slot list of a schedule.
+ *
+ *            The slot list is described by the first slot and a sequence of
+ *            runs (delta, length): each of the 'length' following slots is
+ *            'delta' larger than its predecessor. Unlike the LWB schedule
+ *            compression, the slots don't need to be sorted: the deltas are
+ *            signed (zig-zag encoded), and contention slots
+ *            (GMW_SLOT_CONTENTION, i.e. -1) cost only a few bits.
+ *
+ *            Format: first slot (2 bytes), number of bits per delta (upper
+ *            5 bits) and per run length (lower 3 bits), followed by the
+ *            bit-packed runs.
+ */
+
+#ifndef GMW_SCHED_COMPRESS_H_
+#define GMW_SCHED_COMPRESS_H_
+
+/**
+ * @brief                       Compress a slot list
+ * @param slots                 The slots (n_slots 16-bit values, may be
+ *                              unaligned)
+ * @param n_slots               Number of slots
+ * @param out                   Output buffer
+ * @param max_len               Size of the output buffer
+ * @return                      The length of the compressed slot list, or 0
+ *                              if it is not shorter than the uncompressed
+ *                              list or does not fit into the output buffer
+ */
+uint16_t gmw_sched_compress(const uint8_t* slots,
+                            uint16_t n_slots,
+                            uint8_t* out,
+                            uint16_t max_len);
+
+/**
+ * @brief                       Uncompress a slot list
+ * @param in                    The compressed slot list
+ * @param len                   Number of valid bytes in the input buffer
+ * @param slots                 Output buffer (n_slots 16-bit values, may be
+ *                              unaligned)
+ * @param n_slots               Number of slots
+ * @return                      The number of bytes read from the input
+ *                              buffer, or 0 if the input is invalid
+ */
+uint16_t gmw_sched_uncompress(const uint8_t* in,
+                              uint16_t len,
+                              uint8_t* slots,
+                              uint16_t n_slots);
+
+#endif /* GMW_SCHED_COMPRESS_H_ */
+
+/** @} */
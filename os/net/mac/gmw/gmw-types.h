@@ -59,24 +59,29 @@
  *                              which sections are included in the current
  *                              control (see gmw-control.h).
  */
-#define GMW_SCHED_SECTION_HEADER_LEN    (8)
+#define GMW_SCHED_SECTION_HEADER_LEN    (8 + GMW_CONF_USE_CONTROL_SKIP)
 typedef struct __attribute__((packed)) gmw_schedule {
   uint32_t time;                  /* multiple of GMW_CONF_PERIOD_TIME_BASE */
   uint16_t period;                /* multiple of GMW_CONF_PERIOD_TIME_BASE */
   uint16_t n_slots;
+#if GMW_CONF_USE_CONTROL_SKIP
+  uint8_t  n_skip;                /* number of following rounds with the same
+                                   * schedule and period, in which synced
+                                   * sources may skip the control slot */
+#endif /* GMW_CONF_USE_CONTROL_SKIP */
   uint16_t slot[GMW_CONF_MAX_SLOTS];
 } gmw_schedule_t;
 
 /**
  * @brief                       Config section structure.
  */
-#define GMW_CONFIG_SECTION_HEADER_LEN   (6)
+#define GMW_CONFIG_SECTION_HEADER_LEN   (6 + GMW_CONF_USE_AUTO_GAP + \
+                                         GMW_CONF_USE_HOPPING_SEED)
 typedef struct __attribute__((packed)) gmw_config {
   uint8_t n_retransmissions;
   uint8_t channel_hopping_mode; /*
                                  * not, per slot, or in flood
                                  * (see gmw_hopping_mode_t)
-                                 * /!\ NOT IMPLEMENTED YET /!\
                                  */
   uint8_t max_packet_length;    /*
                                  * Max packet size (at rf level)
@@ -85,6 +90,12 @@ typedef struct __attribute__((packed)) gmw_config {
   uint8_t primitive;            /* ID of the primitive to use (0 is Glossy) */
   uint8_t gap_time;             /* Gap time in increments of 100 us */
   uint8_t slot_time;            /* Slot time in increments of 500 us */
+#if GMW_CONF_USE_AUTO_GAP
+  uint8_t guard_time;           /* Slot guard time in increments of 100 us */
+#endif /* GMW_CONF_USE_AUTO_GAP */
+#if GMW_CONF_USE_HOPPING_SEED
+  uint8_t hopping_seed;         /* Seed of the per-slot hopping sequence */
+#endif /* GMW_CONF_USE_HOPPING_SEED */
 } gmw_config_t;
 
 /**
@@ -95,7 +106,9 @@ typedef struct __attribute__((packed)) gmw_config {
 typedef struct __attribute__((packed)) gmw_slot_config {
   uint8_t n_retransmissions : 3;
   uint8_t slot_time_select  : 3; /* ID of desired slot time (see slot_times)*/
-  uint8_t primitive         : 2; /* ID of the primitive to use (0 is Glossy) */
+  uint8_t primitive         : 2; /* ID of the primitive to use (0 is Glossy),
+                                  * see GMW_CONTROL_SET_SLOT_PRIMITIVE() for
+                                  * IDs above 2 */
 } gmw_slot_config_t;
 
 /**
@@ -108,6 +121,7 @@ typedef struct __attribute__((packed)) gmw_slot_config {
  *                              - GMW_CONF_USE_MAGIC_NUMBER
  *                              - GMW_CONF_MAX_SLOTS
  *                              - GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE
+ *                              - GMW_CONF_MAX_PRIMITIVES
  */
 typedef struct __attribute__((packed)) gmw_control {
   gmw_schedule_t schedule;
@@ -115,6 +129,11 @@ typedef struct __attribute__((packed)) gmw_control {
 #if GMW_CONF_USE_CONTROL_SLOT_CONFIG
   gmw_slot_config_t   slot_config[GMW_CONF_MAX_SLOTS];
   uint8_t             slot_time_list[GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE];
+#if GMW_CONF_MAX_PRIMITIVES > 4
+  /* primitive ID of the slots whose slot_config.primitive is
+   * GMW_CONTROL_SLOT_PRIMITIVE_EXT */
+  uint8_t             slot_primitive[GMW_CONF_MAX_SLOTS];
+#endif /* GMW_CONF_MAX_PRIMITIVES */
 #endif /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
 #if GMW_CONF_CONTROL_USER_BYTES
   uint8_t user_bytes[GMW_CONF_CONTROL_USER_BYTES];
@@ -134,6 +153,85 @@ typedef struct gmw_pre_post_processes {
 } gmw_pre_post_processes_t;
 /*---------------------------------------------------------------------------*/
 
+/**
+ * @brief                       Latency histograms (GMW_CONF_USE_HISTOGRAMS).
+ *                              Log2 bins (see GMW_CONF_HIST_N_BINS), except
+ *                              for relay_cnt which has one bin per value.
+ *                              The counters saturate at 0xffff.
+ */
+typedef struct {
+  uint16_t slot_pre[GMW_CONF_HIST_N_BINS];  /* on_slot_pre duration in us */
+  uint16_t slot_post[GMW_CONF_HIST_N_BINS]; /* on_slot_post duration in us */
+  uint16_t flood_end[GMW_CONF_HIST_N_BINS]; /* end of a received flood
+                                             * (Glossy) relative to the slot
+                                             * start in us, measured with
+                                             * GMW_GET_T_FLOOD_END() if the
+                                             * platform provides it, modeled
+                                             * otherwise */
+  uint16_t relay_cnt[GMW_CONF_HIST_N_BINS]; /* relay count of the first rx
+                                             * (hop distance to the initiator)
+                                             * in received slots */
+  uint16_t round[GMW_CONF_HIST_N_BINS];     /* round duration in ms */
+  uint16_t slack[GMW_CONF_HIST_N_BINS];     /* end of round to the wake-up
+                                             * for the next round in ms */
+} gmw_histograms_t;
+
+/**
+ * @brief                       Energy classes (GMW_CONF_USE_ENERGY_STATS)
+ */
+typedef enum {
+  GMW_ENERGY_CONTROL = 0,       /* control slots (incl. bootstrap) */
+  GMW_ENERGY_TX,                /* data slots initiated by this node */
+  GMW_ENERGY_RX_USED,           /* data slots with a packet received */
+  GMW_ENERGY_RX_WASTED,         /* data slots with silence, garbage or a
+                                 * corrupted packet */
+  GMW_ENERGY_IDLE,              /* outside of the slots */
+  NUM_OF_GMW_ENERGY_CLASSES
+} gmw_energy_class_t;
+
+/**
+ * @brief                       RF and CPU on-time per energy class, in LF
+ *                              ticks (GMW_RTIMER_SECOND), and the delivered
+ *                              data payload bytes.
+ */
+typedef struct {
+  uint32_t rf_on[NUM_OF_GMW_ENERGY_CLASSES];
+  uint32_t cpu_on[NUM_OF_GMW_ENERGY_CLASSES];
+  uint32_t bytes_sent;      /* payload of the initiated data floods */
+  uint32_t bytes_rcvd;      /* payload of the received data floods */
+} gmw_energy_t;
+
+/**
+ * @brief                       State of an initiator learned by the adaptive
+ *                              N_TX controller of the host
+ *                              (see GMW_CONF_USE_ADAPTIVE_N_TX)
+ */
+typedef struct {
+  uint16_t node_id;         /* the initiator */
+  uint16_t loss;            /* flood loss rate (moving average), 1/65536 */
+  uint8_t  n_tx;            /* current number of retransmissions, 0 = entry
+                             * not in use */
+  uint8_t  hold;            /* successful floods since the last change */
+  uint8_t  relay_min;       /* smallest relay count seen at the host */
+  uint8_t  relay_avg;       /* relay count (moving average), 1/16 */
+} gmw_n_tx_state_t;
+
+/**
+ * @brief                       Timing report of a source, feeds the gap and
+ *                              guard calibration of the host
+ *                              (see GMW_CONF_USE_AUTO_GAP)
+ */
+#define GMW_TIMING_REPORT_LEN       4
+#define GMW_TIMING_DRIFT_UNKNOWN    INT8_MIN
+typedef struct __attribute__((packed)) gmw_timing_report {
+  uint16_t t_gap_used;      /* max. time in us from the (nominal) end of a
+                             * slot until the source was ready for the next */
+  int8_t   drift;           /* estimated clock drift in ppm (saturated),
+                             * GMW_TIMING_DRIFT_UNKNOWN if not estimated */
+  uint8_t  n_missed;        /* slots missed since the last report
+                             * (saturated) */
+} gmw_timing_report_t;
+
 /**
  * @brief                       Statistics structure
  */
@@ -153,10 +251,34 @@ typedef struct {
   uint16_t pkt_silence_cnt; /* total number of slots with expected packets
                              * but nothing on the channel */
   uint16_t t_proc_max;      /* max. time needed to process rcvd data pkts */
+  uint16_t t_gap_used_max;  /* max. time in us from the (nominal) end of a
+                             * slot until the node is ready for the next */
+  uint16_t t_ref_err;       /* estimated error of the predicted start of the
+                             * next round in us (0xffff = unknown), only
+                             * set if GMW_CONF_DRIFT_WINDOW is enabled */
   uint32_t t_round_max;     /* longest round duration in ms */
   uint32_t t_round_last;    /* latest round duration in LF ticks */
   uint32_t t_slack_min;     /* shortest slack time (end of current round to
                              * start of next round) in ms */
+  uint32_t slot_sleep_cnt;  /* total number of data slots slept through
+                             * due to the interest mask */
+  uint32_t slot_saved_cnt;  /* total number of data slots saved by early
+                             * round termination */
+  uint16_t n_tx_inc_cnt;    /* number of times the adaptive N_TX of an
+                             * initiator was raised */
+  uint16_t n_tx_dec_cnt;    /* ... and lowered */
+  uint32_t t_bootstrap_last;   /* time from losing the synchronization
+                                * until the next round joined, in ms */
+  uint32_t t_bootstrap_listen; /* total time spent listening for a control
+                                * packet while bootstrapping, in LF ticks */
+#if GMW_CONF_USE_HISTOGRAMS
+  gmw_histograms_t hist;
+#endif /* GMW_CONF_USE_HISTOGRAMS */
+#if GMW_CONF_USE_ENERGY_STATS
+  gmw_energy_t energy_round;  /* last round (from the end of the previous
+                               * round to the end of this round) */
+  gmw_energy_t energy_total;  /* sum of all rounds */
+#endif /* GMW_CONF_USE_ENERGY_STATS */
   /* crc must be the last element! */
   uint16_t crc;             /* crc of this struct (without the crc) */
 } gmw_statistics_t;
@@ -185,6 +307,13 @@ typedef enum {
 typedef enum {
   GMW_EVT_CONTROL_RCVD = 0,
   GMW_EVT_CONTROL_MISSED,
+  GMW_EVT_CONTROL_SKIPPED,      /* not received on purpose, the schedule of
+                                 * the last control is reused (see
+                                 * GMW_CONF_USE_CONTROL_SKIP) */
+  GMW_EVT_CONTROL_PARTIAL,      /* received (t_ref is valid), but the
+                                 * delta-encoded slot list could not be
+                                 * applied: the round has no data slots (see
+                                 * GMW_CONF_USE_CONTROL_DELTA) */
   GMW_NUM_OF_SYNC_EVENTS
 } gmw_sync_event_t;
 
@@ -232,15 +361,52 @@ typedef enum {
 /**
  * @brief                       GMW channel hopping mode
  *
- * @note                        Not implemented so far.
+ * @note                        With GMW_PER_SLOT_HOPPING, the channel of each
+ *                              data slot is selected by the middleware (see
+ *                              GMW_CONF_HOPPING_CHANNELS).
+ *                              With GMW_IN_FLOOD_HOPPING, the data slots use
+ *                              the primitive GMW_PRIM_GLOSSY_HOPPING, which
+ *                              switches the channel after each relay step.
+ *                              The primitive can also be selected for single
+ *                              slots in the slot config.
+ * @note                        Only the native platform provides
+ *                              GMW_PRIM_GLOSSY_HOPPING (requires
+ *                              GMW_CONF_USE_MULTI_PRIMITIVES). Elsewhere,
+ *                              the build fails if GMW_CONF_CHANNEL_HOPPING_MODE
+ *                              selects GMW_IN_FLOOD_HOPPING, and a config
+ *                              that selects it at runtime is reported as an
+ *                              error and uses the config's primitive.
  */
 typedef enum {
   GMW_NO_HOPPING = 0,          /* No channel hopping */
   GMW_PER_SLOT_HOPPING = 1,    /* Channel is fixed for a given flood */
-  GMW_IN_FLOOD_HOPPING = 2     /* Channel can hop during a Glossy flood
-                                * -> Not yet implemented */
+  GMW_IN_FLOOD_HOPPING = 2     /* Channel hops during a Glossy flood */
 } gmw_hopping_mode_t;
 
+/*---------------------------------------------------------------------------*/
+/*--- Synchronous transmission primitives ---*/
+
+/**
+ * @brief                       Interface of a synchronous transmission
+ *                              primitive (see gmw_register_primitive()).
+ *
+ * @note                        start() has the same arguments as glossy_start()
+ *                              (initiator ID, payload, payload length, max.
+ *                              number of transmissions, sync, RF calibration).
+ *                              The getters return the outcome of the last
+ *                              execution and are called after stop().
+ */
+typedef struct gmw_primitive {
+  void    (*start)(uint16_t initiator_id, uint8_t* payload,
+                   uint8_t payload_len, uint8_t n_tx_max, uint8_t with_sync,
+                   uint8_t rf_cal);
+  void    (*stop)(void);
+  uint8_t (*get_payload_len)(void);
+  uint8_t (*get_n_rx)(void);
+  uint8_t (*get_n_rx_started)(void);
+  uint8_t (*get_relay_cnt)(void);   /* relay count of the first reception */
+} gmw_primitive_t;
+
 /*---------------------------------------------------------------------------*/
 /*--- Callback functions ---*/
 /*---------------------------------------------------------------------------*/
@@ -278,13 +444,72 @@ typedef gmw_sync_state_t (*gmw_on_control_slot_post_callback)(
  *                              should be executed or skipped/
  */
 typedef gmw_skip_event_t (*gmw_on_slot_pre_callback)(
-                      uint8_t   slot_index,
+                      uint16_t  slot_index,
                       uint16_t  slot_assignee,
                       uint8_t*  out_len,
                       uint8_t*  out_payload,
                       uint8_t   is_initiator,
                       uint8_t   is_contention_slot);
 
+/**
+ * @brief                       Payload of one data slot, prepared in advance
+ *                              by the on_round_pre callback.
+ */
+typedef struct gmw_slot_payload {
+  uint16_t  slot_index;
+  uint8_t   len;
+  uint8_t   payload[GMW_CONF_MAX_DATA_PKT_LEN +
+                    GMW_CONF_USE_EARLY_TERMINATION];  /* + flags */
+} gmw_slot_payload_t;
+
+/**
+ * @brief                       Called once per round, right after the
+ *                              control slot, to prepare the payloads of all
+ *                              slots the node wants to initiate.
+ *                              Only used if GMW_CONF_MAX_ROUND_PRE_SLOTS > 0.
+ * @param control               Pointer to the control of the upcoming round.
+ * @param out_payloads          Table to fill, in ascending order of the
+ *                              slot index, with one entry per slot to
+ *                              initiate (own slots and contention slots).
+ * @param max_payloads          Size of the table
+ *                              (GMW_CONF_MAX_ROUND_PRE_SLOTS).
+ * @return                      Number of entries written to out_payloads.
+ *
+ * @note                        Slots with an entry in out_payloads are sent
+ *                              without calling on_slot_pre. An own slot
+ *                              without an entry is skipped. on_slot_pre is
+ *                              still called for all other slots, unless it is
+ *                              NULL.
+ */
+typedef uint8_t (*gmw_on_round_pre_callback)(
+              const gmw_control_t*  control,
+              gmw_slot_payload_t*   out_payloads,
+              uint8_t               max_payloads);
+
+/**
+ * @brief                       Length of the interest mask in bytes
+ *                              (one bit per slot).
+ */
+#define GMW_INTEREST_MASK_LEN   ((GMW_CONF_MAX_SLOTS + 7) / 8)
+
+/**
+ * @brief                       Called once per round, right after the
+ *                              control slot (and after on_round_pre), to
+ *                              select the data slots the node takes part in.
+ *                              Only used if GMW_CONF_USE_INTEREST_MASK is set.
+ * @param control               Pointer to the control of the upcoming round.
+ * @param out_mask              Interest mask, initially all zeros. Set bit
+ *                              (slot_index & 7) of byte (slot_index >> 3) for
+ *                              each slot to receive, relay or contend in.
+ *
+ * @note                        Own slots are always executed. All other
+ *                              slots without interest are skipped without
+ *                              calling on_slot_pre and on_slot_post.
+ */
+typedef void (*gmw_on_round_interest_callback)(
+              const gmw_control_t*  control,
+              uint8_t*              out_mask);
+
 /**
  * @brief                       Called after a data slot to process the
  *                              received data.
@@ -306,7 +531,7 @@ typedef gmw_skip_event_t (*gmw_on_slot_pre_callback)(
  *                              repeated after this slot.
  */
 typedef gmw_repeat_event_t (*gmw_on_slot_post_callback)(
-                       uint8_t  slot_index,
+                       uint16_t slot_index,
                        uint16_t slot_assignee,
                        uint8_t  len,
                        uint8_t* payload,
@@ -347,6 +572,8 @@ typedef struct gmw_protocol_impl {
   gmw_on_slot_post_callback             on_slot_post;
   gmw_on_round_finish_callback          on_round_finished;
   gmw_on_bootstrap_timeout_callback     on_bootstrap_timeout;
+  gmw_on_round_pre_callback             on_round_pre;   /* optional */
+  gmw_on_round_interest_callback        on_round_interest; /* optional */
 } gmw_protocol_impl_t;
 
 /** @} */
@@ -58,6 +58,12 @@
 #include "node-id.h"
 #include "debug-print.h"
 #include "gpio.h"
+#include "dc-stat.h"
+#include "lib/random.h"
+#include "lib/assert.h"
+#if GMW_CONF_USE_CONTROL_SKIP
+#include "lib/crc16.h"
+#endif /* GMW_CONF_USE_CONTROL_SKIP */
 
 #if CUSTOM
 #include "custom_config.h"
@@ -107,7 +113,7 @@
  *            (column) and the latest event (row)
  * @note      undefined transitions force the SM to go back into bootstrap!
  */
-#define NUM_OF_SYNC_EVENTS      (2)
+#define NUM_OF_SYNC_EVENTS      (4)
 #define NUM_OF_SYNC_STATES      (3)
 
 static const
@@ -115,7 +121,9 @@ gmw_sync_state_t next_state[NUM_OF_SYNC_EVENTS][NUM_OF_SYNC_STATES] =
 {/* STATES:                                              EVENTS:         */
  /* BOOTSTRAP,      RUNNING,        SUSPENDED,                           */
   { GMW_RUNNING,    GMW_RUNNING,    GMW_RUNNING,   }, /* schedule rcvd   */
-  { GMW_BOOTSTRAP,  GMW_SUSPENDED,  GMW_BOOTSTRAP, }  /* schedule missed */
+  { GMW_BOOTSTRAP,  GMW_SUSPENDED,  GMW_BOOTSTRAP, }, /* schedule missed */
+  { GMW_BOOTSTRAP,  GMW_RUNNING,    GMW_BOOTSTRAP, }, /* control skipped */
+  { GMW_SUSPENDED,  GMW_RUNNING,    GMW_RUNNING,   }  /* schedule unknown */
 };
 /*---------------------------------------------------------------------------*/
 /* @brief     Macros assessing the outcome of a transmission */
@@ -183,35 +191,58 @@ gmw_sync_state_t next_state[NUM_OF_SYNC_EVENTS][NUM_OF_SYNC_STATES] =
 /**
  * @brief     Macros to send and receive control and data slots.
  */
+/* the dynamic control time only applies to the host, see
+ * GMW_CONF_USE_DYNAMIC_T_CONTROL */
+#if GMW_CONF_USE_DYNAMIC_T_CONTROL
+  #define GMW_T_CONTROL_HOST    GMW_T_CONTROL(control_len)
+#else /* GMW_CONF_USE_DYNAMIC_T_CONTROL */
+  #define GMW_T_CONTROL_HOST    GMW_CONF_T_CONTROL
+#endif /* GMW_CONF_USE_DYNAMIC_T_CONTROL */
+
+/* guard time of the control slot and listening time of the sources */
+#if GMW_CONF_DRIFT_WINDOW
+  #define GMW_T_GUARD_ROUND     t_guard_round
+  #define GMW_T_CONTROL_LISTEN  (GMW_US_TO_TICKS(GMW_CONF_T_CONTROL) + \
+                                 t_guard_round)
+#else /* GMW_CONF_DRIFT_WINDOW */
+  #define GMW_T_GUARD_ROUND     GMW_US_TO_TICKS(GMW_CONF_T_GUARD_ROUND)
+  #define GMW_T_CONTROL_LISTEN  GMW_US_TO_TICKS(GMW_CONF_T_CONTROL + \
+                                                GMW_CONF_T_GUARD_ROUND)
+#endif /* GMW_CONF_DRIFT_WINDOW */
+
 #define GMW_SEND_CONTROL() \
 {\
   GMW_GPIO_CONTROL_SEND_START();\
+  GMW_ENERGY_START();\
   GMW_START(node_id, gmw_payload, control_len, \
             GMW_CONF_TX_CNT_CONTROL, GMW_WITH_SYNC,\
             GMW_WITH_RF_CAL);\
   GMW_NOISE_DETECTION();\
-  GMW_WAIT_UNTIL(rt->time + GMW_US_TO_TICKS(GMW_CONF_T_CONTROL));\
+  GMW_WAIT_UNTIL(rt->time + GMW_US_TO_TICKS(GMW_T_CONTROL_HOST));\
   GMW_GPIO_CONTROL_SEND_END(); \
   GMW_STOP();\
+  GMW_ENERGY_STOP(GMW_ENERGY_CONTROL);\
 }
 
 #define GMW_RCV_CONTROL() \
 {\
   GMW_GPIO_CONTROL_RECV_START(); \
+  GMW_ENERGY_START();\
   GMW_START(GMW_UNKNOWN_INITIATOR, gmw_payload, 0, \
             GMW_CONF_TX_CNT_CONTROL, GMW_WITH_SYNC, \
             GMW_WITH_RF_CAL);\
   GMW_NOISE_DETECTION();\
-  GMW_WAIT_UNTIL(rt->time + \
-              GMW_US_TO_TICKS(GMW_CONF_T_CONTROL + GMW_CONF_T_GUARD_ROUND)); \
+  GMW_WAIT_UNTIL(rt->time + GMW_T_CONTROL_LISTEN); \
   GMW_GPIO_CONTROL_RECV_END(); \
   GMW_STOP();\
+  GMW_ENERGY_STOP(GMW_ENERGY_CONTROL);\
 }
 
 #define GMW_SEND_PACKET() \
 {\
   GMW_GPIO_PACKET_SEND_START(); \
-  GMW_START_PRIM(node_id, gmw_payload, payload_len, \
+  GMW_ENERGY_START();\
+  GMW_START_PRIM(node_id, slot_payload, payload_len, \
                  GMW_CONTROL_GET_SLOT_CONFIG_N_RETRANS(&control, slot_idx), \
                  GMW_WITHOUT_SYNC, GMW_WITHOUT_RF_CAL);\
   GMW_NOISE_DETECTION();\
@@ -220,16 +251,23 @@ gmw_sync_state_t next_state[NUM_OF_SYNC_EVENTS][NUM_OF_SYNC_STATES] =
   GMW_STOP_PRIM();\
 }
 
+/* guard time of the data slots */
+#if GMW_CONF_USE_AUTO_GAP
+#define GMW_T_GUARD_SLOT  GMW_GAP_TIME_TO_TICKS(current_config->guard_time)
+#else /* GMW_CONF_USE_AUTO_GAP */
+#define GMW_T_GUARD_SLOT  GMW_US_TO_TICKS(GMW_CONF_T_GUARD_SLOT)
+#endif /* GMW_CONF_USE_AUTO_GAP */
+
 #define GMW_RCV_PACKET() \
 {\
   GMW_GPIO_PACKET_RECV_START(); \
+  GMW_ENERGY_START();\
   GMW_START_PRIM(GMW_UNKNOWN_INITIATOR, gmw_payload, \
                  payload_len, \
                  GMW_CONTROL_GET_SLOT_CONFIG_N_RETRANS(&control, slot_idx), \
                  GMW_WITHOUT_SYNC, GMW_WITHOUT_RF_CAL);\
   GMW_NOISE_DETECTION();\
-  GMW_WAIT_UNTIL(rt->time + current_slot_time + \
-                 GMW_US_TO_TICKS(GMW_CONF_T_GUARD_SLOT));\
+  GMW_WAIT_UNTIL(rt->time + current_slot_time + GMW_T_GUARD_SLOT);\
   GMW_GPIO_PACKET_RECV_END();\
   GMW_STOP_PRIM();\
 }
@@ -251,8 +289,12 @@ gmw_sync_state_t next_state[NUM_OF_SYNC_EVENTS][NUM_OF_SYNC_STATES] =
 #endif /* GMW_AFTER_DEEPSLEEP */
 /*---------------------------------------------------------------------------*/
 /**
- * @brief     Macros used to support different synchronous transmission
- *            primitives
+ * @brief     Support of different synchronous transmission primitives: each
+ *            primitive is described by a vtable (gmw_primitive_t), the
+ *            primitive ID of a slot is the index into the primitive table.
+ *            The primitives 0 to 3 provided by the platform configuration
+ *            (GMW_START_PRIM0 etc.) are registered by default, others can be
+ *            added with gmw_register_primitive().
  */
 #if GMW_CONF_USE_MULTI_PRIMITIVES
   #ifndef GMW_START_PRIM0
@@ -263,76 +305,93 @@ gmw_sync_state_t next_state[NUM_OF_SYNC_EVENTS][NUM_OF_SYNC_STATES] =
     #define GMW_GET_N_RX_STARTED_PRIM0()        GMW_GET_N_RX_STARTED()
     #define GMW_GET_RELAY_CNT_FIRST_RX_PRIM0()  GMW_GET_RELAY_CNT_FIRST_RX()
   #endif /* GMW_START_PRIM0 */
-  #ifndef GMW_START_PRIM1
-    #define GMW_START_PRIM1(a, b, c, d, e, f)
-    #define GMW_STOP_PRIM1()
-    #define GMW_GET_PAYLOAD_LEN_PRIM1()         0
-    #define GMW_GET_N_RX_PRIM1()                0
-    #define GMW_GET_N_RX_STARTED_PRIM1()        0
-    #define GMW_GET_RELAY_CNT_FIRST_RX_PRIM1()  GMW_RELAY_COUNT_UNDEF
+
+  /* wraps the platform macros of a built-in primitive into a vtable */
+  #define GMW_PRIM_VTABLE(n) \
+    static void \
+    prim##n##_start(uint16_t initiator_id, uint8_t* payload, \
+                    uint8_t payload_len, uint8_t n_tx_max, uint8_t sync, \
+                    uint8_t rf_cal) \
+    { \
+      GMW_START_PRIM##n(initiator_id, payload, payload_len, n_tx_max, sync, \
+                        rf_cal); \
+    } \
+    static void prim##n##_stop(void) \
+    { GMW_STOP_PRIM##n(); } \
+    static uint8_t prim##n##_get_payload_len(void) \
+    { return GMW_GET_PAYLOAD_LEN_PRIM##n(); } \
+    static uint8_t prim##n##_get_n_rx(void) \
+    { return GMW_GET_N_RX_PRIM##n(); } \
+    static uint8_t prim##n##_get_n_rx_started(void) \
+    { return GMW_GET_N_RX_STARTED_PRIM##n(); } \
+    static uint8_t prim##n##_get_relay_cnt(void) \
+    { return GMW_GET_RELAY_CNT_FIRST_RX_PRIM##n(); } \
+    static const gmw_primitive_t prim##n = { \
+      prim##n##_start, prim##n##_stop, prim##n##_get_payload_len, \
+      prim##n##_get_n_rx, prim##n##_get_n_rx_started, \
+      prim##n##_get_relay_cnt \
+    };
+
+  GMW_PRIM_VTABLE(0)
+  #ifdef GMW_START_PRIM1
+  GMW_PRIM_VTABLE(1)
   #endif /* GMW_START_PRIM1 */
-  #ifndef GMW_START_PRIM2
-    #define GMW_START_PRIM2(a, b, c, d, e, f)
-    #define GMW_STOP_PRIM2()
-    #define GMW_GET_PAYLOAD_LEN_PRIM2()         0
-    #define GMW_GET_N_RX_PRIM2()                0
-    #define GMW_GET_N_RX_STARTED_PRIM2()        0
-    #define GMW_GET_RELAY_CNT_FIRST_RX_PRIM2()  GMW_RELAY_COUNT_UNDEF
+  #ifdef GMW_START_PRIM2
+  GMW_PRIM_VTABLE(2)
   #endif /* GMW_START_PRIM2 */
-  #ifndef GMW_START_PRIM3
-    #define GMW_START_PRIM3(a, b, c, d, e, f)
-    #define GMW_STOP_PRIM3()
-    #define GMW_GET_PAYLOAD_LEN_PRIM3()         0
-    #define GMW_GET_N_RX_PRIM3()                0
-    #define GMW_GET_N_RX_STARTED_PRIM3()        0
-    #define GMW_GET_RELAY_CNT_FIRST_RX_PRIM3()  GMW_RELAY_COUNT_UNDEF
+  #ifdef GMW_START_PRIM3
+  GMW_PRIM_VTABLE(3)
   #endif /* GMW_START_PRIM3 */
 
+  /* primitive table, indexed by the primitive ID (NULL = not available) */
+  static const gmw_primitive_t* primitives[GMW_CONF_MAX_PRIMITIVES] = {
+    [0] = &prim0,
+  #ifdef GMW_START_PRIM1
+    [1] = &prim1,
+  #endif /* GMW_START_PRIM1 */
+  #ifdef GMW_START_PRIM2
+    [2] = &prim2,
+  #endif /* GMW_START_PRIM2 */
+  #ifdef GMW_START_PRIM3
+    [3] = &prim3,
+  #endif /* GMW_START_PRIM3 */
+  };
+  static const gmw_primitive_t* current_prim;
+
+  #ifdef GMW_PRIM_GLOSSY_HOPPING
+    /* in-flood hopping: data slots use Glossy with channel hopping unless
+     * the slot config selects another primitive */
+    #define GET_CONFIG_PRIMITIVE()  \
+      ((GMW_IN_FLOOD_HOPPING == current_config->channel_hopping_mode) ? \
+       GMW_PRIM_GLOSSY_HOPPING : current_config->primitive)
+    #define IN_FLOOD_HOPPING_AVAILABLE() \
+      (primitives[GMW_PRIM_GLOSSY_HOPPING] != NULL)
+  #else /* GMW_PRIM_GLOSSY_HOPPING */
+    #define GET_CONFIG_PRIMITIVE()  (current_config->primitive)
+  #endif /* GMW_PRIM_GLOSSY_HOPPING */
   #if GMW_CONF_USE_CONTROL_SLOT_CONFIG
     #define GET_PRIMTITIVE()   (GMW_CONTROL_HAS_SLOT_CONFIG(&control) ? \
-                                 (control.slot_config[slot_idx].primitive) :\
-                                 (current_config->primitive))
+                          GMW_CONTROL_GET_SLOT_PRIMITIVE(&control, slot_idx) :\
+                          GET_CONFIG_PRIMITIVE())
   #else /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
-    #define GET_PRIMTITIVE()   (current_config->primitive)
+    #define GET_PRIMTITIVE()   GET_CONFIG_PRIMITIVE()
   #endif /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
 
   #define GMW_START_PRIM(a, b, c, d, e, f) { \
     gmw_primitive = GET_PRIMTITIVE(); \
-    if(gmw_primitive == 0) { \
-      GMW_START_PRIM0(a, b, c, d, e, f); \
-    } else if(gmw_primitive == 1) { \
-      GMW_START_PRIM1(a, b, c, d, e, f); \
-    } else if(gmw_primitive == 2) { \
-      GMW_START_PRIM2(a, b, c, d, e, f); \
-    } else if(gmw_primitive == 3) { \
-      GMW_START_PRIM3(a, b, c, d, e, f); \
+    current_prim  = (gmw_primitive < GMW_CONF_MAX_PRIMITIVES) ? \
+                    primitives[gmw_primitive] : NULL; \
+    if(current_prim) { \
+      current_prim->start(a, b, c, d, e, f); \
     } \
   }
   #define GMW_STOP_PRIM() { \
-    if(gmw_primitive == 0) { \
-      GMW_STOP_PRIM0(); \
-      payload_len     = GMW_GET_PAYLOAD_LEN_PRIM0(); \
-      n_rx            = GMW_GET_N_RX_PRIM0(); \
-      n_rx_started    = GMW_GET_N_RX_STARTED_PRIM0(); \
-      stats.relay_cnt = GMW_GET_RELAY_CNT_FIRST_RX_PRIM0(); \
-    } else if(gmw_primitive == 1) { \
-      GMW_STOP_PRIM1(); \
-      payload_len     = GMW_GET_PAYLOAD_LEN_PRIM1(); \
-      n_rx            = GMW_GET_N_RX_PRIM1(); \
-      n_rx_started    = GMW_GET_N_RX_STARTED_PRIM1(); \
-      stats.relay_cnt = GMW_GET_RELAY_CNT_FIRST_RX_PRIM1();\
-    } else if(gmw_primitive == 2) { \
-      GMW_STOP_PRIM2(); \
-      payload_len     = GMW_GET_PAYLOAD_LEN_PRIM2(); \
-      n_rx            = GMW_GET_N_RX_PRIM2(); \
-      n_rx_started    = GMW_GET_N_RX_STARTED_PRIM2(); \
-      stats.relay_cnt = GMW_GET_RELAY_CNT_FIRST_RX_PRIM2(); \
-    } else if(gmw_primitive == 3) { \
-      GMW_STOP_PRIM3(); \
-      payload_len     = GMW_GET_PAYLOAD_LEN_PRIM3(); \
-      n_rx            = GMW_GET_N_RX_PRIM3(); \
-      n_rx_started    = GMW_GET_N_RX_STARTED_PRIM3(); \
-      stats.relay_cnt = GMW_GET_RELAY_CNT_FIRST_RX_PRIM3(); \
+    if(current_prim) { \
+      current_prim->stop(); \
+      payload_len     = current_prim->get_payload_len(); \
+      n_rx            = current_prim->get_n_rx(); \
+      n_rx_started    = current_prim->get_n_rx_started(); \
+      stats.relay_cnt = current_prim->get_relay_cnt(); \
     } else { \
       payload_len     = 0; \
       n_rx            = 0; \
@@ -350,8 +409,43 @@ gmw_sync_state_t next_state[NUM_OF_SYNC_EVENTS][NUM_OF_SYNC_STATES] =
                                 n_rx_started    = GMW_GET_N_RX_STARTED(); \
                                 stats.relay_cnt = GMW_GET_RELAY_CNT_FIRST_RX();
 #endif /* GMW_CONF_USE_MULTI_PRIMITIVES */
+#ifndef IN_FLOOD_HOPPING_AVAILABLE
+  /* no in-flood hopping primitive: GMW_IN_FLOOD_HOPPING would silently fall
+   * back to the default primitive, the default config must not select it
+   * (the mode is an enum value, i.e. not visible to the preprocessor) */
+  CTASSERT(GMW_CONF_CHANNEL_HOPPING_MODE != GMW_IN_FLOOD_HOPPING);
+  #define IN_FLOOD_HOPPING_AVAILABLE()  0
+#endif /* IN_FLOOD_HOPPING_AVAILABLE */
 /*---------------------------------------------------------------------------*/
 #define GMW_IS_HOST             (node_id == HOST_ID)
+/* size of the missed slots bitmap, one bit per data slot */
+#define GMW_MISSED_SLOTS_LEN    ((GMW_CONF_MAX_SLOTS + 7) / 8)
+/* max. number of bitmap bytes printed at the end of a round */
+#define GMW_MISSED_SLOTS_PRINT  16
+#define GMW_NUM_HOPPING_CHANNELS  (sizeof(hopping_channels) / \
+                                   sizeof(hopping_channels[0]))
+/* flags byte appended to the floods of the host (early termination) */
+#define GMW_FLAG_END_OF_ROUND   0x01
+#define GMW_SLOT_IS_HOST_SLOT   (HOST_ID == control.schedule.slot[slot_idx])
+#if GMW_CONF_USE_ENERGY_STATS
+/* attribute the RF and CPU on-time of a slot to an energy class */
+#define GMW_ENERGY_START()      energy_start()
+#define GMW_ENERGY_STOP(c)      energy_stop(c)
+#else /* GMW_CONF_USE_ENERGY_STATS */
+#define GMW_ENERGY_START()
+#define GMW_ENERGY_STOP(c)
+#endif /* GMW_CONF_USE_ENERGY_STATS */
+#if GMW_CONF_USE_HISTOGRAMS
+#define GMW_HF_TICKS_TO_US(t)   ((t) * 1000000ULL / GMW_RTIMER_SECOND_HF)
+/* measure the duration of a callback */
+#define GMW_HIST_START()        t_hist = GMW_RTIMER_NOW_HF()
+#define GMW_HIST_STOP(h)        hist_add(stats.hist.h, (uint32_t) \
+                                  GMW_HF_TICKS_TO_US(GMW_RTIMER_NOW_HF() - \
+                                                     t_hist))
+#else /* GMW_CONF_USE_HISTOGRAMS */
+#define GMW_HIST_START()
+#define GMW_HIST_STOP(h)
+#endif /* GMW_CONF_USE_HISTOGRAMS */
 /*---------------------------------------------------------------------------*/
 static struct pt                gmw_pt;
 static gmw_protocol_impl_t*     host_impl;
@@ -365,10 +459,106 @@ static gmw_rtimer_clock_t       rx_timestamp;
 static gmw_statistics_t         stats = { 0 };
 static uint32_t                 global_time;
 static uint8_t                  gmw_payload[GMW_MAX_PKT_LEN];
+static uint8_t*                 slot_payload;   /* TX buffer of current slot */
 static uint8_t                  control_len;
+static uint8_t                  missed_slots[GMW_MISSED_SLOTS_LEN];
+static const uint8_t            hopping_channels[] =
+                                  { GMW_CONF_HOPPING_CHANNELS };
 #if GMW_CONF_USE_MULTI_PRIMITIVES
 uint8_t                         gmw_primitive;
 #endif /* GMW_CONF_USE_MULTI_PRIMITIVES */
+#if GMW_CONF_USE_AUTO_GAP
+/* gap and guard calibration (host only) */
+static uint16_t                 auto_t_proc;      /* processing time in us */
+static uint32_t                 auto_t_round;     /* round length in ms */
+static uint8_t                  auto_backoff;     /* widening factor */
+static uint8_t                  auto_hold;        /* rounds until tightening */
+static uint8_t                  auto_announce;    /* rounds to send config */
+static uint8_t                  auto_gap_time;    /* in GMW_CONF_GAP_TIME_BASE */
+static uint8_t                  auto_guard_time;
+/* timing reports of the sources, the host keeps the max. of the current and
+ * the previous window (2 * GMW_CONF_AUTO_GAP_REPORT_ROUNDS rounds each) */
+static uint16_t                 auto_src_t_proc[2];   /* in us */
+static uint8_t                  auto_src_drift[2];    /* abs. value in ppm */
+static uint8_t                  auto_src_reports[2];  /* # reports received */
+static uint16_t                 auto_src_missed;  /* since the last update */
+static uint8_t                  auto_src_window;  /* rounds left in window */
+/* source side: accumulated since the last report */
+static uint16_t                 auto_rep_t_proc;
+static uint16_t                 auto_rep_missed;
+static uint8_t                  auto_rep_rounds;
+static uint16_t                 auto_rep_t_proc_sent; /* last reported */
+static uint8_t                  auto_rep_drift_sent;
+#endif /* GMW_CONF_USE_AUTO_GAP */
+static gmw_rtimer_clock_t       t_bootstrap_start;
+static uint8_t                  bootstrapping;  /* not yet (re)joined */
+#if GMW_CONF_USE_BOOTSTRAP_SCAN
+static gmw_rtimer_clock_t       scan_window_start;
+static uint32_t                 scan_period_ms = GMW_CONF_BOOTSTRAP_SCAN_PERIOD;
+static uint32_t                 scan_backoff_ms;
+#endif /* GMW_CONF_USE_BOOTSTRAP_SCAN */
+#if GMW_CONF_USE_AUTO_SLOT_TIME
+/* network diameter in hops (host only) */
+static uint8_t                  auto_st_hops = GMW_CONF_MAX_HOPS;
+static uint8_t                  auto_st_hops_seen;  /* in the current window */
+static uint8_t                  auto_st_rounds;
+#endif /* GMW_CONF_USE_AUTO_SLOT_TIME */
+#if GMW_CONF_USE_ADAPTIVE_N_TX
+/* learned state of the initiators (host only) */
+static gmw_n_tx_state_t         n_tx_state[GMW_CONF_ADAPTIVE_N_TX_NODES];
+static uint8_t                  n_tx_next;      /* next entry to replace */
+#endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+#if GMW_CONF_MAX_ROUND_PRE_SLOTS
+static gmw_slot_payload_t       round_pre_payloads[GMW_CONF_MAX_ROUND_PRE_SLOTS];
+static uint8_t                  round_pre_cnt;  /* valid entries */
+static uint8_t                  round_pre_idx;  /* next entry to look at */
+#endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
+#if GMW_CONF_USE_HISTOGRAMS
+static gmw_rtimer_clock_t       t_hist;
+#endif /* GMW_CONF_USE_HISTOGRAMS */
+#if GMW_CONF_USE_ENERGY_STATS
+/* on-times at the start of the current slot and at the end of the last
+ * round, in LF ticks */
+static uint32_t                 energy_rf_slot;
+static uint32_t                 energy_cpu_slot;
+static uint32_t                 energy_rf_round;
+static uint32_t                 energy_cpu_round;
+#endif /* GMW_CONF_USE_ENERGY_STATS */
+#if GMW_CONF_USE_EARLY_TERMINATION
+static uint8_t                  end_of_round;   /* requested by the host */
+static uint16_t                 end_of_round_slot;  /* first slot that can
+                                                     * still carry the flag */
+#endif /* GMW_CONF_USE_EARLY_TERMINATION */
+#if GMW_CONF_USE_INTEREST_MASK
+static uint8_t                  interest_mask[GMW_INTEREST_MASK_LEN];
+#define GMW_IS_INTERESTED(idx)  (interest_mask[(idx) >> 3] & (1 << ((idx) & 0x07)))
+#endif /* GMW_CONF_USE_INTEREST_MASK */
+#if GMW_CONF_DRIFT_WINDOW
+/* nominal (global) time of a round in period units and the local reference
+ * time of its control slot */
+typedef struct {
+  uint32_t                      x;
+  gmw_rtimer_clock_t            t_ref;
+} gmw_drift_sample_t;
+static gmw_drift_sample_t       drift_samples[GMW_CONF_DRIFT_WINDOW];
+static uint8_t                  drift_cnt;      /* valid samples */
+static uint8_t                  drift_next;     /* next entry to overwrite */
+static uint32_t                 drift_x;        /* nominal time of the
+                                                   current round */
+static int32_t                  drift_ofs;      /* fitted offset in us */
+static int32_t                  drift_slope;    /* fitted drift in us per
+                                                   period unit, Q16 */
+static uint32_t                 drift_x_mean;   /* relative to the oldest */
+static uint32_t                 drift_x_span;   /* sample */
+static uint16_t                 drift_res_max;  /* max. fitting error in us */
+static gmw_rtimer_clock_t       t_guard_round;
+#endif /* GMW_CONF_DRIFT_WINDOW */
+#if GMW_CONF_USE_CONTROL_SKIP
+static uint8_t                  control_skip_cnt;   /* announced rounds left
+                                                     * (host and sources) */
+static uint8_t                  control_skipped;    /* in the current round */
+static uint16_t                 control_skip_hash;  /* host: last announced */
+#endif /* GMW_CONF_USE_CONTROL_SKIP */
 /*---------------------------------------------------------------------------*/
 /**
  * @brief     Check if new control information has been send by the application.
@@ -378,6 +568,746 @@ uint8_t                         gmw_primitive;
 static void
 copy_control_if_updated(void);
 /*---------------------------------------------------------------------------*/
+/**
+ * @brief     Report a config that selects a channel hopping mode the platform
+ *            does not support (called whenever a new config is applied,
+ *            reported once per change of the mode).
+ */
+static void
+check_hopping_mode(const gmw_config_t* config)
+{
+  static uint8_t last_mode = GMW_NO_HOPPING;
+  if(config->channel_hopping_mode != last_mode &&
+     GMW_IN_FLOOD_HOPPING == config->channel_hopping_mode &&
+     !IN_FLOOD_HOPPING_AVAILABLE()) {
+    DEBUG_PRINT_ERROR("in-flood hopping not available, using primitive %u",
+                      config->primitive);
+  }
+  last_mode = config->channel_hopping_mode;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief     Print the number of missed slots and the missed slots bitmap in
+ *            hex (bit i of byte j marks slot 8 * j + i), starting at the first
+ *            byte with a missed slot.
+ */
+static void
+print_missed_slots(uint16_t n_missed)
+{
+  static const char hex[] = "0123456789ABCDEF";
+  char     str[GMW_MISSED_SLOTS_PRINT * 2 + 1];
+  uint16_t first = 0;
+  uint16_t i;
+
+  while(first < (GMW_MISSED_SLOTS_LEN - 1) && !missed_slots[first]) {
+    first++;
+  }
+  for(i = 0; i < GMW_MISSED_SLOTS_PRINT &&
+             (first + i) < GMW_MISSED_SLOTS_LEN; i++) {
+    str[i * 2]     = hex[missed_slots[first + i] >> 4];
+    str[i * 2 + 1] = hex[missed_slots[first + i] & 0x0f];
+  }
+  str[i * 2] = 0;
+  DEBUG_PRINT_WARNING("Missed %u slots! Bitmap from slot %u: %s", n_missed,
+                      first * 8, str);
+}
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_CONTROL_SKIP
+/**
+ * @brief     Hash of the config and the slot config of a control (host only),
+ *            i.e. of the parts the engine adapts on its own.
+ */
+static uint16_t
+control_skip_hash_get(const gmw_control_t* c)
+{
+  uint16_t crc = crc16_data((const unsigned char*)&c->config,
+                            sizeof(gmw_config_t), 0);
+#if GMW_CONF_USE_CONTROL_SLOT_CONFIG
+  crc = crc16_data((const unsigned char*)c->slot_config,
+                   GMW_SCHED_N_SLOTS(&c->schedule) * sizeof(gmw_slot_config_t),
+                   crc);
+  crc = crc16_data(c->slot_time_list, GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE,
+                   crc);
+#endif /* GMW_CONF_USE_CONTROL_SLOT_CONFIG */
+  return crc;
+}
+#endif /* GMW_CONF_USE_CONTROL_SKIP */
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief     Get the RF channel of a data slot (per-slot channel hopping).
+ * @param hop Number of data slots executed before in this round.
+ *
+ * The round time is hashed to select the first channel of the round, such
+ * that the channel sequence differs from round to round (even if the period
+ * is a multiple of the number of channels). The seed announced by the host
+ * (GMW_CONF_USE_HOPPING_SEED) is part of the hash.
+ */
+static uint8_t
+get_hopping_channel(uint16_t hop)
+{
+  uint32_t key = control.schedule.time;
+#if GMW_CONF_USE_HOPPING_SEED
+  key ^= control.config.hopping_seed;
+#endif /* GMW_CONF_USE_HOPPING_SEED */
+  uint16_t ofs = (uint16_t)((key * 2654435761UL) >> 16);
+  return hopping_channels[(ofs + hop) % GMW_NUM_HOPPING_CHANNELS];
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief          Get the payload prepared by on_round_pre for a data slot.
+ * @param slot_idx Index of the upcoming data slot.
+ * @return         Pointer to the prepared payload, NULL if there is none.
+ *
+ * The entries are sorted by slot index, thus the search continues where the
+ * previous one stopped. It restarts if the round is repeated.
+ */
+static gmw_slot_payload_t*
+get_round_pre_payload(uint16_t slot_idx)
+{
+#if GMW_CONF_MAX_ROUND_PRE_SLOTS
+  if(slot_idx == 0) {
+    round_pre_idx = 0;
+  }
+  while(round_pre_idx < round_pre_cnt &&
+        round_pre_payloads[round_pre_idx].slot_index < slot_idx) {
+    round_pre_idx++;
+  }
+  if(round_pre_idx < round_pre_cnt &&
+     round_pre_payloads[round_pre_idx].slot_index == slot_idx) {
+    return &round_pre_payloads[round_pre_idx];
+  }
+#endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_HISTOGRAMS
+/**
+ * @brief         Add a sample to a histogram with log2 bins.
+ * @param hist    The histogram (GMW_CONF_HIST_N_BINS counters).
+ * @param value   The sample, bin 0 for 0, bin i for [2^(i-1), 2^i).
+ */
+static void
+hist_add(uint16_t* hist, uint32_t value)
+{
+  uint8_t bin = 0;
+  while(value && bin < (GMW_CONF_HIST_N_BINS - 1)) {
+    value >>= 1;
+    bin++;
+  }
+  if(hist[bin] < 0xffff) {
+    hist[bin]++;
+  }
+}
+#endif /* GMW_CONF_USE_HISTOGRAMS */
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_ENERGY_STATS
+static void
+energy_start(void)
+{
+  energy_rf_slot  = GMW_GET_RF_ON_TIME();
+  energy_cpu_slot = GMW_GET_CPU_ON_TIME();
+}
+/*---------------------------------------------------------------------------*/
+static void
+energy_stop(gmw_energy_class_t c)
+{
+  stats.energy_round.rf_on[c]  += GMW_GET_RF_ON_TIME() - energy_rf_slot;
+  stats.energy_round.cpu_on[c] += GMW_GET_CPU_ON_TIME() - energy_cpu_slot;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief     Close the energy accounting of a round: everything that was not
+ *            spent in a slot since the end of the previous round is idle
+ *            time. The round is then added to the totals.
+ */
+static void
+energy_round_end(void)
+{
+  uint32_t rf_on  = GMW_GET_RF_ON_TIME();
+  uint32_t cpu_on = GMW_GET_CPU_ON_TIME();
+  uint32_t rf_idle  = rf_on - energy_rf_round;
+  uint32_t cpu_idle = cpu_on - energy_cpu_round;
+  uint8_t  i;
+
+  for(i = 0; i < GMW_ENERGY_IDLE; i++) {
+    rf_idle  -= MIN(rf_idle, stats.energy_round.rf_on[i]);
+    cpu_idle -= MIN(cpu_idle, stats.energy_round.cpu_on[i]);
+  }
+  stats.energy_round.rf_on[GMW_ENERGY_IDLE]  = rf_idle;
+  stats.energy_round.cpu_on[GMW_ENERGY_IDLE] = cpu_idle;
+  for(i = 0; i < NUM_OF_GMW_ENERGY_CLASSES; i++) {
+    stats.energy_total.rf_on[i]  += stats.energy_round.rf_on[i];
+    stats.energy_total.cpu_on[i] += stats.energy_round.cpu_on[i];
+  }
+  stats.energy_total.bytes_sent += stats.energy_round.bytes_sent;
+  stats.energy_total.bytes_rcvd += stats.energy_round.bytes_rcvd;
+  energy_rf_round  = rf_on;
+  energy_cpu_round = cpu_on;
+}
+#endif /* GMW_CONF_USE_ENERGY_STATS */
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_AUTO_GAP
+/**
+ * @brief            Calibrate the gap and the guard time at the end of a round
+ *                   (host only).
+ * @param t_gap_used Max. processing time between two slots of this round, us.
+ * @param n_missed   Number of slots the host missed in this round.
+ * @param t_round_ms Length of this round in ms.
+ *
+ * The processing time and the round length are tracked as slowly decaying
+ * maxima. The sources report their processing time, drift and missed slots
+ * (gmw_report_src_timing()), the max. of the last two report windows is
+ * taken into account. As long as no source has reported, the processing
+ * budget does not drop below the one of the static config and the guard
+ * assumes a drift of GMW_CONF_MAX_CLOCK_DEV.
+ * Missed slots (of the host or reported) double the widening factor (up to
+ * 8x); the times are tightened again at most every GMW_CONF_AUTO_GAP_HOLD
+ * rounds.
+ */
+static void
+auto_gap_update(uint16_t t_gap_used, uint16_t n_missed, uint32_t t_round_ms)
+{
+  uint32_t guard, gap, t_proc, t_proc_min, drift;
+
+  if(t_gap_used >= auto_t_proc) {
+    auto_t_proc = t_gap_used;
+  } else {
+    auto_t_proc -= (auto_t_proc - t_gap_used) >> 4;
+  }
+  if(t_round_ms >= auto_t_round) {
+    auto_t_round = t_round_ms;
+  } else {
+    auto_t_round -= (auto_t_round - t_round_ms) >> 4;
+  }
+  n_missed       += auto_src_missed;
+  auto_src_missed = 0;
+  if(n_missed) {
+    auto_backoff = MIN(auto_backoff * 2, 8);
+    auto_hold    = GMW_CONF_AUTO_GAP_HOLD;
+  } else if(!auto_hold && auto_backoff > 1) {
+    auto_backoff >>= 1;
+  }
+
+  if(auto_src_reports[0] || auto_src_reports[1]) {
+    t_proc     = MAX(auto_t_proc, MAX(auto_src_t_proc[0], auto_src_t_proc[1]));
+    t_proc_min = GMW_CONF_AUTO_GAP_T_PROC_MIN;
+    drift      = MIN(MAX(auto_src_drift[0], auto_src_drift[1]) +
+                     GMW_CONF_AUTO_GAP_DRIFT_ERR, GMW_CONF_MAX_CLOCK_DEV);
+  } else {
+    /* the sources are not observed */
+    t_proc     = auto_t_proc;
+    t_proc_min = MAX(GMW_CONF_T_GAP - GMW_CONF_T_GUARD_SLOT,
+                     GMW_CONF_AUTO_GAP_T_PROC_MIN);
+    drift      = GMW_CONF_MAX_CLOCK_DEV;
+  }
+  if(auto_src_window) {
+    auto_src_window--;
+  } else {
+    /* start a new report window */
+    auto_src_t_proc[1]  = auto_src_t_proc[0];
+    auto_src_drift[1]   = auto_src_drift[0];
+    auto_src_reports[1] = auto_src_reports[0];
+    auto_src_t_proc[0]  = 0;
+    auto_src_drift[0]   = 0;
+    auto_src_reports[0] = 0;
+    auto_src_window     = 2 * GMW_CONF_AUTO_GAP_REPORT_ROUNDS;
+  }
+
+  /* the guard covers the drift accumulated since the control slot */
+  guard = GMW_CONF_AUTO_GAP_T_JITTER + drift * auto_t_round / 1000;
+  guard = guard * (100 + GMW_CONF_AUTO_GAP_MARGIN) / 100 * auto_backoff;
+  gap   = MAX(t_proc * (100 + GMW_CONF_AUTO_GAP_MARGIN) / 100, t_proc_min) *
+          auto_backoff + guard;
+  guard = MIN(GMW_US_TO_GAP_TIME(guard), 0xff);
+  gap   = MIN(GMW_US_TO_GAP_TIME(gap), 0xff);
+  if(auto_hold) {
+    /* only widen */
+    guard = MAX(guard, auto_guard_time);
+    gap   = MAX(gap, auto_gap_time);
+  }
+  if(gap != auto_gap_time || guard != auto_guard_time) {
+    auto_gap_time   = gap;
+    auto_guard_time = guard;
+    auto_announce   = GMW_CONF_AUTO_GAP_ANNOUNCE;
+    auto_hold       = GMW_CONF_AUTO_GAP_HOLD;
+    DEBUG_PRINT_INFO("gap %luus, guard %luus",
+                     (unsigned long)GMW_GAP_TIME_TO_US(gap),
+                     (unsigned long)GMW_GAP_TIME_TO_US(guard));
+  } else if(auto_hold) {
+    auto_hold--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* accumulate the timing of this round for the next report (source only) */
+static void
+auto_gap_src_update(uint16_t t_gap_used, uint16_t n_missed)
+{
+  auto_rep_t_proc = MAX(auto_rep_t_proc, t_gap_used);
+  auto_rep_missed = MIN(auto_rep_missed + n_missed, 0xff);
+  if(auto_rep_rounds < 0xff) {
+    auto_rep_rounds++;
+  }
+}
+#endif /* GMW_CONF_USE_AUTO_GAP */
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_ADAPTIVE_N_TX || GMW_CONF_USE_AUTO_SLOT_TIME
+/**
+ * @brief            Derive the slot config from the config section if the
+ *                   application did not set one (host only). All slots use
+ *                   the N_TX and slot time of the config and the last entry
+ *                   of the slot time list (i.e. the largest payload class).
+ */
+static void
+slot_config_init(gmw_control_t* c)
+{
+  uint16_t i;
+
+  if(GMW_CONTROL_HAS_SLOT_CONFIG(c)) {
+    return;
+  }
+  for(i = 0; i < GMW_SCHED_N_SLOTS(&c->schedule); i++) {
+    c->slot_config[i].n_retransmissions = c->config.n_retransmissions;
+    c->slot_config[i].slot_time_select  =
+      GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE - 1;
+    c->slot_config[i].primitive         = 0;
+  }
+  memset(c->slot_time_list, c->config.slot_time,
+         GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE);
+  GMW_CONTROL_SET_SLOT_CONFIG(c);
+}
+#endif /* GMW_CONF_USE_ADAPTIVE_N_TX || GMW_CONF_USE_AUTO_SLOT_TIME */
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_ADAPTIVE_N_TX
+/* max. loss rate in 1/65536 */
+#define GMW_N_TX_MAX_LOSS       ((uint16_t)((1000UL - \
+                                  GMW_CONF_ADAPTIVE_N_TX_TARGET) * 65536 / 1000))
+/**
+ * @brief            Look up the state of an initiator.
+ */
+static gmw_n_tx_state_t*
+n_tx_find(uint16_t node_id)
+{
+  uint8_t i;
+  for(i = 0; i < GMW_CONF_ADAPTIVE_N_TX_NODES; i++) {
+    if(n_tx_state[i].n_tx && n_tx_state[i].node_id == node_id) {
+      return &n_tx_state[i];
+    }
+  }
+  return NULL;
+}
+/**
+ * @brief            Update the state of an initiator with the outcome of one
+ *                   of its data slots (host only).
+ * @param node_id    The initiator
+ * @param n_tx       N_TX used in the slot
+ * @param success    Non-zero if the host received the flood
+ * @param relay_cnt  Relay count of the first reception (if success)
+ */
+static void
+n_tx_update(uint16_t node_id, uint8_t n_tx, uint8_t success, uint8_t relay_cnt)
+{
+  gmw_n_tx_state_t* s = n_tx_find(node_id);
+
+  if(!s) {
+    /* replace the oldest entry */
+    s = &n_tx_state[n_tx_next];
+    n_tx_next = (n_tx_next + 1) % GMW_CONF_ADAPTIVE_N_TX_NODES;
+    s->node_id   = node_id;
+    s->loss      = 0;
+    s->n_tx      = MIN(MAX(n_tx, GMW_CONF_ADAPTIVE_N_TX_MIN),
+                       GMW_CONF_ADAPTIVE_N_TX_MAX);
+    s->hold      = 0;
+    s->relay_min = GMW_RELAY_COUNT_UNDEF;
+    s->relay_avg = 0;
+  }
+
+  if(success) {
+    s->loss -= s->loss >> 4;
+    if(s->hold < 0xff) {
+      s->hold++;
+    }
+    if(relay_cnt != GMW_RELAY_COUNT_UNDEF) {
+      if(relay_cnt < s->relay_min) {
+        s->relay_min = relay_cnt;
+      }
+      if(s->relay_avg == 0) {
+        s->relay_avg = MIN(relay_cnt, 15) << 4;
+      } else {
+        s->relay_avg = (uint8_t)(((uint16_t)s->relay_avg * 3 +
+                                  (MIN(relay_cnt, 15) << 4)) >> 2);
+      }
+    }
+    /* lower N_TX if the floods were reliable for a while and still take
+     * short paths */
+    if(s->hold >= GMW_CONF_ADAPTIVE_N_TX_HOLD &&
+       s->loss <= GMW_N_TX_MAX_LOSS &&
+       s->n_tx > GMW_CONF_ADAPTIVE_N_TX_MIN &&
+       s->relay_avg <= ((MIN(s->relay_min, 14) + 1) << 4)) {
+      s->n_tx--;
+      s->hold = 0;
+      stats.n_tx_dec_cnt++;
+      DEBUG_PRINT_VERBOSE("N_TX of node %u lowered to %u", node_id, s->n_tx);
+    }
+  } else {
+    s->loss += (0xffff - s->loss) >> 4;
+    s->hold  = 0;
+    if(s->loss > GMW_N_TX_MAX_LOSS && s->n_tx < GMW_CONF_ADAPTIVE_N_TX_MAX) {
+      s->n_tx++;
+      stats.n_tx_inc_cnt++;
+      DEBUG_PRINT_VERBOSE("N_TX of node %u raised to %u", node_id, s->n_tx);
+    }
+  }
+}
+/**
+ * @brief            Write the learned N_TX into the slot config of the control
+ *                   (host only).
+ */
+static void
+n_tx_apply(gmw_control_t* c)
+{
+  uint16_t i;
+  uint16_t n_slots = GMW_SCHED_N_SLOTS(&c->schedule);
+
+  slot_config_init(c);
+  for(i = 0; i < n_slots; i++) {
+    const gmw_n_tx_state_t* s = n_tx_find(c->schedule.slot[i]);
+    if(s) {
+      c->slot_config[i].n_retransmissions = s->n_tx;
+    }
+  }
+}
+#endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_AUTO_SLOT_TIME
+/**
+ * @brief            Track the network diameter at the end of a round (host
+ *                   only).
+ *
+ * The diameter is the largest hop count (relay count + 1) of the data floods
+ * the host received in the last GMW_CONF_AUTO_SLOT_TIME_WINDOW rounds. It is
+ * increased as soon as a longer path is seen.
+ */
+static void
+auto_slot_time_update(void)
+{
+  uint8_t hops = auto_st_hops;
+
+  if(auto_st_hops_seen > auto_st_hops) {
+    hops = auto_st_hops_seen;
+    auto_st_rounds = 0;
+  } else if(++auto_st_rounds >= GMW_CONF_AUTO_SLOT_TIME_WINDOW) {
+    if(auto_st_hops_seen) {
+      hops = auto_st_hops_seen;
+    }
+    auto_st_rounds = 0;
+  }
+  if(!auto_st_rounds) {
+    auto_st_hops_seen = 0;
+  }
+  if(hops != auto_st_hops) {
+    auto_st_hops = hops;
+    DEBUG_PRINT_INFO("diameter %u hops", hops);
+  }
+}
+/**
+ * @brief            Size the entries of the slot time list for the current
+ *                   diameter (host only).
+ *
+ * Entry k of the list is used for the payload length class k (see
+ * GMW_CONF_AUTO_SLOT_TIME_LEN) and sized for the largest N_TX of the slots
+ * that select it.
+ */
+static void
+auto_slot_time_apply(gmw_control_t* c)
+{
+  uint8_t  n_tx[GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE] = { 0 };
+  uint8_t  hops = MIN(auto_st_hops + GMW_CONF_AUTO_SLOT_TIME_MARGIN,
+                      GMW_CONF_MAX_HOPS);
+  uint16_t i;
+
+  slot_config_init(c);
+  for(i = 0; i < GMW_SCHED_N_SLOTS(&c->schedule); i++) {
+    uint8_t k = c->slot_config[i].slot_time_select;
+    n_tx[k] = MAX(n_tx[k], c->slot_config[i].n_retransmissions);
+  }
+  for(i = 0; i < GMW_CONTROL_SLOT_CONFIG_TIMELIST_SIZE; i++) {
+    if(n_tx[i]) {
+      uint32_t t = GMW_US_TO_SLOT_TIME(
+                     GMW_T_SLOT_MIN(GMW_CONF_AUTO_SLOT_TIME_LEN(i) +
+                                    GMW_CONF_RF_OVERHEAD, n_tx[i], hops));
+      c->slot_time_list[i] = (uint8_t)MIN(t, 0xff);
+    }
+  }
+}
+#endif /* GMW_CONF_USE_AUTO_SLOT_TIME */
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_BOOTSTRAP_SCAN
+/**
+ * @brief            Bootstrap scan policy, called after each unsuccessful
+ *                   attempt to receive a control packet.
+ * @return           Time to sleep in ms, 0 to keep listening
+ *
+ * A listen window covers one round period plus a control slot. After each
+ * window, the radio is turned off for the current backoff (plus jitter).
+ */
+static uint32_t
+bootstrap_scan_next(void)
+{
+  uint32_t t_sleep;
+
+  if(GMW_TICKS_TO_MS(GMW_RTIMER_NOW() - scan_window_start) <
+     scan_period_ms + GMW_CONF_T_CONTROL / 1000 + 1) {
+    return 0;
+  }
+  t_sleep = scan_backoff_ms;
+#if GMW_CONF_BOOTSTRAP_SCAN_PROFILE == GMW_BOOTSTRAP_SCAN_LINEAR
+  scan_backoff_ms += GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MIN;
+#elif GMW_CONF_BOOTSTRAP_SCAN_PROFILE == GMW_BOOTSTRAP_SCAN_EXPONENTIAL
+  scan_backoff_ms *= 2;
+#endif /* GMW_CONF_BOOTSTRAP_SCAN_PROFILE */
+  scan_backoff_ms = MIN(scan_backoff_ms, GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MAX);
+  t_sleep += (uint32_t)((uint64_t)random_rand() *
+                        (t_sleep * GMW_CONF_BOOTSTRAP_SCAN_JITTER / 100) >> 16);
+  return t_sleep;
+}
+#endif /* GMW_CONF_USE_BOOTSTRAP_SCAN */
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_DRIFT_WINDOW
+/**
+ * @brief            Reset the drift estimator (e.g. when bootstrapping).
+ */
+static void
+drift_reset(void)
+{
+  drift_cnt     = 0;
+  drift_next    = 0;
+  drift_x       = 0;
+  t_guard_round = GMW_US_TO_TICKS(GMW_CONF_T_GUARD_ROUND);
+  stats.t_ref_err = 0xffff;
+}
+/*---------------------------------------------------------------------------*/
+/* the oldest sample in the window is the origin of the fit */
+static const gmw_drift_sample_t*
+drift_oldest(void)
+{
+  return &drift_samples[(drift_next + GMW_CONF_DRIFT_WINDOW - drift_cnt) %
+                        GMW_CONF_DRIFT_WINDOW];
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief            Predict the reference time of a round from the fit.
+ * @param x          Nominal time of the round in period units.
+ * @param err_us     Returns the estimated error of the prediction in us, i.e.
+ *                   the max. fitting error, scaled up with the distance of x
+ *                   from the center of the window (may be NULL).
+ */
+static gmw_rtimer_clock_t
+drift_predict(uint32_t x, uint32_t* err_us)
+{
+  const gmw_drift_sample_t* ref = drift_oldest();
+  uint32_t dx  = x - ref->x;
+  int64_t  dev = drift_ofs + (int64_t)drift_slope * dx / 65536;
+
+  if(err_us) {
+    /* LF timestamps are accurate to one tick */
+    uint32_t res  = drift_res_max + 1000000UL / GMW_RTIMER_SECOND + 1;
+    uint32_t dist = (dx > drift_x_mean) ? (dx - drift_x_mean) :
+                                          (drift_x_mean - dx);
+    *err_us = res + (uint64_t)res * 2 * dist / drift_x_span;
+  }
+  return ref->t_ref + GMW_PERIOD_TO_TICKS((gmw_rtimer_clock_t)dx) +
+         (gmw_rtimer_clock_t)(dev * (int64_t)GMW_RTIMER_SECOND / 1000000);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief            Least squares fit of the offset and the drift over all
+ *                   samples in the window.
+ *
+ * The deviation of each t_ref from the nominal time (in us) is fitted
+ * relative to the oldest sample, which keeps all sums within 64 bits.
+ */
+static void
+drift_fit(void)
+{
+  const gmw_drift_sample_t* ref = drift_oldest();
+  int32_t  y[GMW_CONF_DRIFT_WINDOW];
+  uint32_t dx[GMW_CONF_DRIFT_WINDOW];
+  int64_t  sx = 0, sy = 0, sxx = 0, sxy = 0, den;
+  uint8_t  n = drift_cnt, i;
+
+  for(i = 0; i < n; i++) {
+    const gmw_drift_sample_t* s =
+      &drift_samples[(ref - drift_samples + i) % GMW_CONF_DRIFT_WINDOW];
+    dx[i] = s->x - ref->x;
+    y[i]  = (int32_t)((int64_t)(s->t_ref - ref->t_ref -
+                      GMW_PERIOD_TO_TICKS((gmw_rtimer_clock_t)dx[i])) *
+                      1000000 / (int64_t)GMW_RTIMER_SECOND);
+    sx  += dx[i];
+    sy  += y[i];
+    sxx += (int64_t)dx[i] * dx[i];
+    sxy += (int64_t)dx[i] * y[i];
+  }
+  den = n * sxx - sx * sx;
+  drift_slope   = (den > 0) ? (int32_t)((n * sxy - sx * sy) * 65536 / den) :
+                              0;
+  drift_ofs     = (int32_t)((sy - (int64_t)drift_slope * sx / 65536) / n);
+  drift_x_mean  = (uint32_t)(sx / n);
+  drift_x_span  = dx[n - 1];
+  drift_res_max = 0;
+  for(i = 0; i < n; i++) {
+    int32_t res = y[i] - (drift_ofs + (int32_t)((int64_t)drift_slope * dx[i] /
+                                                65536));
+    res = (res < 0) ? -res : res;
+    drift_res_max = MIN(MAX(drift_res_max, res), 0xffff);
+  }
+  /* us per period unit to ppm */
+  stats.drift = (int16_t)((int64_t)drift_slope *
+                          (int64_t)GMW_CONF_TIME_SCALE / 65536);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief            Add the reference time of a received control packet to
+ *                   the window and update the fit.
+ *
+ * The window is restarted if the sample does not match the fit (or the drift
+ * to the previous sample exceeds GMW_CONF_MAX_CLOCK_DEV), e.g. after the
+ * host has been restarted.
+ */
+static void
+drift_add_sample(uint32_t x, gmw_rtimer_clock_t t)
+{
+  if(drift_cnt >= GMW_CONF_DRIFT_MIN_SAMPLES) {
+    uint32_t err;
+    gmw_rtimer_clock_t t_pred = drift_predict(x, &err);
+    gmw_rtimer_clock_t diff   = (t > t_pred) ? (t - t_pred) : (t_pred - t);
+    if(GMW_TICKS_TO_US(diff) > GMW_CONF_T_GUARD_ROUND + err) {
+      DEBUG_PRINT_INFO("t_ref off by %luus, drift estimation restarted",
+                       (unsigned long)GMW_TICKS_TO_US(diff));
+      drift_cnt = 0;
+    }
+  } else if(drift_cnt) {
+    const gmw_drift_sample_t* last =
+      &drift_samples[(drift_next + GMW_CONF_DRIFT_WINDOW - 1) %
+                     GMW_CONF_DRIFT_WINDOW];
+    int64_t diff = (int64_t)(t - last->t_ref -
+                   GMW_PERIOD_TO_TICKS((gmw_rtimer_clock_t)(x - last->x)));
+    int64_t drift = diff * 1000000 * (int64_t)GMW_CONF_TIME_SCALE /
+                    (int64_t)GMW_RTIMER_SECOND / (int64_t)(x - last->x);
+    if(drift >= GMW_CONF_MAX_CLOCK_DEV || drift <= -GMW_CONF_MAX_CLOCK_DEV) {
+      drift_cnt = 0;
+    }
+  }
+  if(!drift_cnt) {
+    t_guard_round   = GMW_US_TO_TICKS(GMW_CONF_T_GUARD_ROUND);
+    stats.t_ref_err = 0xffff;
+  }
+  drift_samples[drift_next].x     = x;
+  drift_samples[drift_next].t_ref = t;
+  drift_next = (drift_next + 1) % GMW_CONF_DRIFT_WINDOW;
+  if(drift_cnt < GMW_CONF_DRIFT_WINDOW) {
+    drift_cnt++;
+  }
+  if(drift_cnt > 1) {
+    drift_fit();
+  }
+}
+#endif /* GMW_CONF_DRIFT_WINDOW */
+/*---------------------------------------------------------------------------*/
+uint8_t
+gmw_end_round(void)
+{
+#if GMW_CONF_USE_EARLY_TERMINATION
+  if(GMW_IS_HOST) {
+    uint16_t i;
+    end_of_round = 1;
+    /* the flag is only sent with a flood of the host */
+    for(i = end_of_round_slot; i < GMW_SCHED_N_SLOTS(&control.schedule); i++) {
+      if(HOST_ID == control.schedule.slot[i]) {
+        return 1;
+      }
+    }
+    DEBUG_PRINT_WARNING("no host slot left, round not ended early");
+  }
+#endif /* GMW_CONF_USE_EARLY_TERMINATION */
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+gmw_get_histograms(gmw_histograms_t* out, uint8_t reset)
+{
+#if GMW_CONF_USE_HISTOGRAMS
+  if(out) {
+    memcpy(out, &stats.hist, sizeof(gmw_histograms_t));
+  }
+  if(reset) {
+    memset(&stats.hist, 0, sizeof(gmw_histograms_t));
+  }
+#endif /* GMW_CONF_USE_HISTOGRAMS */
+}
+/*---------------------------------------------------------------------------*/
+const gmw_n_tx_state_t*
+gmw_get_n_tx_state(uint16_t node_id)
+{
+#if GMW_CONF_USE_ADAPTIVE_N_TX
+  return n_tx_find(node_id);
+#else /* GMW_CONF_USE_ADAPTIVE_N_TX */
+  return NULL;
+#endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+gmw_get_timing_report(gmw_timing_report_t* out)
+{
+#if GMW_CONF_USE_AUTO_GAP
+  int16_t drift = GMW_TIMING_DRIFT_UNKNOWN;
+  uint8_t drift_abs = GMW_CONF_MAX_CLOCK_DEV;
+  #if GMW_CONF_USE_DRIFT_COMPENSATION || GMW_CONF_DRIFT_WINDOW
+  drift     = MIN(MAX(stats.drift, INT8_MIN + 1), INT8_MAX);
+  drift_abs = (drift < 0) ? -drift : drift;
+  #endif /* GMW_CONF_USE_DRIFT_COMPENSATION || GMW_CONF_DRIFT_WINDOW */
+  if(GMW_IS_HOST || !out) {
+    return 0;
+  }
+  if(!auto_rep_missed && auto_rep_t_proc <= auto_rep_t_proc_sent &&
+     drift_abs <= auto_rep_drift_sent &&
+     auto_rep_rounds < GMW_CONF_AUTO_GAP_REPORT_ROUNDS) {
+    return 0;   /* nothing new to report */
+  }
+  out->t_gap_used      = auto_rep_t_proc;
+  out->drift           = drift;
+  out->n_missed        = auto_rep_missed;
+  auto_rep_t_proc_sent = auto_rep_t_proc;
+  auto_rep_drift_sent  = drift_abs;
+  auto_rep_t_proc      = 0;
+  auto_rep_missed      = 0;
+  auto_rep_rounds      = 0;
+  return 1;
+#else /* GMW_CONF_USE_AUTO_GAP */
+  return 0;
+#endif /* GMW_CONF_USE_AUTO_GAP */
+}
+/*---------------------------------------------------------------------------*/
+void
+gmw_report_src_timing(const gmw_timing_report_t* report)
+{
+#if GMW_CONF_USE_AUTO_GAP
+  uint8_t drift_abs = GMW_CONF_MAX_CLOCK_DEV;
+  if(!GMW_IS_HOST || !report) {
+    return;
+  }
+  if(report->drift != GMW_TIMING_DRIFT_UNKNOWN) {
+    drift_abs = MIN((report->drift < 0) ? -report->drift : report->drift,
+                    GMW_CONF_MAX_CLOCK_DEV);
+  }
+  auto_src_t_proc[0] = MAX(auto_src_t_proc[0], report->t_gap_used);
+  auto_src_drift[0]  = MAX(auto_src_drift[0], drift_abs);
+  auto_src_missed   += report->n_missed;
+  if(auto_src_reports[0] < 0xff) {
+    auto_src_reports[0]++;
+  }
+#endif /* GMW_CONF_USE_AUTO_GAP */
+}
+/*---------------------------------------------------------------------------*/
 gmw_statistics_t * const
 gmw_get_stats(void)
 {
@@ -390,6 +1320,22 @@ gmw_get_state(void)
   return sync_state;
 }
 /*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_MULTI_PRIMITIVES
+uint8_t
+gmw_register_primitive(uint8_t id, const gmw_primitive_t* prim)
+{
+  if(id >= GMW_CONF_MAX_PRIMITIVES ||
+     (prim && (!prim->start || !prim->stop || !prim->get_payload_len ||
+               !prim->get_n_rx || !prim->get_n_rx_started ||
+               !prim->get_relay_cnt))) {
+    DEBUG_PRINT_ERROR("invalid primitive %u", id);
+    return 0;
+  }
+  primitives[id] = prim;
+  return 1;
+}
+#endif /* GMW_CONF_USE_MULTI_PRIMITIVES */
+/*---------------------------------------------------------------------------*/
 /**
  * @brief     GMW protothread.
  *            It implements the generic round structure, schedule the execution
@@ -411,18 +1357,19 @@ PT_THREAD(gmw_thread(gmw_rtimer_t *rt))
   static gmw_rtimer_clock_t     current_slot_time;
 
   static uint32_t               pre_process_offset;
-  static uint32_t               missed_slots;
   static uint8_t                payload_len;
   static uint8_t                n_rx;
   static uint8_t                n_rx_started;
-  static uint8_t                n_missed_slots;
+  static uint16_t               n_missed_slots;
+  static uint16_t               slot_cnt;   /* executed slots incl. repeats */
+  static uint16_t               t_gap_used_round;
   static uint8_t                is_current_config_valid;
 
   static gmw_pkt_event_t        pkt_event;
   static gmw_sync_state_t       impl_sync_state;
   static gmw_sync_event_t       sync_event;
 
-#if GMW_CONF_USE_DRIFT_COMPENSATION
+#if GMW_CONF_USE_DRIFT_COMPENSATION && !GMW_CONF_DRIFT_WINDOW
   static gmw_rtimer_clock_t     t_ref_last;
   static uint16_t               period_last;
 #endif /* GMW_CONF_USE_DRIFT_COMPENSATION */
@@ -439,6 +1386,16 @@ PT_THREAD(gmw_thread(gmw_rtimer_t *rt))
     gmw_impl            = host_impl;
     stats.t_slack_min   = 0xffffffff;
     sync_state          = GMW_RUNNING; /* 'RUNNING' is default state of host */
+  #if GMW_CONF_USE_AUTO_GAP
+    auto_t_proc         = 0;
+    auto_t_round        = 0;
+    auto_backoff        = 1;
+    auto_hold           = GMW_CONF_AUTO_GAP_HOLD;
+    auto_announce       = 0;
+    auto_gap_time       = GMW_US_TO_GAP_TIME(GMW_CONF_T_GAP);
+    auto_guard_time     = GMW_US_TO_GAP_TIME(GMW_CONF_T_GUARD_SLOT);
+    auto_src_window     = 2 * GMW_CONF_AUTO_GAP_REPORT_ROUNDS;
+  #endif /* GMW_CONF_USE_AUTO_GAP */
     start_of_next_round = rt->time +
                           GMW_CONF_T_PREPROCESS * GMW_RTIMER_SECOND / 1000 +
                           GMW_US_TO_TICKS(GMW_CONF_PREROUND_SETUP_TIME) +
@@ -479,6 +1436,9 @@ PT_THREAD(gmw_thread(gmw_rtimer_t *rt))
   #endif /* GMW_CONF_T_PREPROCESS */
 
     /* --- COMMUNICATION ROUND STARTS --- */
+  #if GMW_CONF_USE_ENERGY_STATS
+    memset(&stats.energy_round, 0, sizeof(gmw_energy_t));
+  #endif /* GMW_CONF_USE_ENERGY_STATS */
 
     /* the control packet might be much longer than other packets */
     gmw_set_maximum_packet_length(GMW_CONF_MAX_CONTROL_PKT_LEN +
@@ -487,8 +1447,48 @@ PT_THREAD(gmw_thread(gmw_rtimer_t *rt))
     if(GMW_IS_HOST) {
       /* prepare control packet */
       copy_control_if_updated();
+  #if GMW_CONF_USE_CONTROL_SKIP
+      /* the sources may skip the control slot of the rounds announced with
+       * n_skip: the engine must not change the control in these rounds */
+      uint8_t n_skip_app = control.schedule.n_skip;    /* not static */
+      control_skipped = (control_skip_cnt > 0);
+      if(control_skipped) {
+        control_skip_cnt--;
+      }
+      if(!control_skipped)
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
+      {
+  #if GMW_CONF_USE_ADAPTIVE_N_TX
+        n_tx_apply(&control);
+  #endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+  #if GMW_CONF_USE_AUTO_SLOT_TIME
+        auto_slot_time_apply(&control);
+  #endif /* GMW_CONF_USE_AUTO_SLOT_TIME */
+  #if GMW_CONF_USE_AUTO_GAP
+        /* calibrated times override the ones set by the application */
+        control.config.gap_time   = auto_gap_time;
+        control.config.guard_time = auto_guard_time;
+        if(auto_announce) {
+          GMW_CONTROL_SET_CONFIG(&control);
+          auto_announce--;
+        }
+  #endif /* GMW_CONF_USE_AUTO_GAP */
+      }
+  #if GMW_CONF_USE_CONTROL_SKIP
+      if(!control_skipped) {
+        /* no skipping while the engine still changes the control */
+        uint16_t hash = control_skip_hash_get(&control);
+        control_skip_cnt  = (hash == control_skip_hash) ? n_skip_app : 0;
+        control_skip_hash = hash;
+      }
+      /* announce the rounds left, a source may (re)start listening anytime */
+      control.schedule.n_skip = control_skip_cnt;
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
       control_len = gmw_control_compile_to_buffer(&control, gmw_payload,
                                                   GMW_MAX_PKT_LEN);
+  #if GMW_CONF_USE_CONTROL_SKIP
+      control.schedule.n_skip = n_skip_app;
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
       if(control_len == 0) {
         DEBUG_PRINT_MSG_NOW("Packet buffer too small to send the control.");
         break;
@@ -499,7 +1499,7 @@ PT_THREAD(gmw_thread(gmw_rtimer_t *rt))
 
       if(start_of_next_round < GMW_RTIMER_NOW()) {
         DEBUG_PRINT_ERROR("GMW t_start overrun by %ld ticks",
-                          (uint32_t)(GMW_RTIMER_NOW() - start_of_next_round));
+                          (long)(GMW_RTIMER_NOW() - start_of_next_round));
       }
 
       GMW_WAIT_UNTIL(start_of_next_round);
@@ -532,9 +1532,28 @@ BOOTSTRAP_MODE:
         /* Mark the round as "ended" before the next bootstrapping attempt */
         GMW_GPIO_ROUND_END;
 
-  #if GMW_CONF_USE_DRIFT_COMPENSATION
+  #if GMW_CONF_DRIFT_WINDOW
+        drift_reset();
+  #elif GMW_CONF_USE_DRIFT_COMPENSATION
         period_last = 0;
   #endif /* GMW_CONF_USE_DRIFT_COMPENSATION */
+  #if GMW_CONF_USE_CONTROL_SKIP
+        control_skip_cnt = 0;
+        control_skipped  = 0;
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
+
+        if(!bootstrapping) {
+          /* synchronization lost (or first bootstrap) */
+          bootstrapping     = 1;
+          t_bootstrap_start = GMW_RTIMER_NOW();
+  #if GMW_CONF_USE_BOOTSTRAP_SCAN
+          if(control.schedule.period) {
+            scan_period_ms = GMW_PERIOD_TO_MS(control.schedule.period);
+          }
+          scan_window_start = t_bootstrap_start;
+          scan_backoff_ms   = GMW_CONF_BOOTSTRAP_SCAN_BACKOFF_MIN;
+  #endif /* GMW_CONF_USE_BOOTSTRAP_SCAN */
+        }
 
         /* Reset the part of the control that is supposed to be received
          * TODO right now, dont erase anything if static, extend to clean the
@@ -555,20 +1574,32 @@ BOOTSTRAP_MODE:
 
           /* try to receive a control packet */
           GMW_RCV_CONTROL();
+          stats.t_bootstrap_listen += (uint32_t)(GMW_RTIMER_NOW() -
+                                                 start_of_current_round);
 
           /* did we receive a synced (setting t_ref) glossy packet? */
           if(!GMW_IS_T_REF_UPDATED()) {
-            uint32_t time_to_sleep_in_ms = gmw_impl->on_bootstrap_timeout();
+            uint32_t time_to_sleep_in_ms = gmw_impl->on_bootstrap_timeout ?
+                                           gmw_impl->on_bootstrap_timeout() :
+                                           0;
+  #if GMW_CONF_USE_BOOTSTRAP_SCAN
+            if(!time_to_sleep_in_ms) {
+              time_to_sleep_in_ms = bootstrap_scan_next();
+            }
+  #endif /* GMW_CONF_USE_BOOTSTRAP_SCAN */
 
             if(time_to_sleep_in_ms != 0) {
               /* we go to sleep */
               DEBUG_PRINT_MSG_NOW("going to sleep for %lums",
-                                  time_to_sleep_in_ms);
+                                  (unsigned long)time_to_sleep_in_ms);
               stats.sleep_cnt++;
               GMW_BEFORE_DEEPSLEEP();
               GMW_WAIT_UNTIL(GMW_RTIMER_NOW() +
                              GMW_MS_TO_TICKS(time_to_sleep_in_ms));
               GMW_AFTER_DEEPSLEEP();
+  #if GMW_CONF_USE_BOOTSTRAP_SCAN
+              scan_window_start = GMW_RTIMER_NOW();
+  #endif /* GMW_CONF_USE_BOOTSTRAP_SCAN */
             }
 
             /* Mark the round as "ended" before the next bootstrapping attempt */
@@ -582,10 +1613,29 @@ BOOTSTRAP_MODE:
         /* schedule received! */
         //DEBUG_PRINT_MSG_NOW("sched rcv (%u %u)", gmw_payload[0], gmw_payload[1]);
       } else {
+  #if GMW_CONF_USE_CONTROL_SKIP
+        /* the schedule of this round has been announced: skip the control
+         * slot if the start of the round is known accurately enough */
+        control_skipped = (control_skip_cnt &&
+                           GMW_RUNNING == sync_state &&
+                           drift_cnt >= GMW_CONF_DRIFT_MIN_SAMPLES &&
+                           stats.t_ref_err <= GMW_CONF_CONTROL_SKIP_MAX_ERR);
+        if(!control_skipped)
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
         /* max packet length was set at end of last round */
         GMW_RCV_CONTROL();
       }
 
+  #if GMW_CONF_USE_CONTROL_SKIP
+      if(control_skipped) {
+        control_skip_cnt--;
+        t_ref = drift_predict(drift_x, NULL);
+        control.schedule.time += control.schedule.period;
+        global_time = control.schedule.time;
+        sync_event  = GMW_EVT_CONTROL_SKIPPED;
+        pkt_event   = GMW_EVT_PKT_SKIPPED;
+      } else
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
       /* did we receive a synced glossy packet?
        * If so, we know for sure we successfully received a control packet
        * -> True only assuming there are no other Glossy network running in 
@@ -603,12 +1653,23 @@ BOOTSTRAP_MODE:
         //DEBUG_PRINT_MSG_NOW("t_ref: %llu", t_ref);
 
         /* reconstruct the control struct */
-        if(!gmw_control_decompile_from_buffer(&control, gmw_payload,
-                                              GMW_GET_PAYLOAD_LEN())) {
+        uint8_t decompile_result = gmw_control_decompile_from_buffer(
+                                     &control, gmw_payload,
+                                     GMW_GET_PAYLOAD_LEN());
+        if(!decompile_result) {
           DEBUG_PRINT_MSG_NOW("Reception of control buggy. "
                               "Back to bootstrap.");
           goto BOOTSTRAP_MODE;
         }
+  #if GMW_CONF_USE_CONTROL_DELTA
+        if(decompile_result == GMW_CONTROL_DELTA_MISMATCH) {
+          /* still synchronized (t_ref is valid), but the slot list is
+           * unknown until the next full control packet: the round has no
+           * data slots */
+          DEBUG_PRINT_MSG_NOW("Delta schedule cannot be applied.");
+          sync_event = GMW_EVT_CONTROL_PARTIAL;
+        }
+  #endif /* GMW_CONF_USE_CONTROL_DELTA */
 
   #if GMW_CONF_USE_MAGIC_NUMBER
         /* check the magic number */
@@ -619,6 +1680,11 @@ BOOTSTRAP_MODE:
         }
   #endif /*GMW_CONF_USE_MAGIC_NUMBER*/
 
+  #if GMW_CONF_USE_CONTROL_SKIP
+        control_skip_cnt = (GMW_EVT_CONTROL_RCVD == sync_event) ?
+                           control.schedule.n_skip : 0;
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
+
         /* store current config if received */
         if(GMW_CONTROL_HAS_CONFIG(&control)) {
           /**
@@ -638,11 +1704,19 @@ BOOTSTRAP_MODE:
         DEBUG_PRINT_MSG_NOW("Schedule missed or corrupted.");
         /* mark config as non valid */
         is_current_config_valid = 0;
+  #if GMW_CONF_USE_CONTROL_SKIP
+        control_skip_cnt = 0;
+  #endif /* GMW_CONF_USE_CONTROL_SKIP */
         /* we can only estimate t_ref */
+  #if GMW_CONF_DRIFT_WINDOW
+        if(drift_cnt >= GMW_CONF_DRIFT_MIN_SAMPLES) {
+          t_ref = drift_predict(drift_x, NULL);
+        } else
+  #endif /* GMW_CONF_DRIFT_WINDOW */
         t_ref += ((int32_t)control.schedule.period * GMW_RTIMER_SECOND +
            GMW_PPM_TO_TICKS((uint32_t)control.schedule.period * stats.drift)) /
            GMW_CONF_TIME_SCALE;
-  #if GMW_CONF_USE_DRIFT_COMPENSATION
+  #if GMW_CONF_USE_DRIFT_COMPENSATION && !GMW_CONF_DRIFT_WINDOW
         /* make sure t_ref is not used for drift compensation in this round */
         period_last = 0;
   #endif /* GMW_CONF_USE_DRIFT_COMPENSATION */
@@ -682,9 +1756,19 @@ BOOTSTRAP_MODE:
       if(GMW_BOOTSTRAP == sync_state) {
         goto BOOTSTRAP_MODE;
       }
+      if(bootstrapping) {
+        /* (re)joined */
+        stats.t_bootstrap_last = GMW_TICKS_TO_MS(t_ref - t_bootstrap_start);
+        bootstrapping = 0;
+        DEBUG_PRINT_INFO("synchronized after %lums (listened %lums in total)",
+                         (unsigned long)stats.t_bootstrap_last,
+                         (unsigned long)GMW_TICKS_TO_MS(
+                           (gmw_rtimer_clock_t)stats.t_bootstrap_listen));
+      }
 
       /* store current config if received */
       if(GMW_CONTROL_HAS_CONFIG(&control)) {
+        check_hopping_mode(&control.config);
         memcpy(current_config, &control.config,
                sizeof(gmw_config_t));
       }
@@ -696,7 +1780,9 @@ BOOTSTRAP_MODE:
 
     /* reset variables */
     n_missed_slots = 0;
-    missed_slots = 0;
+    slot_cnt = 0;
+    t_gap_used_round = 0;
+    memset(missed_slots, 0, sizeof(missed_slots));
 
   #if GMW_CONF_USE_AUTOCLEAN
     /* if AUTOCLEAN is set, zero-ed the middleware send/receive buffer */
@@ -714,33 +1800,136 @@ BOOTSTRAP_MODE:
     /* permission to participate in this round? */
     if(GMW_RUNNING == sync_state) {
 
+  #if GMW_CONF_MAX_ROUND_PRE_SLOTS
+      /* let the application prepare the payloads of all its slots at once,
+       * this keeps the on_slot_pre callbacks out of the inter-slot gaps */
+      round_pre_cnt = 0;
+      round_pre_idx = 0;
+      if(gmw_impl->on_round_pre) {
+        round_pre_cnt = gmw_impl->on_round_pre(&control, round_pre_payloads,
+                                               GMW_CONF_MAX_ROUND_PRE_SLOTS);
+        if(round_pre_cnt > GMW_CONF_MAX_ROUND_PRE_SLOTS) {
+          DEBUG_PRINT_ERROR("on_round_pre returned an invalid count");
+          round_pre_cnt = GMW_CONF_MAX_ROUND_PRE_SLOTS;
+        }
+      }
+  #endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
+
+  #if GMW_CONF_USE_INTEREST_MASK
+      /* let the application select the slots it takes part in */
+      if(gmw_impl->on_round_interest) {
+        memset(interest_mask, 0, sizeof(interest_mask));
+        gmw_impl->on_round_interest(&control, interest_mask);
+      } else {
+        memset(interest_mask, 0xff, sizeof(interest_mask));
+      }
+  #endif /* GMW_CONF_USE_INTEREST_MASK */
+
       /* --- DATA SLOTS --- */
-      static uint8_t slot_idx;
+      static uint16_t slot_idx;
       for(slot_idx = 0; slot_idx < GMW_SCHED_N_SLOTS(&control.schedule);
           slot_idx++) {
 
-        /* prepare variables for current slot */
       #define IS_INITIATOR        (control.schedule.slot[slot_idx] == node_id)
       #define IS_CONTENTION_SLOT  (GMW_SLOT_CONTENTION == \
                                    control.schedule.slot[slot_idx])
+
+      #if GMW_CONF_USE_INTEREST_MASK
+        /* sleep through a run of slots without interest: only advance the
+         * slot start and wake up once, right before the next slot of
+         * interest */
+        if(!IS_INITIATOR && !GMW_IS_INTERESTED(slot_idx)) {
+          do {
+            slot_start += GMW_CONTROL_GET_SLOT_CONFIG_TIME(&control,
+                                                           slot_idx) +
+                          GMW_GAP_TIME_TO_TICKS(current_config->gap_time);
+            slot_cnt++;   /* keeps the per-slot hopping sequence */
+            stats.slot_sleep_cnt++;
+            slot_idx++;
+          } while(slot_idx < GMW_SCHED_N_SLOTS(&control.schedule) &&
+                  !IS_INITIATOR && !GMW_IS_INTERESTED(slot_idx));
+
+          if(GMW_CHECK_ROUND_OVERRUN(slot_start, t_start, control)) {
+            DEBUG_PRINT_ERROR("Round overruns. Aborted after slot %u",
+                              slot_idx - 1);
+            break;
+          }
+          if(slot_idx >= GMW_SCHED_N_SLOTS(&control.schedule)) {
+            /* no more slots of interest in this round */
+            break;
+          }
+        }
+      #endif /* GMW_CONF_USE_INTEREST_MASK */
+
+        /* prepare variables for current slot */
         payload_len         = 0;
         n_rx                = 0;
         n_rx_started        = 0;
         current_slot_time   = GMW_CONTROL_GET_SLOT_CONFIG_TIME(&control,
                                                               slot_idx);
 
-        /* on_slot_pre_callback */
-        gmw_skip_event_t skip_event;  /* no need to make this static */
-        skip_event = gmw_impl->on_slot_pre(slot_idx,
-                                           control.schedule.slot[slot_idx],
-                                           &payload_len,
-                                           gmw_payload,
-                                           IS_INITIATOR,
-                                           IS_CONTENTION_SLOT);
+        slot_payload        = gmw_payload;
+
+        /* payload prepared in advance or on_slot_pre_callback */
+        gmw_skip_event_t skip_event = GMW_EVT_SKIP_DEFAULT;  /* not static */
+        gmw_slot_payload_t* prepared = get_round_pre_payload(slot_idx);
+        if(prepared) {
+          payload_len  = prepared->len;
+          slot_payload = prepared->payload;
+        } else if(gmw_impl->on_slot_pre) {
+          GMW_HIST_START();
+          skip_event = gmw_impl->on_slot_pre(slot_idx,
+                                             control.schedule.slot[slot_idx],
+                                             &payload_len,
+                                             gmw_payload,
+                                             IS_INITIATOR,
+                                             IS_CONTENTION_SLOT);
+          GMW_HIST_STOP(slot_pre);
+        } else if(IS_INITIATOR) {
+          /* nothing to send in our own slot */
+          skip_event = GMW_EVT_SKIP_SLOT;
+        }
+
+      #if GMW_CONF_USE_EARLY_TERMINATION
+        /* append the flags to the floods of the host, send a termination
+         * flood (flags only) if the round ends and there is no payload */
+        if(IS_INITIATOR && GMW_IS_HOST) {
+          if(end_of_round) {
+            skip_event = GMW_EVT_SKIP_DEFAULT;
+          }
+          if(skip_event != GMW_EVT_SKIP_SLOT) {
+            if(payload_len > GMW_CONF_MAX_DATA_PKT_LEN) {
+              DEBUG_PRINT_ERROR("host payload too long, truncated");
+              payload_len = GMW_CONF_MAX_DATA_PKT_LEN;
+            }
+            slot_payload[payload_len++] = end_of_round ?
+                                          GMW_FLAG_END_OF_ROUND : 0;
+          }
+        }
+        end_of_round_slot = slot_idx + 1;
+      #endif /* GMW_CONF_USE_EARLY_TERMINATION */
+
+        /* per-slot channel hopping (overrides a channel set by the
+         * application) */
+        if(GMW_PER_SLOT_HOPPING == current_config->channel_hopping_mode) {
+          GMW_SET_RF_CHANNEL(get_hopping_channel(slot_cnt));
+        }
+        slot_cnt++;
 
         /* set t_now, this allows us to determine if we missed the slot */
         t_now = GMW_RTIMER_NOW();
 
+        /* processing time since the nominal end of the previous slot */
+        if(slot_cnt > 1) {
+          gmw_rtimer_clock_t t_prev_end = slot_start -
+                             GMW_GAP_TIME_TO_TICKS(current_config->gap_time);
+          if(t_now > t_prev_end) {
+            uint16_t t_used = MIN(GMW_TICKS_TO_US(t_now - t_prev_end), 0xffff);
+            t_gap_used_round     = MAX(t_used, t_gap_used_round);
+            stats.t_gap_used_max = MAX(t_used, stats.t_gap_used_max);
+          }
+        }
+
         if(skip_event == GMW_EVT_SKIP_SLOT) {
           /* Instruction to skip the slot, but we have payload to send... */
           pkt_event   = GMW_EVT_PKT_SKIPPED;
@@ -752,24 +1941,28 @@ BOOTSTRAP_MODE:
         /* did we miss the slot? */
         } else if(slot_start <= t_now) {
           n_missed_slots++;
-          missed_slots |= (1 << slot_idx);
+          missed_slots[slot_idx >> 3] |= (1 << (slot_idx & 0x07));
           /* we are too late, abort the flood */
           pkt_event   = GMW_EVT_PKT_MISSED;
           payload_len = 0;
           DEBUG_PRINT_VERBOSE("slot %u skipped (missed by %ld ticks)",
-                              slot_idx, (int32_t)(t_now - slot_start));
+                              slot_idx, (long)(t_now - slot_start));
 
         } else if(IS_INITIATOR || (IS_CONTENTION_SLOT && payload_len)) {
           /* INITIATE the flood */
           GMW_WAIT_UNTIL(slot_start);
           GMW_SEND_PACKET();
           pkt_event = GMW_EVT_PKT_OK;
+          GMW_ENERGY_STOP(GMW_ENERGY_TX);
+    #if GMW_CONF_USE_ENERGY_STATS
+          stats.energy_round.bytes_sent += payload_len;
+    #endif /* GMW_CONF_USE_ENERGY_STATS */
           DEBUG_PRINT_VERBOSE("packet sent (%ub)", payload_len);
 
         } else {
           /* RECEIVER */
           gmw_rtimer_clock_t slot_start_with_guard = slot_start -
-                                        GMW_US_TO_TICKS(GMW_CONF_T_GUARD_SLOT);
+                                                     GMW_T_GUARD_SLOT;
 
           /* if we have passed the guard time, suppress the guard time */
           if(t_now >= slot_start_with_guard) {
@@ -794,6 +1987,30 @@ BOOTSTRAP_MODE:
             pkt_event = GMW_EVT_PKT_OK;
             DEBUG_PRINT_VERBOSE("received packet, len=%u", payload_len);
             stats.pkt_rcvd_cnt++;
+      #if GMW_CONF_USE_HISTOGRAMS
+            if(stats.relay_cnt != GMW_RELAY_COUNT_UNDEF) {
+              uint8_t bin = MIN(stats.relay_cnt, GMW_CONF_HIST_N_BINS - 1);
+              if(stats.hist.relay_cnt[bin] < 0xffff) {
+                stats.hist.relay_cnt[bin]++;
+              }
+        #ifdef GMW_GET_T_FLOOD_END
+              /* the node stops after its last retransmission, as measured by
+               * the primitive (an older timestamp belongs to another slot) */
+              gmw_rtimer_clock_t t_end = GMW_GET_T_FLOOD_END();
+              if(t_end > slot_start) {
+                hist_add(stats.hist.flood_end,
+                         (uint32_t)GMW_TICKS_TO_US(t_end - slot_start));
+              }
+        #else /* GMW_GET_T_FLOOD_END */
+              /* not measured by the platform: estimate the end of the flood
+               * from the relay count (Glossy model, without the slack) */
+              hist_add(stats.hist.flood_end, (uint32_t)
+                GMW_T_SLOT_MIN(payload_len + GMW_CONF_RF_OVERHEAD,
+                  GMW_CONTROL_GET_SLOT_CONFIG_N_RETRANS(&control, slot_idx),
+                  (stats.relay_cnt + 1)) - GMW_T_SLOT_SLACK);
+        #endif /* GMW_GET_T_FLOOD_END */
+            }
+      #endif /* GMW_CONF_USE_HISTOGRAMS */
 
           } else if(GMW_PKT_CORRUPTED) {
             pkt_event = GMW_EVT_PKT_CORRUPTED;
@@ -816,17 +2033,54 @@ BOOTSTRAP_MODE:
             DEBUG_PRINT_ERROR("invalid packet reception event");
             pkt_event = GMW_EVT_PKT_SILENCE;
           }
+          GMW_ENERGY_STOP((GMW_EVT_PKT_OK == pkt_event) ?
+                          GMW_ENERGY_RX_USED : GMW_ENERGY_RX_WASTED);
+    #if GMW_CONF_USE_ENERGY_STATS
+          if(GMW_EVT_PKT_OK == pkt_event) {
+            stats.energy_round.bytes_rcvd += payload_len;
+          }
+    #endif /* GMW_CONF_USE_ENERGY_STATS */
+    #if GMW_CONF_USE_AUTO_SLOT_TIME
+          if(GMW_IS_HOST && GMW_EVT_PKT_OK == pkt_event &&
+             stats.relay_cnt != GMW_RELAY_COUNT_UNDEF) {
+            auto_st_hops_seen = MAX(auto_st_hops_seen,
+                                    MIN(stats.relay_cnt + 1,
+                                        GMW_CONF_MAX_HOPS));
+          }
+    #endif /* GMW_CONF_USE_AUTO_SLOT_TIME */
+    #if GMW_CONF_USE_ADAPTIVE_N_TX
+          if(GMW_IS_HOST && !IS_CONTENTION_SLOT &&
+             (GMW_CONF_ADAPTIVE_N_TX_SILENCE_IS_LOSS ||
+              GMW_EVT_PKT_SILENCE != pkt_event)) {
+            n_tx_update(control.schedule.slot[slot_idx],
+                        GMW_CONTROL_GET_SLOT_CONFIG_N_RETRANS(&control,
+                                                              slot_idx),
+                        GMW_EVT_PKT_OK == pkt_event, stats.relay_cnt);
+          }
+    #endif /* GMW_CONF_USE_ADAPTIVE_N_TX */
+        }
+
+      #if GMW_CONF_USE_EARLY_TERMINATION
+        /* strip the flags of a host flood */
+        uint8_t round_ended = 0;  /* not static */
+        if(GMW_SLOT_IS_HOST_SLOT && GMW_EVT_PKT_OK == pkt_event &&
+           payload_len) {
+          payload_len--;
+          round_ended = slot_payload[payload_len] & GMW_FLAG_END_OF_ROUND;
         }
+      #endif /* GMW_CONF_USE_EARLY_TERMINATION */
 
         /* on_slot_post_callback */
         static gmw_repeat_event_t repeat_event;
+        GMW_HIST_START();
         repeat_event = gmw_impl->on_slot_post(slot_idx,
                                               control.schedule.slot[slot_idx],
                                               payload_len,
-                                              gmw_payload,
+                                              slot_payload,
                                               IS_INITIATOR,
                                               IS_CONTENTION_SLOT,
                                               pkt_event);
+        GMW_HIST_STOP(slot_post);
 
         /* store post-precessing time */
         stats.t_proc_max = MAX((uint16_t)
@@ -842,6 +2096,17 @@ BOOTSTRAP_MODE:
         memset(gmw_payload, 0, GMW_MAX_PKT_LEN);
   #endif /* GMW_CONF_USE_AUTOCLEAN */
 
+  #if GMW_CONF_USE_EARLY_TERMINATION
+        if(round_ended) {
+          /* the host ended the round: sleep until the next one */
+          stats.slot_saved_cnt += GMW_SCHED_N_SLOTS(&control.schedule) -
+                                  slot_idx - 1;
+          DEBUG_PRINT_VERBOSE("round ended by the host after slot %u",
+                              slot_idx);
+          break;
+        }
+  #endif /* GMW_CONF_USE_EARLY_TERMINATION */
+
         /* check if the round is not getting too long */
         if(GMW_CHECK_ROUND_OVERRUN(slot_start, t_start, control)) {
           DEBUG_PRINT_ERROR("Round overruns. Aborted after slot %u", slot_idx);
@@ -854,19 +2119,60 @@ BOOTSTRAP_MODE:
         }
         if(repeat_event == GMW_EVT_REPEAT_ROUND) {
           /* when next incremented by the middleware, slot_idx becomes 0 */
-          slot_idx = 255;
+          slot_idx = 0xffff;
+    #if GMW_CONF_MAX_ROUND_PRE_SLOTS
+          round_pre_idx = 0;
+    #endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
         }
+    #if GMW_CONF_USE_EARLY_TERMINATION
+        end_of_round_slot = slot_idx + 1;     /* repeated slots included */
+    #endif /* GMW_CONF_USE_EARLY_TERMINATION */
       }
     }
 
+    if(GMW_PER_SLOT_HOPPING == current_config->channel_hopping_mode) {
+      /* back to the channel of the control slot */
+      GMW_SET_RF_CHANNEL(GMW_CONF_RF_TX_CHANNEL);
+    }
+
+  #if GMW_CONF_USE_EARLY_TERMINATION
+    /* a request made from now on applies to the next round */
+    end_of_round      = 0;
+    end_of_round_slot = 0;
+  #endif /* GMW_CONF_USE_EARLY_TERMINATION */
+  #if GMW_CONF_USE_ENERGY_STATS
+    energy_round_end();
+  #endif /* GMW_CONF_USE_ENERGY_STATS */
+
     gmw_impl->on_round_finished(&pre_post_proc);
 
+  #if GMW_CONF_USE_AUTO_GAP
+    if(GMW_IS_HOST) {
+      auto_gap_update(t_gap_used_round, n_missed_slots,
+                      (uint32_t)GMW_TICKS_TO_MS(GMW_RTIMER_NOW() - t_start));
+    } else {
+      auto_gap_src_update(t_gap_used_round, n_missed_slots);
+    }
+  #endif /* GMW_CONF_USE_AUTO_GAP */
+  #if GMW_CONF_USE_AUTO_SLOT_TIME
+    if(GMW_IS_HOST) {
+      auto_slot_time_update();
+    }
+  #endif /* GMW_CONF_USE_AUTO_SLOT_TIME */
+
     /* --- COMMUNICATION ROUND ENDS --- */
 
     if(!GMW_IS_HOST) {
-  #if GMW_CONF_USE_DRIFT_COMPENSATION
+  #if GMW_CONF_DRIFT_WINDOW
+      if(GMW_EVT_CONTROL_RCVD == sync_event ||
+         GMW_EVT_CONTROL_PARTIAL == sync_event) {
+        drift_add_sample(drift_x, t_ref);
+      }
+      drift_x += control.schedule.period;
+  #elif GMW_CONF_USE_DRIFT_COMPENSATION
       /* only update drift compensation if synced */
-      if(GMW_EVT_CONTROL_RCVD == sync_event) {
+      if(GMW_EVT_CONTROL_RCVD == sync_event ||
+         GMW_EVT_CONTROL_PARTIAL == sync_event) {
         if(period_last) {
           /* estimate the clock drift in ppm */
           /* convert from ticks to us, then normalize (divide by the period) to
@@ -892,10 +2198,9 @@ BOOTSTRAP_MODE:
       stats.suspended_cnt++;
     }
 
-    /* print missed slot count and bitshifted 1 marking each missed slot */
+    /* print missed slot count and the bitmap marking each missed slot */
     if(n_missed_slots) {
-      DEBUG_PRINT_WARNING("Missed %u slots! Binary: %" PRIX32, n_missed_slots,
-                          missed_slots);
+      print_missed_slots(n_missed_slots);
     }
 
     /* poll the post process */
@@ -916,13 +2221,29 @@ BOOTSTRAP_MODE:
           GMW_US_TO_TICKS(GMW_CONF_PREROUND_SETUP_TIME) -
           pre_process_offset;
     } else {
-      /* start of next round in clock ticks */
-      start_of_next_round = t_ref +
-          ((gmw_rtimer_clock_t)control.schedule.period * GMW_RTIMER_SECOND +
-           GMW_PPM_TO_TICKS((uint32_t)control.schedule.period * stats.drift)) /
-           GMW_CONF_TIME_SCALE -
-          GMW_US_TO_TICKS(GMW_CONF_T_GUARD_ROUND) -
-          pre_process_offset;
+  #if GMW_CONF_DRIFT_WINDOW
+      if(drift_cnt >= GMW_CONF_DRIFT_MIN_SAMPLES) {
+        /* predict the start of the next round and widen the guard by the
+         * estimated error of the prediction */
+        uint32_t err;
+        start_of_next_round = drift_predict(drift_x, &err);
+        stats.t_ref_err = MIN(err, 0xffff);
+        err = err * (100 + GMW_CONF_DRIFT_GUARD_MARGIN) / 100;
+        t_guard_round = GMW_US_TO_TICKS((gmw_rtimer_clock_t)
+                          MIN(MAX(err, GMW_CONF_DRIFT_T_GUARD_MIN),
+                              GMW_CONF_T_GUARD_ROUND));
+        start_of_next_round -= t_guard_round + pre_process_offset;
+      } else
+  #endif /* GMW_CONF_DRIFT_WINDOW */
+      {
+        /* start of next round in clock ticks */
+        start_of_next_round = t_ref +
+            ((gmw_rtimer_clock_t)control.schedule.period * GMW_RTIMER_SECOND +
+             GMW_PPM_TO_TICKS((uint32_t)control.schedule.period * stats.drift))
+             / GMW_CONF_TIME_SCALE -
+            GMW_T_GUARD_ROUND -
+            pre_process_offset;
+      }
     }
 
     /* state keeping */
@@ -931,9 +2252,15 @@ BOOTSTRAP_MODE:
     /* sanity check - TODO: needed?*/
     if(GMW_PERIOD_TO_MS(control.schedule.period) < measured_round_time_ms) {
       DEBUG_PRINT_WARNING("Total measured round time %lums exceeds the round "
-                        "period!", measured_round_time_ms);
+                        "period!", (unsigned long)measured_round_time_ms);
     }
     stats.t_round_max = MAX(measured_round_time_ms, stats.t_round_max);
+  #if GMW_CONF_USE_HISTOGRAMS
+    hist_add(stats.hist.round, measured_round_time_ms);
+    t_now = GMW_RTIMER_NOW();
+    hist_add(stats.hist.slack, (start_of_next_round > t_now) ?
+             (uint32_t)GMW_TICKS_TO_MS(start_of_next_round - t_now) : 0);
+  #endif /* GMW_CONF_USE_HISTOGRAMS */
     stats.t_round_last = (uint32_t)(GMW_RTIMER_NOW() - start_of_current_round);
 
     start_of_current_round = start_of_next_round;
@@ -1013,6 +2340,7 @@ copy_control_if_updated(void)
   if(NULL != new_control) {
     memcpy(&control, new_control, sizeof(gmw_control_t));
     new_control = NULL;
+    check_hopping_mode(&control.config);
   }
 }
 /*---------------------------------------------------------------------------*/
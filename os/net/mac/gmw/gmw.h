@@ -66,6 +66,9 @@
 #include "gmw-conf.h"
 #include "gmw-types.h"
 #include "gmw-control.h"
+#if GMW_CONF_USE_CONTROL_SCHED_COMPRESSION
+#include "gmw-sched-compress.h"
+#endif /* GMW_CONF_USE_CONTROL_SCHED_COMPRESSION */
 #if GMW_CONF_USE_NOISE_DETECTION
 #include "gmw-noise-detect.h"
 #endif /* GMW_CONF_USE_NOISE_DETECTION */
@@ -79,10 +82,16 @@
 
 /* important values, do not modify */
 
+/*
+ * Slack time in us added to the minimum duration of a flood (radio setup and
+ * processing after the flood).
+ */
+#define GMW_T_SLOT_SLACK                250
+
 /*
  * Minimum duration in us of a Glossy flood according to "Energy-efficient
  * Real-time Communication in Multi-hop Low-power Wireless Networks"
- * (Zimmerling et al.) plus 250 us of slack time.
+ * (Zimmerling et al.) plus GMW_T_SLOT_SLACK.
  * GMW_T_HOP(len) should return the duration in us the radio hardware needs to
  *  transmit a packet of length len.
  * @param len   total size of the packet sent by the hardware
@@ -91,10 +100,11 @@
  * */
 #define GMW_T_SLOT_MIN(len, n, hops)    ((hops + (2 * n) - 1) * \
                                           GMW_T_HOP(len) + \
-                                          250 )
+                                          GMW_T_SLOT_SLACK )
 /* same formula but adapted for the strobing mode */
 #define GMW_T_SLOT_STROBE_MIN(len, n)    (n * (GMW_T_HOP(len) + \
-                                          STROBING_CONF_TX_TO_TX_DELAY) + 250 )
+                                          STROBING_CONF_TX_TO_TX_DELAY) + \
+                                          GMW_T_SLOT_SLACK )
 
 /*---------------------------------------------------------------------------*/
 /* some macros to calculate from us to the base time unit used in the config
@@ -154,9 +164,45 @@
 /*---------------------------------------------------------------------------*/
 
 #if GMW_CONF_USE_MULTI_PRIMITIVES
-uint8_t gmw_primitive;                              /* current primitive */
+extern uint8_t gmw_primitive;                       /* current primitive */
+
+/**
+ * @brief                       Register a synchronous transmission primitive
+ *                              (replaces the primitive with the same ID).
+ * @param id                    Primitive ID as used in the config and the
+ *                              slot config (< GMW_CONF_MAX_PRIMITIVES)
+ * @param prim                  Pointer to the vtable (must remain valid),
+ *                              NULL to remove the primitive
+ * @return                      1 if successful, 0 otherwise
+ *
+ * @note                        The primitives 0 to 3 of the platform
+ *                              configuration are registered by default.
+ *                              Must be identical on all nodes.
+ */
+uint8_t gmw_register_primitive(uint8_t id, const gmw_primitive_t* prim);
 #endif /* GMW_CONF_USE_MULTI_PRIMITIVES */
 
+/**
+ * @brief                       End the current round early (host only,
+ *                              requires GMW_CONF_USE_EARLY_TERMINATION).
+ *                              The end-of-round flag is sent with the next
+ *                              flood of the host; if the host has nothing to
+ *                              send in that slot, a termination flood without
+ *                              payload is sent. All nodes that receive the
+ *                              flag skip the remaining slots of the round.
+ * @return                      1 if a slot of the host follows in the current
+ *                              round (i.e. the flag is sent), 0 otherwise
+ *
+ * @note                        Call from the callbacks of a round (from
+ *                              on_control_slot_post up to the last
+ *                              on_slot_post). A request made after the last
+ *                              slot applies to the next round.
+ * @note                        Only the slots assigned to HOST_ID carry the
+ *                              flag: in a round without such a slot after
+ *                              the call, the round is not ended early.
+ */
+uint8_t gmw_end_round(void);
+
 /*---------------------------------------------------------------------------*/
 
 /**
@@ -222,6 +268,54 @@ const gmw_get_stats(void);
 void
 gmw_stats_reset(void);
 
+/**
+ * @brief                       Take a snapshot of the latency histograms
+ *                              (requires GMW_CONF_USE_HISTOGRAMS), e.g. in
+ *                              the post-process.
+ * @param out                   Destination of the copy, may be NULL
+ * @param reset                 Clear the histograms after the copy if set
+ */
+void
+gmw_get_histograms(gmw_histograms_t* out, uint8_t reset);
+
+/**
+ * @brief                       Get the state the adaptive N_TX controller has
+ *                              learned for an initiator (host only, requires
+ *                              GMW_CONF_USE_ADAPTIVE_N_TX)
+ * @param node_id               ID of the initiator
+ * @return                      The state or NULL if unknown
+ */
+const gmw_n_tx_state_t*
+gmw_get_n_tx_state(uint16_t node_id);
+
+/**
+ * @brief                       Get the timing report of this source if one
+ *                              is due (source only, requires
+ *                              GMW_CONF_USE_AUTO_GAP). A report is due if
+ *                              slots were missed, the processing time or the
+ *                              drift exceeds the last reported value, or
+ *                              GMW_CONF_AUTO_GAP_REPORT_ROUNDS rounds have
+ *                              passed since the last report.
+ * @param out                   Destination of the report
+ * @return                      1 if a report is due (it then counts as sent),
+ *                              0 otherwise
+ *
+ * @note                        The protocol on top of GMW has to deliver the
+ *                              report to the host (e.g. appended to a data
+ *                              packet) and pass it to gmw_report_src_timing().
+ */
+uint8_t
+gmw_get_timing_report(gmw_timing_report_t* out);
+
+/**
+ * @brief                       Pass a timing report received from a source
+ *                              to the gap and guard calibration (host only,
+ *                              requires GMW_CONF_USE_AUTO_GAP)
+ * @param report                The received report
+ */
+void
+gmw_report_src_timing(const gmw_timing_report_t* report);
+
 /** @} */
 
 /** @} */
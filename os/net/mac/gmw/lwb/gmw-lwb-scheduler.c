@@ -38,7 +38,25 @@
  *
  * The scheduler operates with a constant period and only accepts new
  * stream requests if the network is not yet saturated.
- * There is exactly one contention slot per round.
+ * The streams are kept in a list ordered by node ID and indexed by a hash
+ * table on (node ID, stream ID). The received data packets mark their stream
+ * in a bitmap, i.e. the processing of a round is O(number of streams).
+ * There is one contention slot per round, or up to LWB_CONF_MAX_CONT_SLOTS
+ * slots: their number is doubled after a round with a collision in a
+ * contention slot or in which all of them carried a request, and halved
+ * after a round in which they all stayed unused.
+ * The aggregate rate of the streams is accumulated in fixed point (i.e. it
+ * does not overflow for any number of streams and IPIs), and the data slots
+ * are assigned earliest deadline first with the deadline last_assigned + IPI
+ * of each stream. If the network is saturated, each stream thus gets a share
+ * of the slots proportional to 1 / IPI.
+ * Streams of a higher priority class are served before all streams of the
+ * lower classes, and the round period never exceeds the tightest deadline of
+ * the streams (the time a due slot may wait for its round).
+ * If LWB_CONF_SCHED_BACKLOG_SLOTS is set, the sources with a backlog (the
+ * number of packets left in their queue, reported in each data packet) get up
+ * to that many extra slots in the next round, which is moved forward to make
+ * room for them (the rounds stay full instead of adding short rounds).
  */
 
 #include "gmw-lwb.h"
@@ -53,24 +71,112 @@ typedef struct lwb_stream_list {
   struct lwb_stream_list *next;
   uint16_t node_id;
   uint16_t ipi;
+  uint16_t n_slots;                        /* # slots in the current round */
+  uint16_t deadline;                       /* max. latency, 0 = none */
   uint32_t last_assigned;
+  uint32_t rate;                           /* LWB_SCHED_RATE(ipi) */
   uint8_t  stream_id;
   uint8_t  n_cons_missed;
+  uint8_t  prio;                           /* priority class */
+  uint8_t  backlog;                        /* reported in the last round */
 } lwb_stream_list_t;
+/* size of the stream index (open addressing, at most half full) */
+#define LWB_SCHED_INDEX_SIZE  (2 * LWB_CONF_MAX_N_STREAMS)
+#if LWB_SCHED_INDEX_SIZE > 0xffff
+#error "LWB_CONF_MAX_N_STREAMS is too large"
+#endif
+/* position of a stream in the stream memory block */
+#define LWB_SCHED_STREAM_POS(s) \
+  ((uint16_t)((s) - (lwb_stream_list_t*)streams_memb.mem))
+#define LWB_SCHED_STREAM_AT(p)  (&((lwb_stream_list_t*)streams_memb.mem)[p])
+/* a rate of 1 packet per time unit in the fixed point rate accumulator (the
+ * rate of a single stream fits into 32 bits) */
+#define LWB_SCHED_RATE_ONE      ((uint32_t)1 << 31)
+/* rate of a stream, 1 / IPI rounded up (the period never exceeds the optimal
+ * period), only computed when the IPI changes */
+#define LWB_SCHED_RATE(ipi)     ((LWB_SCHED_RATE_ONE + (ipi) - 1) / (ipi))
 /*---------------------------------------------------------------------------*/
 static uint16_t          period;
 static uint32_t          time;               /* global time */
 static uint16_t          n_streams;          /* # streams */
-static uint8_t           saturated;
-static uint32_t          data_cnt;
-static uint16_t          data_ipi;
+static uint64_t          data_rate;          /* sum of 1 / IPI */
+static uint16_t          deadline_min;       /* tightest stream deadline */
+#if LWB_CONF_SCHED_BACKLOG_SLOTS
+static uint16_t          backlog_total;      /* of all sources */
+#endif /* LWB_CONF_SCHED_BACKLOG_SLOTS */
+static lwb_class_stats_t class_stats[LWB_CONF_N_STREAM_CLASSES];
 static uint8_t           n_pending_sack;
 static uint8_t           stream_req_in_last_round;
+#if LWB_CONF_MAX_CONT_SLOTS > 1
+static uint8_t           n_cont_slots = 1;
+static uint8_t           n_cont_collisions;  /* in the last main round */
+static uint8_t           n_cont_used;
+#endif /* LWB_CONF_MAX_CONT_SLOTS */
 static lwb_stream_ack_t  pending_sack[LWB_CONF_SCHED_MAX_PENDING_SACK];
 LIST(streams_list);
 MEMB(streams_memb, lwb_stream_list_t, LWB_CONF_MAX_N_STREAMS);
+/* hash table: position of the stream in streams_memb + 1 (0 = empty) */
+static uint16_t          stream_index[LWB_SCHED_INDEX_SIZE];
+/* one bit per stream (position in streams_memb), set if a data packet of the
+ * stream has been received in the last round */
+static uint8_t           stream_rcvd[(LWB_CONF_MAX_N_STREAMS + 7) / 8];
+/* min-heap of the streams (positions) with a due slot, by deadline */
+static uint16_t          edf_heap[LWB_CONF_MAX_N_STREAMS];
+static uint16_t          edf_rot;            /* tie-break rotation of a round */
 /*---------------------------------------------------------------------------*/
-static inline uint16_t gcd(uint16_t u, uint16_t v);
+static inline uint16_t
+stream_hash(uint16_t node_id, uint8_t stream_id)
+{
+  return (uint16_t)(((uint32_t)node_id * LWB_CONF_MAX_N_STREAMS_PER_NODE +
+                     stream_id) % LWB_SCHED_INDEX_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief look up a stream in the index
+ * @param[out] out_idx position of the stream in the index or, if the stream
+ * does not exist, of the free entry where it has to be inserted
+ * @return the stream or 0 if it does not exist
+ */
+static lwb_stream_list_t*
+stream_find(uint16_t node_id, uint8_t stream_id, uint16_t* out_idx)
+{
+  uint16_t idx = stream_hash(node_id, stream_id);
+  while(stream_index[idx]) {
+    lwb_stream_list_t* s = LWB_SCHED_STREAM_AT(stream_index[idx] - 1);
+    if(s->node_id == node_id && s->stream_id == stream_id) {
+      break;
+    }
+    idx = (idx + 1) % LWB_SCHED_INDEX_SIZE;
+  }
+  *out_idx = idx;
+  return stream_index[idx] ? LWB_SCHED_STREAM_AT(stream_index[idx] - 1) : 0;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief remove an entry from the index, the following entries of the same
+ * cluster are moved back such that no lookup ends at the new gap
+ */
+static void
+stream_index_remove(uint16_t idx)
+{
+  uint16_t next = idx;
+  stream_index[idx] = 0;
+  while(1) {
+    next = (next + 1) % LWB_SCHED_INDEX_SIZE;
+    if(!stream_index[next]) {
+      break;
+    }
+    lwb_stream_list_t* s = LWB_SCHED_STREAM_AT(stream_index[next] - 1);
+    uint16_t home = stream_hash(s->node_id, s->stream_id);
+    /* move the entry unless its home lies cyclically in (idx, next] */
+    if((idx < next) ? (home <= idx || home > next) :
+                      (home <= idx && home > next)) {
+      stream_index[idx]  = stream_index[next];
+      stream_index[next] = 0;
+      idx = next;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 static inline void
 lwb_sched_del_stream(lwb_stream_list_t* stream) 
@@ -80,6 +186,11 @@ lwb_sched_del_stream(lwb_stream_list_t* stream)
   }
   uint16_t device_id  = stream->node_id;
   uint8_t  stream_id  = stream->stream_id;
+  uint16_t idx;
+  stream_find(device_id, stream_id, &idx);
+  stream_index_remove(idx);
+  idx = LWB_SCHED_STREAM_POS(stream);
+  stream_rcvd[idx >> 3] &= ~(1 << (idx & 7));
   list_remove(streams_list, stream);
   memb_free(&streams_memb, stream);
   n_streams--;
@@ -107,13 +218,9 @@ lwb_sched_process_stream_req(const lwb_stream_req_t* req)
   }
   stream_req_in_last_round = 1;
   /* check if stream already exists */
-  lwb_stream_list_t *stream = 0;
-  for(stream = list_head(streams_list); stream != 0; stream = stream->next) {
-    if(req->sender_id == stream->node_id &&
-       req->header.stream_id == stream->stream_id) {
-      break;
-    }
-  }
+  uint16_t idx;
+  lwb_stream_list_t *stream = stream_find(req->sender_id,
+                                          req->header.stream_id, &idx);
   /* add or remove is implicitly given by the IPI (0 implies 'remove') */
   if(req->ipi > 0) {
     /* add or adjust a stream */
@@ -121,9 +228,13 @@ lwb_sched_process_stream_req(const lwb_stream_req_t* req)
     if(((int32_t)time + req->offset) > 0) {
       last_assigned = (int32_t)time + req->offset;
     }
+    uint8_t prio = MIN(req->prio, LWB_CONF_N_STREAM_CLASSES - 1);
     if(stream) {
       /* already exists -> update the IPI */
       stream->ipi           = req->ipi;
+      stream->rate          = LWB_SCHED_RATE(req->ipi);
+      stream->prio          = prio;
+      stream->deadline      = req->deadline;
       stream->last_assigned = last_assigned;
       stream->n_cons_missed = 0;         /* reset this counter */
       DEBUG_PRINT_INFO("stream %u of node %u updated",
@@ -138,6 +249,9 @@ lwb_sched_process_stream_req(const lwb_stream_req_t* req)
       }
       stream->node_id       = req->sender_id;
       stream->ipi           = req->ipi;
+      stream->rate          = LWB_SCHED_RATE(req->ipi);
+      stream->prio          = prio;
+      stream->deadline      = req->deadline;
       stream->last_assigned = last_assigned;
       stream->stream_id     = req->header.stream_id;
       stream->n_cons_missed = 0;
@@ -150,6 +264,7 @@ lwb_sched_process_stream_req(const lwb_stream_req_t* req)
         }
       }
       list_insert(streams_list, prev, stream);
+      stream_index[idx] = LWB_SCHED_STREAM_POS(stream) + 1;
       n_streams++;
       DEBUG_PRINT_INFO("stream %u of node %u registered",
                        stream->stream_id,
@@ -158,6 +273,8 @@ lwb_sched_process_stream_req(const lwb_stream_req_t* req)
     /* insert into the list of pending S-ACKs */
     pending_sack[n_pending_sack].recipient_id = req->sender_id;
     pending_sack[n_pending_sack].type         = LWB_PACKET_TYPE_ACK;
+    pending_sack[n_pending_sack].report       = 0;
+    pending_sack[n_pending_sack].backlog      = 0;
     pending_sack[n_pending_sack].stream_id    = req->header.stream_id;
     n_pending_sack++;
 
@@ -171,6 +288,49 @@ lwb_sched_process_stream_req(const lwb_stream_req_t* req)
   }
 }
 /*---------------------------------------------------------------------------*/
+void
+lwb_sched_process_data(uint16_t node_id, uint8_t stream_id, uint8_t backlog)
+{
+  uint16_t idx;
+  lwb_stream_list_t* stream = stream_find(node_id, stream_id, &idx);
+  if(stream) {
+    idx = LWB_SCHED_STREAM_POS(stream);
+    stream_rcvd[idx >> 3] |= (1 << (idx & 7));
+    /* the latest report of a node is the most accurate one; one packet
+     * generated after the last due slot of the stream is served by a regular
+     * slot of the next round and is not a backlog */
+    stream->backlog = backlog ? (backlog - 1) : 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+lwb_sched_process_cont_slot(gmw_pkt_event_t event)
+{
+#if LWB_CONF_MAX_CONT_SLOTS > 1
+  if(GMW_EVT_PKT_CORRUPTED == event || GMW_EVT_PKT_GARBAGE == event) {
+    n_cont_collisions++;
+  } else if(GMW_EVT_PKT_OK == event) {
+    n_cont_used++;
+  }
+#endif /* LWB_CONF_MAX_CONT_SLOTS */
+}
+/*---------------------------------------------------------------------------*/
+#if LWB_CONF_MAX_CONT_SLOTS > 1
+static inline void
+adapt_cont_slots(void)
+{
+  if(n_cont_collisions || n_cont_used >= n_cont_slots) {
+    /* collisions or all slots used (one of the colliding requests may have
+     * been captured): there are probably more requests pending */
+    n_cont_slots = MIN(n_cont_slots * 2, LWB_CONF_MAX_CONT_SLOTS);
+  } else if(!n_cont_used && n_cont_slots > 1) {
+    n_cont_slots /= 2;
+  }
+  n_cont_collisions = 0;
+  n_cont_used       = 0;
+}
+#endif /* LWB_CONF_MAX_CONT_SLOTS */
+/*---------------------------------------------------------------------------*/
 static inline uint16_t
 adapt_period(void)
 {
@@ -180,53 +340,110 @@ adapt_period(void)
     return LWB_CONF_SCHED_PERIOD_MIN;
   }
   stream_req_in_last_round = 0;
-  if(!data_cnt) {
+  if(!data_rate) {
     return LWB_CONF_SCHED_PERIOD_DEFAULT;     /* no streams */
   }
-  saturated = 0;
-  uint16_t new_period = (uint16_t)(((uint32_t)data_ipi *
-                                    LWB_MAX_DATA_SLOTS) / data_cnt);
+  uint16_t n_slots = LWB_MAX_DATA_SLOTS;
+#if LWB_CONF_SCHED_BACKLOG_SLOTS
+  /* move the next round forward just enough to leave room for the extra
+   * slots: the rounds stay full, a larger backlog takes several rounds */
+  n_slots -= MIN(backlog_total, LWB_CONF_SCHED_BACKLOG_SLOTS);
+#endif /* LWB_CONF_SCHED_BACKLOG_SLOTS */
+  uint64_t new_period = ((uint64_t)n_slots * LWB_SCHED_RATE_ONE) / data_rate;
   /* check for saturation */
   if(new_period < LWB_CONF_SCHED_PERIOD_MIN) {
     /* T_opt is smaller than LWB_CONF_SCHED_PERIOD_MIN */
     DEBUG_PRINT_WARNING("network saturated!");
-    saturated = 1;
     return LWB_CONF_SCHED_PERIOD_MIN;
   }
-  /* limit the period */
-  if(new_period > LWB_CONF_SCHED_PERIOD_MAX) {
-    return LWB_CONF_SCHED_PERIOD_MAX;
+  /* limit the period (a due slot waits less than one period) */
+  new_period = MIN(new_period, LWB_CONF_SCHED_PERIOD_MAX);
+  new_period = MIN(new_period, deadline_min);
+  return (uint16_t)MAX(new_period, LWB_CONF_SCHED_PERIOD_MIN);
+}
+/*---------------------------------------------------------------------------*/
+static inline uint8_t
+edf_prio(uint16_t pos)
+{
+  return LWB_SCHED_STREAM_AT(pos)->prio;
+}
+/*---------------------------------------------------------------------------*/
+static inline uint32_t
+edf_deadline(uint16_t pos)
+{
+  return LWB_SCHED_STREAM_AT(pos)->last_assigned +
+         LWB_SCHED_STREAM_AT(pos)->ipi;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief compare two streams (positions) by priority class and deadline; ties
+ * are broken by the node ID (rotated by a random offset each round) and the
+ * stream ID
+ * @return 1 if stream a has to be served before stream b
+ */
+static inline uint8_t
+edf_before(uint16_t a, uint16_t b)
+{
+  const lwb_stream_list_t* sa = LWB_SCHED_STREAM_AT(a);
+  const lwb_stream_list_t* sb = LWB_SCHED_STREAM_AT(b);
+  uint32_t da = edf_deadline(a);
+  uint32_t db = edf_deadline(b);
+  if(sa->prio != sb->prio) {
+    return sa->prio > sb->prio;
+  }
+  if(da != db) {
+    return da < db;
+  }
+  if(sa->node_id != sb->node_id) {
+    return (uint16_t)(sa->node_id - edf_rot) <
+           (uint16_t)(sb->node_id - edf_rot);
   }
-  return new_period;
+  return sa->stream_id < sb->stream_id;
+}
+/*---------------------------------------------------------------------------*/
+static void
+edf_sift_down(uint16_t i, uint16_t size)
+{
+  uint16_t top = edf_heap[i];
+  while(1) {
+    uint16_t child = 2 * i + 1;
+    if(child >= size) {
+      break;
+    }
+    if((child + 1 < size) && edf_before(edf_heap[child + 1], edf_heap[child])) {
+      child++;
+    }
+    if(!edf_before(edf_heap[child], top)) {
+      break;
+    }
+    edf_heap[i] = edf_heap[child];
+    i = child;
+  }
+  edf_heap[i] = top;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
 lwb_sched_compute(lwb_schedule_t* const in_out_sched,
-                  const uint8_t* const slot_streams,
                   uint8_t n_slots_host)
 {
-  static uint16_t slots_tmp[LWB_MAX_DATA_SLOTS + 1];
   uint16_t n_slots_assigned = 0;
   uint16_t i;
 
   /* reset values */
-  data_ipi = 1;
-  data_cnt = 0;
+  data_rate    = 0;
+  deadline_min = 0xffff;
+#if LWB_CONF_SCHED_BACKLOG_SLOTS
+  uint16_t last_node_id = 0, node_backlog = 0;
+  backlog_total = 0;
+#endif /* LWB_CONF_SCHED_BACKLOG_SLOTS */
 
   /* loop through all the streams in the list */
   lwb_stream_list_t *curr_stream = list_head(streams_list);
   while(curr_stream != NULL) {
-    /* check if the stream is in 'slot_streams' */
-    uint16_t list_len = GMW_SCHED_N_SLOTS(in_out_sched);
-    uint16_t idx = 0;
-    /* slow search, should be optimized */
-    while(idx < list_len) {
-      if(in_out_sched->slot[idx] == curr_stream->node_id &&
-         slot_streams[idx] == curr_stream->stream_id) {
-        curr_stream->n_cons_missed = 0;   /* reset */
-        break;
-      }
-      idx++;
+    /* has a packet of this stream been received? */
+    uint16_t pos = LWB_SCHED_STREAM_POS(curr_stream);
+    if(stream_rcvd[pos >> 3] & (1 << (pos & 7))) {
+      curr_stream->n_cons_missed = 0;     /* reset */
     }
     if(curr_stream->n_cons_missed & 0x80) {
       /* no packet received from this stream */
@@ -239,21 +456,41 @@ lwb_sched_compute(lwb_schedule_t* const in_out_sched,
       curr_stream = curr_stream->next;
       lwb_sched_del_stream(stream_to_remove);
     } else {
-      uint16_t curr_gcd = gcd(data_ipi, curr_stream->ipi);
-      uint16_t k1       = curr_stream->ipi / curr_gcd;
-      uint16_t k2       = data_ipi / curr_gcd;
-      data_cnt          = data_cnt * k1 + k2;
-      data_ipi          = data_ipi * k1;
+      data_rate  += curr_stream->rate;
+      if(curr_stream->deadline) {
+        deadline_min = MIN(deadline_min, curr_stream->deadline);
+      }
+#if LWB_CONF_SCHED_BACKLOG_SLOTS
+      /* the backlog is reported per node (the streams of a node are next to
+       * each other in the list) */
+      if(curr_stream->node_id != last_node_id) {
+        backlog_total += node_backlog;
+        node_backlog   = 0;
+        last_node_id   = curr_stream->node_id;
+      }
+      node_backlog = MAX(node_backlog, curr_stream->backlog);
+#endif /* LWB_CONF_SCHED_BACKLOG_SLOTS */
       curr_stream = curr_stream->next;
     }
   }
 
-  /* now we can clear content of the schedule */
+#if LWB_CONF_SCHED_BACKLOG_SLOTS
+  backlog_total += node_backlog;
+#endif /* LWB_CONF_SCHED_BACKLOG_SLOTS */
+
+  /* now we can clear content of the schedule and the received streams */
   memset(in_out_sched->slot, 0, sizeof(in_out_sched->slot));
+  memset(stream_rcvd, 0, sizeof(stream_rcvd));
   /* stream ACK slot? */
+#if LWB_CONF_MAX_CONT_SLOTS > 1
+  /* requests from several contention slots: one slot per S-ACK */
+  n_slots_host += n_pending_sack;
+  adapt_cont_slots();
+#else /* LWB_CONF_MAX_CONT_SLOTS */
   if(n_pending_sack) {
     n_slots_host++;
   }
+#endif /* LWB_CONF_MAX_CONT_SLOTS */
   /* assign slots to the host */
   n_slots_host = MIN(LWB_MAX_DATA_SLOTS, n_slots_host);
   i = n_slots_host;
@@ -266,70 +503,101 @@ lwb_sched_compute(lwb_schedule_t* const in_out_sched,
 
   /* assign slots to the source nodes */
   if(n_streams > 0) {
-    /* random initial position in the list */
-    uint16_t first_idx = 0;
-    uint16_t rand_init_pos = (random_rand() % n_streams);
-    curr_stream = list_head(streams_list);
-    for(i = 0; i < rand_init_pos; i++) {
-      curr_stream = curr_stream->next;
+    /* collect the streams with a due slot */
+    uint16_t heap_size = 0;
+    for(curr_stream = list_head(streams_list); curr_stream != NULL;
+        curr_stream = curr_stream->next) {
+      curr_stream->n_slots = 0;
+      if(time >= (curr_stream->ipi + curr_stream->last_assigned)) {
+        edf_heap[heap_size++] = LWB_SCHED_STREAM_POS(curr_stream);
+      }
     }
-    lwb_stream_list_t *first_stream = curr_stream;
-    do {
-      /* assign slots for this stream, if possible */
-      if((n_slots_assigned < LWB_MAX_DATA_SLOTS) && 
-        (time >= (curr_stream->ipi + curr_stream->last_assigned))) {
-        /* the number of slots to assign to curr_stream */
-        uint16_t to_assign = (time - curr_stream->last_assigned) /
-                             curr_stream->ipi;
-        if(saturated) {
-          if((curr_stream->next == first_stream) || 
-            (curr_stream->next == NULL && rand_init_pos == 0)) {
-            /* last random stream: assign all possible slots */
-          } else {
-            /* ensure fairness among source nodes when the bandwidth saturates
-            * assigned a number of slots proportional to (1/IPI) */
-            uint16_t slots_ipi = period / curr_stream->ipi;
-            if(to_assign > slots_ipi) {
-              to_assign = slots_ipi;
-              if(to_assign == 0 && curr_stream == first_stream) {
-                /* first random stream: assign one slot to it, even if it has 
-                * very long IPI */
-                to_assign = 1;
-              }
-            }
-          }
-        }
-        if(to_assign > (LWB_MAX_DATA_SLOTS - n_slots_assigned)) {
-          to_assign = LWB_MAX_DATA_SLOTS - n_slots_assigned;
+    edf_rot = random_rand();
+    for(i = heap_size / 2; i > 0; i--) {
+      edf_sift_down(i - 1, heap_size);
+    }
+    /* assign slots to the first stream (highest class, earliest deadline)
+     * until it is no longer the first (or no longer due) */
+    i = n_slots_assigned;
+    while(heap_size && (i < LWB_MAX_DATA_SLOTS)) {
+      uint32_t next_deadline = 0xffffffff;
+      /* a child of the same class may be served first */
+      if(heap_size > 1 && edf_prio(edf_heap[1]) == edf_prio(edf_heap[0])) {
+        next_deadline = edf_deadline(edf_heap[1]);
+      }
+      if(heap_size > 2 && edf_prio(edf_heap[2]) == edf_prio(edf_heap[0])) {
+        next_deadline = MIN(next_deadline, edf_deadline(edf_heap[2]));
+      }
+      curr_stream = LWB_SCHED_STREAM_AT(edf_heap[0]);
+      /* set the last bit, we are expecting a packet from this stream in the
+       * next round */
+      curr_stream->n_cons_missed |= 0x80;
+      lwb_class_stats_t* stats = &class_stats[curr_stream->prio];
+      do {
+        uint32_t latency = time - (curr_stream->ipi +
+                                   curr_stream->last_assigned);
+        stats->n_slots++;
+        stats->latency_sum += latency;
+        stats->latency_max  = MAX(stats->latency_max,
+                                  MIN(latency, 0xffff));
+        if(curr_stream->deadline && latency >= curr_stream->deadline) {
+          stats->n_deadline_missed++;
         }
-        curr_stream->last_assigned += to_assign * curr_stream->ipi;
-        while(to_assign > 0) {
-          slots_tmp[n_slots_assigned] = curr_stream->node_id;
-          to_assign--;
-          n_slots_assigned++;
+        curr_stream->n_slots++;
+        curr_stream->last_assigned += curr_stream->ipi;
+        i++;
+      } while((i < LWB_MAX_DATA_SLOTS) &&
+              ((curr_stream->ipi + curr_stream->last_assigned) <
+               next_deadline) &&
+              (time >= (curr_stream->ipi + curr_stream->last_assigned)));
+      if(time < (curr_stream->ipi + curr_stream->last_assigned)) {
+        /* no more slots due for this stream */
+        edf_heap[0] = edf_heap[--heap_size];
+      }
+      if(heap_size) {
+        edf_sift_down(0, heap_size);
+      }
+    }
+#if LWB_CONF_SCHED_BACKLOG_SLOTS
+    /* extra slots for the reported backlog, higher classes first */
+    uint16_t n_extra = MIN(LWB_CONF_SCHED_BACKLOG_SLOTS,
+                           LWB_MAX_DATA_SLOTS - i);
+    uint8_t  prio    = LWB_CONF_N_STREAM_CLASSES;
+    while(prio-- && n_extra) {
+      last_node_id = 0;
+      for(curr_stream = list_head(streams_list);
+          curr_stream != NULL && n_extra;
+          curr_stream = curr_stream->next) {
+        if(curr_stream->prio == prio && curr_stream->backlog &&
+           curr_stream->node_id != last_node_id) {
+          /* one grant per node, the slots serve the whole queue */
+          uint8_t k = MIN(curr_stream->backlog, n_extra);
+          curr_stream->n_slots += k;
+          n_extra              -= k;
+          last_node_id          = curr_stream->node_id;
         }
-        /* set the last bit, we are expecting a packet from this stream in the
-         * next round */
-        curr_stream->n_cons_missed |= 0x80; 
       }
-      /* go to the next stream in the list */
-      curr_stream = curr_stream->next;
-      if(curr_stream == NULL) {
-        /* end of the list: start again from the head of the list */
-        curr_stream = list_head(streams_list);
-        first_idx   = n_slots_assigned;
+    }
+#endif /* LWB_CONF_SCHED_BACKLOG_SLOTS */
+    /* write the slots in the order of the node IDs */
+    for(curr_stream = list_head(streams_list); curr_stream != NULL;
+        curr_stream = curr_stream->next) {
+      for(i = 0; i < curr_stream->n_slots; i++) {
+        in_out_sched->slot[n_slots_assigned++] = curr_stream->node_id;
       }
-    } while(curr_stream != first_stream);
-
-    /* copy into new data structure to keep the node IDs ordered */
-    memcpy(&in_out_sched->slot[n_slots_host], &slots_tmp[first_idx],
-           (n_slots_assigned - first_idx) * 2);
-    memcpy(&in_out_sched->slot[n_slots_assigned - first_idx + n_slots_host],
-           slots_tmp, first_idx * 2);
+      curr_stream->backlog = 0;
+    }
   }
 
-  /* add a contention slot at the end */
+  /* add the contention slot(s) at the end */
+#if LWB_CONF_MAX_CONT_SLOTS > 1
+  i = 0;
+  do {
+    in_out_sched->slot[n_slots_assigned++] = GMW_SLOT_CONTENTION;
+  } while(++i < n_cont_slots && n_slots_assigned < GMW_CONF_MAX_SLOTS);
+#else /* LWB_CONF_MAX_CONT_SLOTS */
   in_out_sched->slot[n_slots_assigned++] = GMW_SLOT_CONTENTION;
+#endif /* LWB_CONF_MAX_CONT_SLOTS */
   in_out_sched->n_slots = n_slots_assigned;
 
   /* this schedule is sent at the end of a round: do not communicate
@@ -343,11 +611,23 @@ lwb_sched_compute(lwb_schedule_t* const in_out_sched,
   return (n_slots_assigned * 2) + GMW_SCHED_SECTION_HEADER_LEN;
 }
 /*---------------------------------------------------------------------------*/
+const lwb_class_stats_t*
+lwb_sched_get_class_stats(uint8_t prio)
+{
+  if(prio >= LWB_CONF_N_STREAM_CLASSES) {
+    return 0;
+  }
+  return &class_stats[prio];
+}
+/*---------------------------------------------------------------------------*/
 uint16_t
 lwb_sched_init(lwb_schedule_t* const out_sched)
 {
   memb_init(&streams_memb);
   list_init(streams_list);
+  memset(stream_index, 0, sizeof(stream_index));
+  memset(stream_rcvd, 0, sizeof(stream_rcvd));
+  memset(class_stats, 0, sizeof(class_stats));
 
   n_streams          = 0;
   n_pending_sack     = 0;
@@ -364,48 +644,3 @@ lwb_sched_init(lwb_schedule_t* const out_sched)
   return GMW_SCHED_SECTION_HEADER_LEN + 2;    /* 2 bytes for contention slot */
 }
 /*---------------------------------------------------------------------------*/
-
-/**
- * @brief implementation of the binary GCD algorithm
- * @param[in] u an unsigned integer
- * @param[in] v an unsigned integer
- * @return the greatest common divider of u and v
- */
-static inline uint16_t
-gcd(uint16_t u, uint16_t v)
-{
-  uint16_t shift;
-
-  /* GCD(0,x) := x */
-  if(u == 0 || v == 0) {
-    return u | v;
-  }
-  /* Let shift := lg K, where K is the greatest power of 2
-     dividing both u and v. */
-  for(shift = 0; ((u | v) & 1) == 0; ++shift) {
-    u >>= 1;
-    v >>= 1;
-  }
-  while((u & 1) == 0) {
-    u >>= 1;
-  }
-  /* From here on, u is always odd. */
-  do {
-    while((v & 1) == 0) {  /* Loop X */
-      v >>= 1;
-    }
-    /* Now u and v are both odd, so diff(u, v) is even.
-       Let u = min(u, v), v = diff(u, v)/2. */
-    if(u < v) {
-      v -= u;
-    } else {
-      uint16_t diff = u - v;
-      u = v;
-      v = diff;
-    }
-    v >>= 1;
-  } while(v != 0);
-
-  return u << shift;
-}
-/*---------------------------------------------------------------------------*/
@@ -56,6 +56,8 @@ typedef struct {
   /* index in the stream list is the ID, no need to store the stream ID here */
   lwb_stream_state_t state : 8;    /* 1 byte only */
   uint16_t           ipi;          /* inter-packet interval */
+  uint8_t            prio;         /* priority class */
+  uint16_t           deadline;     /* max. latency in seconds */
 } lwb_stream_t;
 
 typedef enum lwb_host_round {
@@ -74,7 +76,6 @@ static gmw_control_t       control;
 
 /* --- variables for the HOST node --- */
 static gmw_protocol_impl_t host_impl;
-static uint8_t             slot_streams[LWB_MAX_DATA_SLOTS + 1];
 
 /* --- variables for the SOURCE node --- */
 static gmw_protocol_impl_t src_impl;
@@ -82,6 +83,14 @@ static lwb_stream_t        streams[LWB_CONF_MAX_N_STREAMS_PER_NODE];
 static lwb_sync_state_t    sync_state;
 static uint8_t             stream_request_pending;
 static uint8_t             rounds_to_wait;
+#if LWB_CONF_MAX_CONT_SLOTS > 1
+static uint8_t             cont_slot_idx;      /* in the current round */
+static uint8_t             cont_slot_sel;      /* selected for the request */
+static uint8_t             n_cont_slots = 1;   /* in the current round */
+#endif /* LWB_CONF_MAX_CONT_SLOTS */
+#if LWB_CONF_AGGREGATE
+static uint8_t             n_msgs_last_pkt;    /* messages in the last packet */
+#endif /* LWB_CONF_AGGREGATE */
 static uint16_t            previous_periods[2];
 static uint32_t            sync_time;
 static uint64_t            sync_timestamp;
@@ -114,17 +123,25 @@ static const gmw_sync_state_t gmw_superstate[NUM_OF_LWB_SYNC_STATES] =
 void    lwb_init(void);
 uint8_t output_queue_get(uint8_t* out_data);
 uint8_t input_queue_put(const uint8_t * const data, uint8_t len);
+void    input_queue_put_aggr(const lwb_pkt_t* pkt,
+                             uint8_t len,
+                             uint16_t sender_id);
 uint8_t stream_prepare_req(lwb_stream_req_t* const out_srq);
 uint8_t stream_update_state(uint16_t stream_id);
+#if GMW_CONF_USE_AUTO_GAP
+uint8_t timing_report_append(lwb_pkt_t* pkt, uint8_t len);
+uint8_t timing_report_remove(lwb_pkt_t* pkt, uint8_t len);
+#endif /* GMW_CONF_USE_AUTO_GAP */
 /*---------------------------------------------------------------------------*/
 /*---------------------------- main interface -------------------------------*/
 /*---------------------------------------------------------------------------*/
 void
 lwb_start(struct process* pre_lwb_proc, struct process *post_lwb_proc)
 {
-  /* pass the start addresses of the memory blocks holding the queues */
-  fifo16_init(&input_queue, (uint16_t)input_queue_buffer);
-  fifo16_init(&output_queue, (uint16_t)output_queue_buffer);
+  /* the FIFOs manage offsets into the memory blocks holding the queues
+   * (pointers may be wider than 16 bits) */
+  fifo16_init(&input_queue, 0);
+  fifo16_init(&output_queue, 0);
 
   pre_proc  = pre_lwb_proc;
   post_proc = post_lwb_proc;
@@ -149,9 +166,12 @@ lwb_send_pkt(uint16_t recipient,
   }
   uint16_t addr = fifo16_put(&output_queue);
   if(FIFO16_ERROR != addr) {
-    lwb_queue_elem_t* elem         = (lwb_queue_elem_t*)addr;
+    lwb_queue_elem_t* elem         =
+                           (lwb_queue_elem_t*)&output_queue_buffer[addr];
     elem->data.header.recipient_id = recipient;
     elem->data.header.type         = LWB_PACKET_TYPE_DATA;
+    elem->data.header.report       = 0;
+    elem->data.header.backlog      = 0;
     elem->data.header.stream_id    = stream_id;
     elem->len                      = len + sizeof(lwb_header_t);
     memcpy(elem->data.payload, data, len);
@@ -173,8 +193,7 @@ lwb_rcv_pkt(uint8_t* out_data,
    * LWB_MAX_PAYLOAD_LEN */
   uint16_t addr = fifo16_get(&input_queue);
   if(FIFO16_ERROR != addr) {
-    /* assume pointers are 16-bit */
-    lwb_queue_elem_t* elem = (lwb_queue_elem_t*)addr;
+    lwb_queue_elem_t* elem = (lwb_queue_elem_t*)&input_queue_buffer[addr];
     /* make sure the message length doesn't exceed the buffer limits */
     if(elem->len > LWB_MAX_DATA_PKT_LEN) {
       elem->len = LWB_MAX_DATA_PKT_LEN;     /* truncate */
@@ -235,7 +254,7 @@ host_on_control_slot_post(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-host_on_slot_pre(uint8_t slot_index,
+host_on_slot_pre(uint16_t slot_index,
                  uint16_t slot_assignee,
                  uint8_t* out_len,
                  uint8_t* out_payload,
@@ -260,7 +279,7 @@ host_on_slot_pre(uint8_t slot_index,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-host_on_slot_post(uint8_t slot_index,
+host_on_slot_post(uint16_t slot_index,
                   uint16_t slot_assignee,
                   uint8_t len,
                   uint8_t* payload,
@@ -268,9 +287,15 @@ host_on_slot_post(uint8_t slot_index,
                   uint8_t is_contention_slot,
                   gmw_pkt_event_t event)
 {
+  if(is_contention_slot) {
+    lwb_sched_process_cont_slot(event);
+  }
   if(!is_initiator && (len >= sizeof(lwb_header_t))) {
     /* not initiator and we have received some data */
     lwb_pkt_t* pkt = (lwb_pkt_t*)payload;
+  #if GMW_CONF_USE_AUTO_GAP
+    len = timing_report_remove(pkt, len);
+  #endif /* GMW_CONF_USE_AUTO_GAP */
     /* filter packet based on recipient ID */
     if(pkt->header.recipient_id == node_id ||
        pkt->header.recipient_id == LWB_RECIPIENT_SINK ||
@@ -282,12 +307,17 @@ host_on_slot_post(uint8_t slot_index,
 
       } else if(pkt->header.type == LWB_PACKET_TYPE_DATA) {
         /* normal data packet */
-        slot_streams[slot_index] = pkt->header.stream_id;
+        lwb_sched_process_data(slot_assignee, pkt->header.stream_id,
+                               pkt->header.backlog);
         /* replace recipient node ID by sender node ID */
         pkt->data.header.recipient_id = slot_assignee;
         input_queue_put(pkt->raw, len);
         DEBUG_PRINT_VERBOSE("data received (s=%u.%u l=%u)", slot_assignee,
                             pkt->data.header.stream_id, len);
+
+      } else if(pkt->header.type == LWB_PACKET_TYPE_DATA_AGGR) {
+        /* several data packets */
+        input_queue_put_aggr(pkt, len, slot_assignee);
       }
     } // else: ignore packet
   }
@@ -300,7 +330,7 @@ host_on_round_finished(gmw_pre_post_processes_t* in_out_pre_post_proc)
   if(LWB_ROUND_TYPE_MAIN == current_round_type) {
     /* next round will be schedule only */
     /* calculate the new schedule based on the registered streams */
-    lwb_sched_compute(&control.schedule, slot_streams, output_queue.count);
+    lwb_sched_compute(&control.schedule, output_queue.count);
     /* adjust the period */
     control.schedule.period -= LWB_CONF_SCHED2_OFFSET;
     GMW_LWB_SET_SECOND_CONTROL(&control);            /* mark as 2nd schedule */
@@ -334,8 +364,9 @@ src_on_control_slot_post(gmw_control_t* in_out_control,
   /* default case */
   lwb_sync_event_t lwb_sync_event = EVT_SCHED_LWB_SYNC_STATE_MISSED;
   gmw_sync_state_t gmw_sync_state;
-  if(GMW_EVT_CONTROL_RCVD == event) {
-    /* control packet received! */
+  if(GMW_EVT_CONTROL_RCVD == event || GMW_EVT_CONTROL_PARTIAL == event) {
+    /* control packet received! (the time and period are valid even if the
+     * delta-encoded slot list could not be applied) */
     /* toggle round type */
     if(GMW_LWB_IS_FIRST_CONTROL(in_out_control)) {
       current_round_type = LWB_ROUND_TYPE_MAIN;
@@ -343,6 +374,21 @@ src_on_control_slot_post(gmw_control_t* in_out_control,
       /* store the synchronization point */
       sync_time          = in_out_control->schedule.time;
       sync_timestamp     = GMW_GET_T_REF();
+  #if LWB_CONF_MAX_CONT_SLOTS > 1
+      {
+        /* randomly select one of the contention slots of this round */
+        uint16_t i;
+        n_cont_slots = 0;
+        for(i = 0; i < GMW_SCHED_N_SLOTS(&in_out_control->schedule); i++) {
+          if(GMW_SLOT_CONTENTION == in_out_control->schedule.slot[i]) {
+            n_cont_slots++;
+          }
+        }
+        n_cont_slots  = MAX(n_cont_slots, 1);
+        cont_slot_idx = 0;
+        cont_slot_sel = (random_rand() >> 1) % n_cont_slots;
+      }
+  #endif /* LWB_CONF_MAX_CONT_SLOTS */
     } else {
       current_round_type = LWB_ROUND_TYPE_SCHED_ONLY;
       lwb_sync_event     = LWB_EVENT_RCVD_2ND_SCHED;
@@ -370,7 +416,7 @@ src_on_control_slot_post(gmw_control_t* in_out_control,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_skip_event_t
-src_on_slot_pre(uint8_t slot_index,
+src_on_slot_pre(uint16_t slot_index,
                 uint16_t slot_assignee,
                 uint8_t* out_len,
                 uint8_t* out_payload,
@@ -385,15 +431,43 @@ src_on_slot_pre(uint8_t slot_index,
       DEBUG_PRINT_WARNING("no data to send, slot skipped");
       return GMW_EVT_SKIP_SLOT;
     }
+    /* let the host know how many packets are still waiting */
+  #if LWB_CONF_AGGREGATE
+    /* the packet was only closed because the next message did not fit (or
+     * has another recipient): it holds as many messages as fit per packet */
+    uint16_t backlog = (output_queue.count + n_msgs_last_pkt - 1) /
+                       n_msgs_last_pkt;
+  #else /* LWB_CONF_AGGREGATE */
+    uint16_t backlog = output_queue.count;
+  #endif /* LWB_CONF_AGGREGATE */
+    lwb_pkt->header.backlog = MIN(backlog, LWB_BACKLOG_MAX);
+  #if GMW_CONF_USE_AUTO_GAP
+    *out_len = timing_report_append(lwb_pkt, *out_len);
+  #endif /* GMW_CONF_USE_AUTO_GAP */
   } else if(is_contention_slot) {
     /* contention slot */
+  #if LWB_CONF_MAX_CONT_SLOTS > 1
+    if(cont_slot_idx++ != cont_slot_sel) {
+      /* at most one request per round, in the selected slot */
+      return GMW_EVT_SKIP_DEFAULT;
+    }
+  #endif /* LWB_CONF_MAX_CONT_SLOTS */
     if(stream_request_pending) {
       /* allowed to send the request? */
       if(rounds_to_wait == 0) {
         /* send the stream request */
         *out_len = stream_prepare_req(&lwb_pkt->srq);
         if(*out_len) {
-  #if LWB_CONF_CONT_BACKOFF
+  #if GMW_CONF_USE_AUTO_GAP
+          /* a source without a stream has no other way to report */
+          *out_len = timing_report_append(lwb_pkt, *out_len);
+  #endif /* GMW_CONF_USE_AUTO_GAP */
+  #if LWB_CONF_CONT_BACKOFF && LWB_CONF_MAX_CONT_SLOTS > 1
+          /* the host opens more contention slots if there are collisions:
+           * shrink the backoff window accordingly */
+          rounds_to_wait = (random_rand() >> 1) %
+                           MAX(LWB_CONF_CONT_BACKOFF / n_cont_slots, 1) + 1;
+  #elif LWB_CONF_CONT_BACKOFF
           /* wait between 1 and LWB_CONF_CONT_BACKOFF rounds */
           rounds_to_wait = (random_rand() >> 1) %
                            LWB_CONF_CONT_BACKOFF + 1;
@@ -412,7 +486,7 @@ src_on_slot_pre(uint8_t slot_index,
 }
 /*---------------------------------------------------------------------------*/
 static gmw_repeat_event_t
-src_on_slot_post(uint8_t slot_index,
+src_on_slot_post(uint16_t slot_index,
                  uint16_t slot_assignee,
                  uint8_t len,
                  uint8_t* payload,
@@ -423,6 +497,9 @@ src_on_slot_post(uint8_t slot_index,
   lwb_pkt_t* lwb_pkt = (lwb_pkt_t*)payload;
 
   if(!is_initiator && (len >= sizeof(lwb_header_t))) {
+  #if GMW_CONF_USE_AUTO_GAP
+    len = timing_report_remove(lwb_pkt, len);
+  #endif /* GMW_CONF_USE_AUTO_GAP */
     /* filter packet by recipient ID */
     if(lwb_pkt->header.recipient_id == node_id ||
        lwb_pkt->header.recipient_id == LWB_RECIPIENT_BROADCAST) {
@@ -432,6 +509,9 @@ src_on_slot_post(uint8_t slot_index,
         lwb_pkt->header.recipient_id = slot_assignee;
         input_queue_put(lwb_pkt->raw, len);
 
+      } else if(LWB_PACKET_TYPE_DATA_AGGR == lwb_pkt->header.type) {
+        input_queue_put_aggr(lwb_pkt, len, slot_assignee);
+
       } else if(LWB_PACKET_TYPE_ACK == lwb_pkt->header.type) {
         /* acknowledgement for stream request received */
         stream_update_state(lwb_pkt->sack.stream_id);
@@ -468,11 +548,67 @@ src_on_bootstrap_timeout(void)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+#if GMW_CONF_MAX_ROUND_PRE_SLOTS
+/**
+ * @brief prepare the payloads of all own slots of the round at once, with the
+ * same logic as the per-slot callback slot_pre
+ * @note contention slots are left to on_slot_pre: whether a stream request
+ * is still pending is only known after the S-ACK slot
+ */
+static uint8_t
+prepare_round(const gmw_control_t* control,
+              gmw_slot_payload_t* out_payloads,
+              uint8_t max_payloads,
+              gmw_on_slot_pre_callback slot_pre)
+{
+  uint8_t  cnt = 0;
+  uint16_t i;
+  for(i = 0; (i < GMW_SCHED_N_SLOTS(&control->schedule)) &&
+             (cnt < max_payloads); i++) {
+    if(control->schedule.slot[i] != node_id) {
+      continue;
+    }
+    out_payloads[cnt].slot_index = i;
+    out_payloads[cnt].len        = 0;
+    if(slot_pre(i, node_id, &out_payloads[cnt].len, out_payloads[cnt].payload,
+                1, 0) == GMW_EVT_SKIP_DEFAULT && out_payloads[cnt].len) {
+      cnt++;
+    }
+  }
+  return cnt;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+host_on_round_pre(const gmw_control_t* control,
+                  gmw_slot_payload_t* out_payloads,
+                  uint8_t max_payloads)
+{
+  return prepare_round(control, out_payloads, max_payloads, &host_on_slot_pre);
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+src_on_round_pre(const gmw_control_t* control,
+                 gmw_slot_payload_t* out_payloads,
+                 uint8_t max_payloads)
+{
+  return prepare_round(control, out_payloads, max_payloads, &src_on_slot_pre);
+}
+#endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
+/*---------------------------------------------------------------------------*/
 /*---------------------------- stream handling ------------------------------*/
 /*---------------------------------------------------------------------------*/
 uint8_t
 lwb_stream_request(uint16_t ipi)
 {
+  return lwb_stream_request_class(ipi, 0, 0);
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+lwb_stream_request_class(uint16_t ipi, uint8_t prio, uint16_t deadline)
+{
+  if(prio >= LWB_CONF_N_STREAM_CLASSES) {
+    return LWB_INVALID_STREAM_ID;
+  }
   uint16_t idx;
   /* look for an empty spot in the list */
   for(idx = 0; idx < LWB_CONF_MAX_N_STREAMS_PER_NODE; idx++) {
@@ -482,11 +618,13 @@ lwb_stream_request(uint16_t ipi)
   }
   /* add the new stream */
   if(idx < LWB_CONF_MAX_N_STREAMS_PER_NODE) {
-    streams[idx].ipi   = ipi;
-    streams[idx].state = LWB_STREAM_STATE_PENDING;
+    streams[idx].ipi      = ipi;
+    streams[idx].prio     = prio;
+    streams[idx].deadline = deadline;
+    streams[idx].state    = LWB_STREAM_STATE_PENDING;
     stream_request_pending++;
-    DEBUG_PRINT_INFO("stream %u added (IPI: %u)", 
-                     idx, streams[idx].ipi);
+    DEBUG_PRINT_INFO("stream %u added (IPI: %u, class: %u)", 
+                     idx, streams[idx].ipi, prio);
     return idx;     /* return the new stream ID (= index in the stream list) */
   }
   return LWB_INVALID_STREAM_ID;
@@ -542,9 +680,13 @@ stream_prepare_req(lwb_stream_req_t* const out_srq)
     /* compose the packet */
     out_srq->header.recipient_id = LWB_RECIPIENT_SINK;
     out_srq->header.type         = LWB_PACKET_TYPE_REQ;
+    out_srq->header.report       = 0;
+    out_srq->header.backlog      = 0;
     out_srq->header.stream_id    = idx;
     out_srq->sender_id           = node_id;
     out_srq->ipi                 = streams[idx].ipi;
+    out_srq->prio                = streams[idx].prio;
+    out_srq->deadline            = streams[idx].deadline;
     return sizeof(lwb_stream_req_t);  /* success */
   }
   return 0;   /* no stream request to send */
@@ -560,6 +702,15 @@ lwb_stream_get_state(uint8_t stream_id)
   return LWB_STREAM_STATE_INVALID;
 }
 /*---------------------------------------------------------------------------*/
+const lwb_class_stats_t*
+lwb_get_class_stats(uint8_t prio)
+{
+  if(node_id != HOST_ID) {
+    return 0;
+  }
+  return lwb_sched_get_class_stats(prio);
+}
+/*---------------------------------------------------------------------------*/
 /*-------------------------- helper functions -------------------------------*/
 /*---------------------------------------------------------------------------*/
 uint8_t
@@ -574,7 +725,7 @@ input_queue_put(const uint8_t* const data, uint8_t len)
   }
   uint16_t addr = fifo16_put(&input_queue);
   if(FIFO16_ERROR != addr) {
-    lwb_queue_elem_t* elem = (lwb_queue_elem_t*)addr;
+    lwb_queue_elem_t* elem = (lwb_queue_elem_t*)&input_queue_buffer[addr];
     memcpy(&elem->data, data, len);    /* includes LWB header */
     elem->len = len;
     return 1;
@@ -583,6 +734,67 @@ input_queue_put(const uint8_t* const data, uint8_t len)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+/* unpack an aggregated data packet, each message is put into the input queue
+ * as a normal data packet */
+void
+input_queue_put_aggr(const lwb_pkt_t* pkt, uint8_t len, uint16_t sender_id)
+{
+  lwb_data_t msg;
+  uint8_t    pos = LWB_HEADER_LEN;
+
+  msg.header.recipient_id = sender_id;   /* as for a normal data packet */
+  msg.header.type         = LWB_PACKET_TYPE_DATA;
+  msg.header.report       = 0;
+  msg.header.backlog      = 0;
+  while((pos + LWB_AGGR_HEADER_LEN) <= len) {
+    const lwb_aggr_header_t* sub = (const lwb_aggr_header_t*)&pkt->raw[pos];
+    pos += LWB_AGGR_HEADER_LEN;
+    if(!sub->len || (pos + sub->len) > len) {
+      DEBUG_PRINT_WARNING("invalid aggregated data packet");
+      return;
+    }
+    if(node_id == HOST_ID) {
+      lwb_sched_process_data(sender_id, sub->stream_id, pkt->header.backlog);
+    }
+    msg.header.stream_id = sub->stream_id;
+    memcpy(msg.payload, &pkt->raw[pos], sub->len);
+    input_queue_put((uint8_t*)&msg, sub->len + LWB_HEADER_LEN);
+    pos += sub->len;
+  }
+  DEBUG_PRINT_VERBOSE("aggregated data received (s=%u l=%u)", sender_id, len);
+}
+/*---------------------------------------------------------------------------*/
+#if GMW_CONF_USE_AUTO_GAP
+/* piggyback the timing report of this source on an outgoing packet (if one
+ * is due), returns the new length */
+uint8_t
+timing_report_append(lwb_pkt_t* pkt, uint8_t len)
+{
+  if((len + GMW_TIMING_REPORT_LEN) <= LWB_MAX_DATA_PKT_LEN &&
+     gmw_get_timing_report((gmw_timing_report_t*)&pkt->raw[len])) {
+    pkt->header.report = 1;
+    len += GMW_TIMING_REPORT_LEN;
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+/* strip the timing report from a received packet (the host passes it on to
+ * the gap calibration), returns the remaining length */
+uint8_t
+timing_report_remove(lwb_pkt_t* pkt, uint8_t len)
+{
+  if(pkt->header.report &&
+     len >= (LWB_HEADER_LEN + GMW_TIMING_REPORT_LEN)) {
+    len -= GMW_TIMING_REPORT_LEN;
+    if(node_id == HOST_ID) {
+      gmw_report_src_timing((const gmw_timing_report_t*)&pkt->raw[len]);
+    }
+    pkt->header.report = 0;
+  }
+  return len;
+}
+#endif /* GMW_CONF_USE_AUTO_GAP */
+/*---------------------------------------------------------------------------*/
 /* fetch the next 'ready-to-send' message from the outgoing queue
  * returns the message length in bytes */
 uint8_t
@@ -592,14 +804,55 @@ output_queue_get(uint8_t* const out_data)
    * formatted according to glossy_payload_t */
   uint16_t addr = fifo16_get(&output_queue);
   if(FIFO16_ERROR != addr) {
-    lwb_queue_elem_t* elem = (lwb_queue_elem_t*)addr;
+    lwb_queue_elem_t* elem = (lwb_queue_elem_t*)&output_queue_buffer[addr];
     /* check the length */
     if(elem->len > LWB_MAX_DATA_PKT_LEN || elem->len == 0) {
       DEBUG_PRINT_WARNING("invalid message length detected");
       return 0;
     }
     memcpy(out_data, &elem->data, elem->len);
+#if LWB_CONF_AGGREGATE
+    /* append the following messages to the same recipient as long as they
+     * fit into the packet */
+    lwb_pkt_t*         pkt = (lwb_pkt_t*)out_data;
+    lwb_aggr_header_t* sub;
+    uint8_t            len = elem->len;
+    n_msgs_last_pkt = 1;
+    while(!FIFO16_EMPTY(&output_queue)) {
+      elem = (lwb_queue_elem_t*)
+             &output_queue_buffer[FIFO16_READ_ADDR(&output_queue)];
+      uint8_t pkt_len = len + LWB_AGGR_HEADER_LEN + elem->len - LWB_HEADER_LEN;
+      if(pkt->header.type == LWB_PACKET_TYPE_DATA) {
+        pkt_len += LWB_AGGR_HEADER_LEN;   /* sub-header of the 1st message */
+      }
+      if(elem->data.header.recipient_id != pkt->header.recipient_id ||
+         elem->len <= LWB_HEADER_LEN ||
+         pkt_len > (LWB_MAX_DATA_PKT_LEN - LWB_REPORT_LEN)) {
+        break;
+      }
+      if(pkt->header.type == LWB_PACKET_TYPE_DATA) {
+        /* convert into an aggregated packet */
+        memmove(&pkt->raw[LWB_HEADER_LEN + LWB_AGGR_HEADER_LEN],
+                &pkt->raw[LWB_HEADER_LEN], len - LWB_HEADER_LEN);
+        sub = (lwb_aggr_header_t*)&pkt->raw[LWB_HEADER_LEN];
+        sub->stream_id   = pkt->header.stream_id;
+        sub->len         = len - LWB_HEADER_LEN;
+        pkt->header.type = LWB_PACKET_TYPE_DATA_AGGR;
+        len += LWB_AGGR_HEADER_LEN;
+      }
+      sub = (lwb_aggr_header_t*)&pkt->raw[len];
+      sub->stream_id = elem->data.header.stream_id;
+      sub->len       = elem->len - LWB_HEADER_LEN;
+      memcpy(&pkt->raw[len + LWB_AGGR_HEADER_LEN], elem->data.payload,
+             elem->len - LWB_HEADER_LEN);
+      len = pkt_len;
+      n_msgs_last_pkt++;
+      fifo16_get(&output_queue);
+    }
+    return len;
+#else /* LWB_CONF_AGGREGATE */
     return elem->len;   /* success */
+#endif /* LWB_CONF_AGGREGATE */
   }
   return 0;  /* queue empty */
 }
@@ -612,7 +865,12 @@ lwb_init(void)
   if(node_id == HOST_ID) {
     /* HOST */
     host_impl.on_control_slot_post = &host_on_control_slot_post;
+  #if GMW_CONF_MAX_ROUND_PRE_SLOTS
+    /* payloads are prepared right after the control slot */
+    host_impl.on_round_pre         = &host_on_round_pre;
+  #else /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
     host_impl.on_slot_pre          = &host_on_slot_pre;
+  #endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
     host_impl.on_slot_post         = &host_on_slot_post;
     host_impl.on_round_finished    = &host_on_round_finished;
     gmw_control_init(&control);
@@ -626,7 +884,10 @@ lwb_init(void)
   } else {
     /* SOURCE */
     src_impl.on_control_slot_post = &src_on_control_slot_post;
-    src_impl.on_slot_pre          = &src_on_slot_pre;
+    src_impl.on_slot_pre          = &src_on_slot_pre; /* contention slots */
+  #if GMW_CONF_MAX_ROUND_PRE_SLOTS
+    src_impl.on_round_pre         = &src_on_round_pre;
+  #endif /* GMW_CONF_MAX_ROUND_PRE_SLOTS */
     src_impl.on_slot_post         = &src_on_slot_post;
     src_impl.on_round_finished    = &src_on_round_finished;
     src_impl.on_bootstrap_timeout = &src_on_bootstrap_timeout;
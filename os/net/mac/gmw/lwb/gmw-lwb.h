@@ -70,6 +70,49 @@
 #define LWB_CONF_CONT_BACKOFF           8
 #endif /* LWB_CONF_CONT_BACKOFF */
 
+/* max. number of contention slots per round; if > 1, the host opens more
+ * contention slots when it detects collisions (corrupted floods or garbage
+ * in a contention slot) or all of them carried a request, and fewer when
+ * they stay unused (the additional contention slots only use slots not
+ * needed for data); the sources send their request in a randomly selected
+ * contention slot and divide the backoff window by the number of slots */
+#ifndef LWB_CONF_MAX_CONT_SLOTS
+#define LWB_CONF_MAX_CONT_SLOTS         1
+#endif /* LWB_CONF_MAX_CONT_SLOTS */
+
+#if !LWB_CONF_MAX_CONT_SLOTS || LWB_CONF_MAX_CONT_SLOTS > 255
+#error "invalid LWB_CONF_MAX_CONT_SLOTS (range 1..255)"
+#endif
+
+/* number of stream priority classes (0 = lowest, the default); the host
+ * assigns the due slots of the higher classes first and keeps latency
+ * statistics per class */
+#ifndef LWB_CONF_N_STREAM_CLASSES
+#define LWB_CONF_N_STREAM_CLASSES       2
+#endif /* LWB_CONF_N_STREAM_CLASSES */
+
+#if !LWB_CONF_N_STREAM_CLASSES || LWB_CONF_N_STREAM_CLASSES > 255
+#error "invalid LWB_CONF_N_STREAM_CLASSES (range 1..255)"
+#endif
+
+/* max. number of extra data slots per round the host grants to sources that
+ * report a backlog (the number of packets left in their output queue is
+ * piggybacked on each packet); the next round is moved forward by the time
+ * the extra slots would otherwise take from the regular ones, a larger
+ * backlog is served over several rounds (0 = ignore the backlog reports) */
+#ifndef LWB_CONF_SCHED_BACKLOG_SLOTS
+#define LWB_CONF_SCHED_BACKLOG_SLOTS    0
+#endif /* LWB_CONF_SCHED_BACKLOG_SLOTS */
+
+/* pack several queued messages to the same recipient into one data packet
+ * (LWB_PACKET_TYPE_DATA_AGGR); each message then has a 2-byte sub-header
+ * (stream ID and length) instead of the LWB header; the receivers always
+ * accept aggregated packets, but nodes with an older firmware drop them
+ * (disabled by default, the on-air format of the data packets changes) */
+#ifndef LWB_CONF_AGGREGATE
+#define LWB_CONF_AGGREGATE              0
+#endif /* LWB_CONF_AGGREGATE */
+
 #if GMW_CONF_CONTROL_USER_BYTES != 1
 #error "GMW_CONF_CONTROL_USER_BYTES must be set to 1"
 #endif /* GMW_CONF_CONTROL_USER_BYTES */
@@ -105,7 +148,8 @@
 
 #ifndef LWB_CONF_SCHED_MAX_PENDING_SACK
 /* the max. number of pending stream ACKs (buffer size on HOST) */
-#define LWB_CONF_SCHED_MAX_PENDING_SACK     4
+#define LWB_CONF_SCHED_MAX_PENDING_SACK     (LWB_CONF_MAX_CONT_SLOTS > 4 ? \
+                                             LWB_CONF_MAX_CONT_SLOTS : 4)
 #endif /* LWB_CONF_SCHED_MAX_PENDING_SACK */
 
 #if LWB_CONF_SCHED2_OFFSET >= LWB_CONF_SCHED_PERIOD_MIN
@@ -122,9 +166,17 @@
 
 /* use GMW_CONF_... defines to set the max. packet length! */
 #define LWB_MAX_PAYLOAD_LEN         (GMW_CONF_MAX_DATA_PKT_LEN - \
-                                     LWB_HEADER_LEN)
+                                     LWB_HEADER_LEN - LWB_REPORT_LEN)
 #define LWB_MAX_DATA_PKT_LEN        GMW_CONF_MAX_DATA_PKT_LEN
 #define LWB_HEADER_LEN              4
+#if GMW_CONF_USE_AUTO_GAP
+/* space reserved in each data packet for the timing report of the source */
+#define LWB_REPORT_LEN              GMW_TIMING_REPORT_LEN
+#else /* GMW_CONF_USE_AUTO_GAP */
+#define LWB_REPORT_LEN              0
+#endif /* GMW_CONF_USE_AUTO_GAP */
+#define LWB_AGGR_HEADER_LEN         2
+#define LWB_BACKLOG_MAX             15      /* saturation value of backlog */
 
 #define GMW_LWB_CONTROL_MASK          (0x80)
 #define GMW_LWB_SET_FIRST_CONTROL(c)  ((c)->user_bytes[0] |= GMW_LWB_CONTROL_MASK)
@@ -162,6 +214,7 @@ typedef enum {
   LWB_PACKET_TYPE_DATA = 0,
   LWB_PACKET_TYPE_REQ,
   LWB_PACKET_TYPE_ACK,
+  LWB_PACKET_TYPE_DATA_AGGR,    /* several messages, see lwb_aggr_header_t */
 } lwb_packet_type_t;
 
 typedef enum {
@@ -173,7 +226,9 @@ typedef enum {
 
 typedef struct __attribute__((packed)) lwb_header {
   uint16_t          recipient_id;
-  lwb_packet_type_t type : 8;   /* 1 byte only */
+  lwb_packet_type_t type : 3;
+  uint8_t           report : 1;   /* timing report appended (sources) */
+  uint8_t           backlog : 4;  /* # packets left in the sender's queue */
   uint8_t           stream_id;
 } lwb_header_t;
 
@@ -182,11 +237,19 @@ typedef struct __attribute__((packed)) {
   uint8_t      payload[LWB_MAX_PAYLOAD_LEN];
 } lwb_data_t;
 
+/* sub-header of each message in an aggregated data packet */
+typedef struct __attribute__((packed)) {
+  uint8_t      stream_id;
+  uint8_t      len;       /* payload length */
+} lwb_aggr_header_t;
+
 typedef struct __attribute__((packed)) lwb_stream_req {
   lwb_header_t header;
   uint16_t     sender_id;
   uint16_t     ipi;
   int16_t      offset;    /* optional offset parameter */
+  uint8_t      prio;      /* priority class */
+  uint16_t     deadline;  /* max. latency in seconds (0 = none) */
 } lwb_stream_req_t;
 
 typedef lwb_header_t lwb_stream_ack_t;    /* same data structure */
@@ -204,6 +267,18 @@ typedef struct __attribute__((packed)) lwb_pkt {
 
 typedef gmw_schedule_t lwb_schedule_t;
 
+/**
+ * @brief per priority class statistics of the host scheduler; the latency is
+ * the time from the moment a slot of a stream is due (last assignment + IPI)
+ * until the round that contains the slot
+ */
+typedef struct {
+  uint32_t n_slots;           /* # assigned data slots */
+  uint32_t latency_sum;       /* sum of the latencies in seconds */
+  uint16_t latency_max;       /* max. latency in seconds */
+  uint16_t n_deadline_missed; /* # slots with latency >= stream deadline */
+} lwb_class_stats_t;
+
 /*----------------------------- main interface ------------------------------*/
 
 /**
@@ -267,6 +342,19 @@ uint8_t lwb_send_buffer_state(void);
  */
 uint8_t lwb_stream_request(uint16_t ipi);
 
+/**
+ * @brief schedules a stream request with a priority class and a deadline
+ * @param ipi inter-packet interval in seconds
+ * @param prio priority class (0 .. LWB_CONF_N_STREAM_CLASSES - 1, higher
+ * classes are served first if the network is saturated)
+ * @param deadline max. time in seconds a packet may wait for its slot (the
+ * host keeps the round period below the tightest deadline), 0 = none
+ * @return the ID of the new stream if successful, LWB_INVALID_STREAM_ID
+ * otherwise (stream list full)
+ */
+uint8_t lwb_stream_request_class(uint16_t ipi, uint8_t prio,
+                                 uint16_t deadline);
+
 /**
  * @brief removes a stream from the list
  * @param stream_id ID of the stream
@@ -293,16 +381,26 @@ lwb_sync_state_t lwb_get_sync_state(void);
  */
 uint32_t lwb_get_time(rtimer_ext_clock_t* const out_timestamp);
 
+/**
+ * @brief get the scheduler statistics of a priority class (host only)
+ * @param prio priority class
+ * @return the statistics or 0 if the class does not exist
+ */
+const lwb_class_stats_t* lwb_get_class_stats(uint8_t prio);
+
 
 /*-------------------------- scheduler interface ----------------------------*/
 /* do not call these functions directly */
 
 uint16_t lwb_sched_init(lwb_schedule_t* const out_sched);
 uint16_t lwb_sched_compute(gmw_schedule_t* const in_out_sched,
-                           const uint8_t* const slot_streams,
                            uint8_t n_slots_host);
 uint8_t  lwb_sched_prepare_sack(lwb_stream_ack_t* const out_sack);
 void     lwb_sched_process_stream_req(const lwb_stream_req_t* req);
+void     lwb_sched_process_data(uint16_t node_id, uint8_t stream_id,
+                                uint8_t backlog);
+void     lwb_sched_process_cont_slot(gmw_pkt_event_t event);
+const lwb_class_stats_t* lwb_sched_get_class_stats(uint8_t prio);
 
 
 #endif /* GMW_LWB_H_ */
@@ -46,6 +46,9 @@
  * period such that the bandwidth demands in the network are still met.
  * Besides, the scheduler keeps the period changes to a minimum
  * to reduce chances of a link loss and thus increase stability.
+ * The aggregate rate of the streams is accumulated in fixed point and the
+ * data slots are assigned earliest deadline first (deadline: last_assigned +
+ * IPI), i.e. a saturated network is shared in proportion to 1 / IPI.
  * 
  * @remarks:
  * - TIME_SCALE removed (i.e. fixed to 1)
@@ -94,9 +97,21 @@ typedef struct stream_info {
   uint16_t id;
   uint16_t ipi;
   uint32_t last_assigned;
+  uint32_t rate;                           /* LWB_SCHED_RATE(ipi) */
   uint8_t  stream_id;
   uint8_t  n_cons_missed;
+  uint8_t  n_slots;                        /* # slots in the current round */
 } lwb_stream_list_t;
+/* position of a stream in the stream memory block */
+#define LWB_SCHED_STREAM_POS(s) \
+  ((uint16_t)((s) - (lwb_stream_list_t*)streams_memb.mem))
+#define LWB_SCHED_STREAM_AT(p)  (&((lwb_stream_list_t*)streams_memb.mem)[p])
+/* a rate of 1 packet per time unit in the fixed point rate accumulator (the
+ * rate of a single stream fits into 32 bits) */
+#define LWB_SCHED_RATE_ONE      ((uint32_t)1 << 31)
+/* rate of a stream, 1 / IPI rounded up (the period never exceeds the optimal
+ * period), only computed when the IPI changes */
+#define LWB_SCHED_RATE(ipi)     ((LWB_SCHED_RATE_ONE + (ipi) - 1) / (ipi))
 /*---------------------------------------------------------------------------*/
 uint16_t lwb_sched_compress(uint8_t* compressed_data, uint8_t n_slots);
 /*---------------------------------------------------------------------------*/
@@ -104,11 +119,9 @@ static uint16_t          period;
 static uint32_t          time;               /* global time */
 static uint16_t          n_streams;          /* # streams */
 static lwb_sched_stats_t sched_stats = { 0 };
-static uint8_t           first_index;        /* offset for the stream list */
 static uint8_t           n_slots_assigned;   /* # assigned slots */
-static uint8_t           saturated = 0;
-static uint32_t          data_cnt;
-static uint16_t          data_ipi;
+static uint64_t          data_rate;          /* sum of 1 / IPI */
+static uint16_t          edf_rot;            /* tie-break rotation of a round */
 static volatile uint8_t  n_pending_sack = 0;
 /* factor of 4 because of the memory alignment and faster index calculation! */
 static uint8_t           pending_sack[4 * LWB_CONF_SCHED_SACK_BUFFER_SIZE]; 
@@ -118,6 +131,8 @@ static lwb_stream_list_t  *streams[LWB_CONF_MAX_DATA_SLOTS];
 LIST(streams_list);                  /* -> lists only work for data in RAM */
 /* data structures to hold the stream info */
 MEMB(streams_memb, lwb_stream_list_t, LWB_CONF_MAX_N_STREAMS);  
+/* min-heap of the streams (positions) with a due slot, by deadline */
+static uint16_t           edf_heap[LWB_CONF_MAX_N_STREAMS];
 /*---------------------------------------------------------------------------*/
 /**
  * @brief   remove a stream from the stream list on the host
@@ -182,6 +197,7 @@ lwb_sched_proc_srq(const lwb_stream_req_t* req)
         if(req->id == s->id && req->stream_id == s->stream_id) {
           /* already exists -> update the IPI */
           s->ipi = req->ipi;
+          s->rate = LWB_SCHED_RATE(req->ipi);
           s->last_assigned = last;
           s->n_cons_missed = 0;         /* reset this counter */
           DEBUG_PRINT_VERBOSE("stream request %u.%u processed (IPI updated)",
@@ -199,6 +215,7 @@ lwb_sched_proc_srq(const lwb_stream_req_t* req)
     }
     s->id       = req->id;
     s->ipi           = req->ipi;
+    s->rate          = LWB_SCHED_RATE(req->ipi);
     s->last_assigned = last;
     s->stream_id     = req->stream_id;
     s->n_cons_missed = 0;
@@ -231,51 +248,6 @@ add_sack:
   n_pending_sack++;
 }
 /*---------------------------------------------------------------------------*/
-/**
- * @brief implementation of the binary GCD algorithm
- * @param[in] u an unsigned integer
- * @param[in] v an unsigned integer
- * @return the greatest common divider of u and v
- */
-static inline uint16_t 
-gcd(uint16_t u, uint16_t v) 
-{
-  uint16_t shift;
-
-  /* GCD(0,x) := x */
-  if(u == 0 || v == 0) {
-    return u | v;
-  }
-
-  /* Let shift := lg K, where K is the greatest power of 2
-     dividing both u and v. */
-  for(shift = 0; ((u | v) & 1) == 0; ++shift) {
-    u >>= 1;
-    v >>= 1;
-  }
-  while((u & 1) == 0) {
-    u >>= 1;
-  }
-  /* From here on, u is always odd. */
-  do {
-    while((v & 1) == 0) {  /* Loop X */
-      v >>= 1;
-    }
-    /* Now u and v are both odd, so diff(u, v) is even.
-       Let u = min(u, v), v = diff(u, v)/2. */
-    if(u < v) {
-      v -= u;
-    } else {
-      uint16_t diff = u - v;
-      u = v;
-      v = diff;
-    }
-    v >>= 1;
-  } while(v != 0);
-
-  return u << shift;
-}
-/*---------------------------------------------------------------------------*/
 /**
  * @brief adapts the communication period T according to the traffic demand
  * @return the new period
@@ -288,26 +260,71 @@ lwb_sched_adapt_period(void)
      * seconds: set the period to a low value */
     return LWB_CONF_SCHED_PERIOD_MIN;
   }
-  if(!data_cnt) {
+  if(!data_rate) {
     return LWB_CONF_SCHED_PERIOD_IDLE;     /* no streams */
   }
-  saturated = 0;
-  uint16_t new_period = (uint16_t)(((uint32_t)data_ipi * 
-                                    LWB_CONF_MAX_DATA_SLOTS) / data_cnt);
-  /*new_period = (((uint32_t)data_ipi * LWB_CONF_MAX_DATA_SLOTS) / data_cnt) *
-   *             n_pkts / n_slots;*/
+  uint64_t new_period = ((uint64_t)LWB_CONF_MAX_DATA_SLOTS *
+                         LWB_SCHED_RATE_ONE) / data_rate;
   /* check for saturation */
   if(new_period < LWB_CONF_SCHED_PERIOD_MIN) {
     /* T_opt is smaller than LWB_CONF_SCHED_PERIOD_MIN */
     DEBUG_PRINT_WARNING("network saturated!");
-    saturated = 1;
     return LWB_CONF_SCHED_PERIOD_MIN;
   }
   /* limit the period */
   if(new_period > LWB_CONF_SCHED_PERIOD_MAX) {
     return LWB_CONF_SCHED_PERIOD_MAX;
   }
-  return new_period;
+  return (uint16_t)new_period;
+}
+/*---------------------------------------------------------------------------*/
+static inline uint32_t
+edf_deadline(uint16_t pos)
+{
+  return LWB_SCHED_STREAM_AT(pos)->last_assigned +
+         LWB_SCHED_STREAM_AT(pos)->ipi;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief compare two streams (positions) by deadline; ties are broken by the
+ * node ID (rotated by a random offset each round) and the stream ID
+ * @return 1 if stream a has to be served before stream b
+ */
+static inline uint8_t
+edf_before(uint16_t a, uint16_t b)
+{
+  const lwb_stream_list_t* sa = LWB_SCHED_STREAM_AT(a);
+  const lwb_stream_list_t* sb = LWB_SCHED_STREAM_AT(b);
+  uint32_t da = edf_deadline(a);
+  uint32_t db = edf_deadline(b);
+  if(da != db) {
+    return da < db;
+  }
+  if(sa->id != sb->id) {
+    return (uint16_t)(sa->id - edf_rot) < (uint16_t)(sb->id - edf_rot);
+  }
+  return sa->stream_id < sb->stream_id;
+}
+/*---------------------------------------------------------------------------*/
+static void
+edf_sift_down(uint16_t i, uint16_t size)
+{
+  uint16_t top = edf_heap[i];
+  while(1) {
+    uint16_t child = 2 * i + 1;
+    if(child >= size) {
+      break;
+    }
+    if((child + 1 < size) && edf_before(edf_heap[child + 1], edf_heap[child])) {
+      child++;
+    }
+    if(!edf_before(edf_heap[child], top)) {
+      break;
+    }
+    edf_heap[i] = edf_heap[child];
+    i = child;
+  }
+  edf_heap[i] = top;
 }
 /*---------------------------------------------------------------------------*/
 /**
@@ -344,11 +361,7 @@ lwb_sched_compute(lwb_schedule_t * const sched,
                   const uint8_t * const streams_to_update, 
                   uint8_t reserve_slot_host) 
 {
-  static uint16_t slots_tmp[LWB_CONF_MAX_DATA_SLOTS];
-
-  data_ipi = 1;
-  data_cnt = 0;
-  first_index = 0; 
+  data_rate = 0;
   n_slots_assigned = 0;
 
   /* loop through all the streams in the list */
@@ -372,11 +385,7 @@ lwb_sched_compute(lwb_schedule_t * const sched,
       curr_stream = curr_stream->next;
       lwb_sched_del_stream(stream_to_remove);
     } else {
-      uint16_t curr_gcd = gcd(data_ipi, curr_stream->ipi);
-      uint16_t k1 = curr_stream->ipi / curr_gcd;
-      uint16_t k2 = data_ipi / curr_gcd;
-      data_cnt = data_cnt * k1 + k2;
-      data_ipi = data_ipi * k1;
+      data_rate += curr_stream->rate;
       curr_stream = curr_stream->next;
     }
   }
@@ -396,69 +405,63 @@ lwb_sched_compute(lwb_schedule_t * const sched,
   if(n_streams == 0) {
     goto set_schedule;                              /* no streams to process */
   }
-  /* random initial position in the list */
-  uint16_t rand_init_pos = (random_rand() >> 1) % n_streams;
+  /* collect the streams with a due slot */
+  uint16_t heap_size = 0;
   uint16_t i;
-  
-  curr_stream = list_head(streams_list);
-  /* make curr_stream point to the random initial position */
-  for(i = 0; i < rand_init_pos; i++) {
-    curr_stream = curr_stream->next;
+  for(curr_stream = list_head(streams_list); curr_stream != NULL;
+      curr_stream = curr_stream->next) {
+    curr_stream->n_slots = 0;
+    if(time >= (curr_stream->ipi + curr_stream->last_assigned)) {
+      edf_heap[heap_size++] = LWB_SCHED_STREAM_POS(curr_stream);
+    }
   }
-  /* initial stream being processed */
-  lwb_stream_list_t *init_stream = curr_stream;
-  do {
-    /* assign slots for this stream, if possible */
-    if((n_slots_assigned < LWB_CONF_MAX_DATA_SLOTS) && 
-       (time >= (curr_stream->ipi + curr_stream->last_assigned))) {
-      /* the number of slots to assign to curr_stream */
-      uint16_t to_assign = (time - curr_stream->last_assigned) / 
-                           curr_stream->ipi;  /* elapsed time / period */
-      if(saturated) {
-        if((curr_stream->next == init_stream) || 
-           (curr_stream->next == NULL && rand_init_pos == 0)) {
-          /* last random stream: assign all possible slots */
-        } else {
-          /* ensure fairness among source nodes when the bandwidth saturates
-           * assigned a number of slots proportional to (1/IPI) */
-          uint16_t slots_ipi = period / curr_stream->ipi;
-          if(to_assign > slots_ipi) {
-            to_assign = slots_ipi;
-            if(to_assign == 0 && curr_stream == init_stream) {
-              /* first random stream: assign one slot to it, even if it has 
-               * very long IPI */
-              to_assign = 1;
-            }
-          }
-        }
-      }
-      if(to_assign > (LWB_CONF_MAX_DATA_SLOTS - n_slots_assigned)) {
-        to_assign = LWB_CONF_MAX_DATA_SLOTS - n_slots_assigned;
-      }
-      curr_stream->last_assigned += to_assign * curr_stream->ipi;
-      for(; to_assign > 0; to_assign--, n_slots_assigned++) {
-        slots_tmp[n_slots_assigned] = curr_stream->id;
-        streams[n_slots_assigned] = curr_stream;
-      }
+  edf_rot = random_rand();
+  for(i = heap_size / 2; i > 0; i--) {
+    edf_sift_down(i - 1, heap_size);
+  }
+  /* assign slots to the stream with the earliest deadline until it is no
+   * longer the earliest (or no longer due) */
+  i = n_slots_assigned;
+  while(heap_size && (i < LWB_CONF_MAX_DATA_SLOTS)) {
+    uint32_t next_deadline = 0xffffffff;
+    if(heap_size > 1) {
+      next_deadline = edf_deadline(edf_heap[1]);
+    }
+    if(heap_size > 2) {
+      next_deadline = MIN(next_deadline, edf_deadline(edf_heap[2]));
+    }
+    curr_stream = LWB_SCHED_STREAM_AT(edf_heap[0]);
+    do {
+      curr_stream->n_slots++;
+      curr_stream->last_assigned += curr_stream->ipi;
+      i++;
+    } while((i < LWB_CONF_MAX_DATA_SLOTS) &&
+            ((curr_stream->ipi + curr_stream->last_assigned) <
+             next_deadline) &&
+            (time >= (curr_stream->ipi + curr_stream->last_assigned)));
+    if(time < (curr_stream->ipi + curr_stream->last_assigned)) {
+      /* no more slots due for this stream */
+      edf_heap[0] = edf_heap[--heap_size];
+    }
+    if(heap_size) {
+      edf_sift_down(0, heap_size);
+    }
+  }
+  /* write the slots in the order of the node IDs */
+  for(curr_stream = list_head(streams_list); curr_stream != NULL;
+      curr_stream = curr_stream->next) {
+    if(curr_stream->n_slots) {
       /* set the last bit, we are expecting a packet from this stream in the
        * next round */
-      curr_stream->n_cons_missed |= 0x80; 
-    }
-    /* go to the next stream in the list */
-    curr_stream = curr_stream->next;
-    if(curr_stream == NULL) {
-      /* end of the list: start again from the head of the list */
-      curr_stream = list_head(streams_list);
-      first_index = n_slots_assigned; 
+      curr_stream->n_cons_missed |= 0x80;
+      for(i = 0; i < curr_stream->n_slots; i++) {
+        sched->slot[n_slots_assigned] = curr_stream->id;
+        streams[n_slots_assigned] = curr_stream;
+        n_slots_assigned++;
+      }
     }
-  } while(curr_stream != init_stream);
+  }
 
-  /* copy into new data structure to keep the node IDs ordered */
-  memcpy(&sched->slot[reserve_slot_host], &slots_tmp[first_index], 
-         (n_slots_assigned - first_index) * sizeof(sched->slot[0]));
-  memcpy(&sched->slot[n_slots_assigned - first_index + reserve_slot_host], 
-         slots_tmp, first_index * sizeof(sched->slot[0]));
-  
 set_schedule:
   sched->n_slots = n_slots_assigned;
 
@@ -496,8 +499,7 @@ lwb_sched_init(lwb_schedule_t* sched)
   memb_init(&streams_memb);
   list_init(streams_list);
 
-  data_ipi = 1;
-  data_cnt = 0;
+  data_rate = 0;
   n_streams = 0;
   n_slots_assigned = 0;
   n_pending_sack = 0;